@@ -0,0 +1,294 @@
+#include "analyzer.h"
+#include "formatter.h"
+#include "thread_count.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <thread>
+
+namespace Guitar {
+
+namespace {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+constexpr const char* HEATMAP_SHADES = " .:-=+*#%@";
+
+std::uint64_t mix64(std::uint64_t value) noexcept {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+std::uint32_t comboSeed(std::uint32_t base_seed, std::size_t combo) noexcept {
+    return static_cast<std::uint32_t>(mix64((static_cast<std::uint64_t>(base_seed) << 32) | combo));
+}
+
+double percent(long long part, long long whole) noexcept {
+    return whole > 0 ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+}
+
+std::string escapeJson(const std::string& text) {
+    std::string escaped;
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped += ' ';
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+template<typename Array>
+void writeJsonArray(std::ostream& out, const Array& values, std::size_t count) {
+    out << "[";
+    for (std::size_t i = 0; i < count; ++i) {
+        out << (i > 0 ? "," : "") << values[i];
+    }
+    out << "]";
+}
+
+// Counts one combo into `usage` and `combo`
+void analyzeCombo(const InstrumentConfig& instrument, const AnalysisSpec& spec, std::uint32_t seed,
+                  Music::ScaleManager& scale_mgr, UsageHistogram& usage, ComboStats& combo,
+                  std::vector<std::uint64_t>& hashes) {
+    scale_mgr.setKeyAndScale(combo.key, combo.scale);
+    const FretboardValidator validator(scale_mgr, instrument);
+    const std::uint16_t scale_mask = validator.getScaleMask();
+    const auto generator = makeNoteGenerator(validator, spec.profile, seed);
+
+    hashes.clear();
+    hashes.reserve(static_cast<std::size_t>(spec.exercises));
+    for (long long e = 0; e < spec.exercises; ++e) {
+        const auto notes = generator->generateTablature();
+        ++usage.exercises;
+        ++usage.anchor_fret[static_cast<std::size_t>(notes[0]->fret.value)];
+        ++usage.anchor_string[static_cast<std::size_t>(notes[0]->string_idx.value)];
+
+        std::uint64_t hash = 0;
+        for (std::size_t i = 0; i < notes.size(); ++i) {
+            const int string_idx = notes[i]->string_idx.value;
+            const int fret = notes[i]->fret.value;
+            ++usage.positions[static_cast<std::size_t>(string_idx)][static_cast<std::size_t>(fret)];
+            const int pitch_class = instrument.getPitch(string_idx, fret) % Music::SEMITONES_IN_OCTAVE;
+            if (((scale_mask >> pitch_class) & 1u) == 0) ++combo.out_of_scale;
+            hash = mix64(hash ^ static_cast<std::uint64_t>(string_idx << 8 | fret)) + i;
+
+            if (i == 0) continue;
+            const int distance = std::abs(fret - notes[i - 1]->fret.value);
+            const auto cls = static_cast<std::size_t>(classifyFretDistance(distance, spec.profile.position_box_radius));
+            ++usage.moves;
+            ++usage.fret_distance[static_cast<std::size_t>(distance)];
+            ++usage.distance_class[cls];
+            ++combo.distance_class[cls];
+            if (string_idx == notes[i - 1]->string_idx.value) ++usage.same_string_class[cls];
+        }
+        hashes.push_back(hash);
+    }
+
+    std::sort(hashes.begin(), hashes.end());
+    for (std::size_t i = 1; i < hashes.size(); ++i) {
+        if (hashes[i] == hashes[i - 1]) ++combo.duplicates;
+    }
+    combo.generator = generator->getStats();
+}
+
+} // namespace
+
+// ============================================================================
+// UsageHistogram Implementation
+// ============================================================================
+
+void UsageHistogram::merge(const UsageHistogram& other) noexcept {
+    for (std::size_t s = 0; s < positions.size(); ++s) {
+        for (std::size_t f = 0; f < positions[s].size(); ++f) positions[s][f] += other.positions[s][f];
+    }
+    for (std::size_t d = 0; d < fret_distance.size(); ++d) fret_distance[d] += other.fret_distance[d];
+    for (std::size_t c = 0; c < distance_class.size(); ++c) {
+        distance_class[c] += other.distance_class[c];
+        same_string_class[c] += other.same_string_class[c];
+    }
+    for (std::size_t f = 0; f < anchor_fret.size(); ++f) anchor_fret[f] += other.anchor_fret[f];
+    for (std::size_t s = 0; s < anchor_string.size(); ++s) anchor_string[s] += other.anchor_string[s];
+    exercises += other.exercises;
+    moves += other.moves;
+}
+
+// ============================================================================
+// Analysis
+// ============================================================================
+
+AnalysisReport runAnalysis(const AnalysisSpec& spec) {
+    const auto start = std::chrono::steady_clock::now();
+
+    AnalysisReport report;
+    report.usage.assign(spec.instruments.size(), UsageHistogram{});
+    for (std::size_t i = 0; i < spec.instruments.size(); ++i) {
+        for (const auto key : spec.keys) {
+            for (const auto& scale : spec.scales) {
+                ComboStats combo;
+                combo.instrument = i;
+                combo.key = key;
+                combo.scale = scale;
+                report.combos.push_back(std::move(combo));
+            }
+        }
+    }
+
+    const unsigned num_threads = resolveThreads(spec.num_threads, report.combos.size());
+    std::vector<std::vector<UsageHistogram>> thread_usage(num_threads, report.usage);
+    std::atomic<std::size_t> next_combo{0};
+
+    auto worker = [&](unsigned t) {
+        Music::ScaleManager scale_mgr;
+        std::vector<std::uint64_t> hashes;
+        for (std::size_t c = next_combo.fetch_add(1, std::memory_order_relaxed); c < report.combos.size();
+             c = next_combo.fetch_add(1, std::memory_order_relaxed)) {
+            ComboStats& combo = report.combos[c];
+            analyzeCombo(spec.instruments[combo.instrument], spec, comboSeed(spec.seed, c), scale_mgr,
+                         thread_usage[t][combo.instrument], combo, hashes);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    for (auto& thread : threads) thread.join();
+
+    for (const auto& usage : thread_usage) {
+        for (std::size_t i = 0; i < usage.size(); ++i) report.usage[i].merge(usage[i]);
+    }
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+std::array<double, NUM_DISTANCE_CLASSES> getIntendedDistanceShares(const GeneratorProfile& profile) {
+    const double total = profile.weight_close + profile.weight_medium + profile.weight_far;
+    if (total <= 0.0) return {0.0, 0.0, 0.0, 0.0};
+    return {100.0 * profile.weight_close / total, 100.0 * profile.weight_medium / total,
+            100.0 * profile.weight_far / total, 0.0};
+}
+
+// ============================================================================
+// Reports
+// ============================================================================
+
+void writeAnalysisCsv(std::ostream& out, const AnalysisReport& report, const AnalysisSpec& spec) {
+    out << "instrument,key,scale,exercises,first_note_fallback_pct,nearest_fallback_pct,ultimate_fallback_pct,"
+           "out_of_scale_notes,duplicate_pct,close_pct,medium_pct,far_pct,beyond_pct\n";
+    out << std::fixed << std::setprecision(4);
+    for (const auto& combo : report.combos) {
+        const long long moves = combo.generator.exercises * (NUM_NOTES - 1);
+        out << '"' << spec.instruments[combo.instrument].name << "\"," << Music::pitchClassToName(combo.key)
+            << ",\"" << combo.scale << "\"," << combo.generator.exercises << ","
+            << percent(combo.generator.first_note_fallbacks, combo.generator.exercises) << ","
+            << percent(combo.generator.nearest_fallbacks, moves) << ","
+            << percent(combo.generator.ultimate_fallbacks, moves) << "," << combo.out_of_scale << ","
+            << percent(combo.duplicates, combo.generator.exercises);
+        for (const auto count : combo.distance_class) out << "," << percent(count, moves);
+        out << "\n";
+    }
+}
+
+void writeAnalysisJson(std::ostream& out, const AnalysisReport& report, const AnalysisSpec& spec) {
+    const auto intended = getIntendedDistanceShares(spec.profile);
+
+    out << "{\n  \"profile\": \"" << describeProfile(spec.profile) << "\",\n"
+        << "  \"exercises_per_combo\": " << spec.exercises << ",\n"
+        << "  \"seed\": " << spec.seed << ",\n"
+        << "  \"seconds\": " << std::fixed << std::setprecision(3) << report.seconds << ",\n"
+        << "  \"distance_classes\": [\"close\", \"medium\", \"far\", \"beyond\"],\n"
+        << "  \"intended_distance_pct\": ";
+    writeJsonArray(out, intended, intended.size());
+    out << ",\n  \"instruments\": [\n";
+
+    for (std::size_t i = 0; i < spec.instruments.size(); ++i) {
+        const InstrumentConfig& instrument = spec.instruments[i];
+        const UsageHistogram& usage = report.usage[i];
+        const auto frets = static_cast<std::size_t>(instrument.num_frets) + 1;
+
+        out << "    {\n      \"name\": \"" << escapeJson(instrument.name) << "\",\n"
+            << "      \"exercises\": " << usage.exercises << ",\n"
+            << "      \"moves\": " << usage.moves << ",\n"
+            << "      \"positions\": [";
+        for (int s = 0; s < instrument.num_strings; ++s) {
+            out << (s > 0 ? ", " : "");
+            writeJsonArray(out, usage.positions[static_cast<std::size_t>(s)], frets);
+        }
+        out << "],\n      \"fret_distance\": ";
+        writeJsonArray(out, usage.fret_distance, frets);
+        out << ",\n      \"distance_class\": ";
+        writeJsonArray(out, usage.distance_class, usage.distance_class.size());
+        out << ",\n      \"same_string_class\": ";
+        writeJsonArray(out, usage.same_string_class, usage.same_string_class.size());
+        out << ",\n      \"anchor_fret\": ";
+        writeJsonArray(out, usage.anchor_fret, frets);
+        out << ",\n      \"anchor_string\": ";
+        writeJsonArray(out, usage.anchor_string, static_cast<std::size_t>(instrument.num_strings));
+        out << "\n    }" << (i + 1 < spec.instruments.size() ? "," : "") << "\n";
+    }
+
+    out << "  ],\n  \"combos\": [\n";
+    for (std::size_t c = 0; c < report.combos.size(); ++c) {
+        const ComboStats& combo = report.combos[c];
+        out << "    {\"instrument\": " << combo.instrument << ", \"key\": \"" << Music::pitchClassToName(combo.key)
+            << "\", \"scale\": \"" << escapeJson(combo.scale) << "\", \"exercises\": " << combo.generator.exercises
+            << ", \"first_note_fallbacks\": " << combo.generator.first_note_fallbacks
+            << ", \"nearest_fallbacks\": " << combo.generator.nearest_fallbacks
+            << ", \"ultimate_fallbacks\": " << combo.generator.ultimate_fallbacks
+            << ", \"out_of_scale\": " << combo.out_of_scale << ", \"duplicates\": " << combo.duplicates
+            << ", \"distance_class\": ";
+        writeJsonArray(out, combo.distance_class, combo.distance_class.size());
+        out << "}" << (c + 1 < report.combos.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+void printUsageHeatmap(std::ostream& out, const UsageHistogram& usage, const InstrumentConfig& instrument) {
+    const int frets = instrument.num_frets + 1;
+    long long peak = 1;
+    for (int s = 0; s < instrument.num_strings; ++s) {
+        for (int f = 0; f < frets; ++f) {
+            peak = std::max(peak, usage.positions[static_cast<std::size_t>(s)][static_cast<std::size_t>(f)]);
+        }
+    }
+
+    const auto label_width = static_cast<std::size_t>(Formatter::getLabelWidth(instrument));
+
+    // Fret numbers every 3 frets (as the inlays), one column per fret
+    std::string header(label_width + 1, ' ');
+    for (int f = 0; f < frets; f += 3) {
+        const std::string number = std::to_string(f);
+        header.resize(label_width + 1 + static_cast<std::size_t>(f), ' ');
+        header += number;
+    }
+    out << header << "\n";
+
+    const int levels = static_cast<int>(std::char_traits<char>::length(HEATMAP_SHADES)) - 1;
+    for (int s = 0; s < instrument.num_strings; ++s) {
+        std::string line = instrument.labels[s];
+        line.resize(label_width, ' ');
+        line += "|";
+        for (int f = 0; f < frets; ++f) {
+            const long long count = usage.positions[static_cast<std::size_t>(s)][static_cast<std::size_t>(f)];
+            // Any use shows at least the lightest shade
+            const int level = count == 0 ? 0 : std::max(1, static_cast<int>(count * levels / peak));
+            line += HEATMAP_SHADES[level];
+        }
+        out << line << "|\n";
+    }
+}
+
+} // namespace Guitar
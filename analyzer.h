@@ -0,0 +1,94 @@
+#ifndef ANALYZER_H
+#define ANALYZER_H
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "fretboard.h"
+#include "generator.h"
+#include "music_theory.h"
+
+namespace Guitar {
+
+// ============================================================================
+// Constants - Monte Carlo Analysis
+// ============================================================================
+
+constexpr long long DEFAULT_ANALYSIS_COUNT = 10000;  // Exercises per instrument/key/scale
+constexpr int NUM_DISTANCE_CLASSES = 4;              // DistanceClass order: close, medium, far, out of box
+
+// ============================================================================
+// Histograms
+// ============================================================================
+
+// Everything counted for one instrument (all keys and scales)
+struct UsageHistogram {
+    std::array<std::array<long long, MAX_SUPPORTED_FRET + 1>, MAX_STRINGS> positions{};  // Notes per string/fret
+    std::array<long long, MAX_SUPPORTED_FRET + 1> fret_distance{};    // Moves by fret distance
+    std::array<long long, NUM_DISTANCE_CLASSES> distance_class{};     // Moves by DistanceClass
+    std::array<long long, NUM_DISTANCE_CLASSES> same_string_class{};  // ...of them on the same string
+    std::array<long long, MAX_SUPPORTED_FRET + 1> anchor_fret{};      // First note (generateFirstNote)
+    std::array<long long, MAX_STRINGS> anchor_string{};
+    long long exercises = 0;
+    long long moves = 0;
+
+    void merge(const UsageHistogram& other) noexcept;
+};
+
+// One instrument/key/scale combination
+struct ComboStats {
+    std::size_t instrument = 0;     // Index into AnalysisSpec::instruments
+    Music::KeyIndex key = 0;
+    std::string scale;
+    GeneratorStats generator;       // Fallback counters of its generator
+    long long out_of_scale = 0;     // Notes outside the scale
+    long long duplicates = 0;       // Exercises identical to an earlier one of the combo
+    std::array<long long, NUM_DISTANCE_CLASSES> distance_class{};
+};
+
+// ============================================================================
+// Analysis
+// ============================================================================
+
+struct AnalysisSpec {
+    std::vector<InstrumentConfig> instruments;
+    GeneratorProfile profile = STANDARD_PROFILE;
+    std::vector<Music::KeyIndex> keys;
+    std::vector<std::string> scales;
+    long long exercises = DEFAULT_ANALYSIS_COUNT;  // Per combo
+    std::uint32_t seed = 1;
+    unsigned num_threads = 0;                       // 0 = every core
+};
+
+struct AnalysisReport {
+    std::vector<UsageHistogram> usage;  // One per instrument
+    std::vector<ComboStats> combos;     // Instrument, then key, then scale
+    double seconds = 0.0;
+};
+
+// Runs spec.exercises exercises through NoteGenerator::generateTablature
+// for every instrument/key/scale. Workers claim combos from an atomic
+// counter, count into their own histograms and write only the combo slots
+// they claimed; the per-thread histograms are summed after the join, so
+// nothing is shared while generating. Combo c draws from a seed derived
+// from (spec.seed, c), so the report does not depend on the thread count.
+[[nodiscard]] AnalysisReport runAnalysis(const AnalysisSpec& spec);
+
+// Share of the moves each distance class would get from the profile
+// weights alone (what the candidate filters distort)
+[[nodiscard]] std::array<double, NUM_DISTANCE_CLASSES> getIntendedDistanceShares(const GeneratorProfile& profile);
+
+// One row per combo (rates in percent)
+void writeAnalysisCsv(std::ostream& out, const AnalysisReport& report, const AnalysisSpec& spec);
+
+// Histograms per instrument plus the combo rows
+void writeAnalysisJson(std::ostream& out, const AnalysisReport& report, const AnalysisSpec& spec);
+
+// Notes per string/fret as shades, strings in tab order
+void printUsageHeatmap(std::ostream& out, const UsageHistogram& usage, const InstrumentConfig& instrument);
+
+} // namespace Guitar
+
+#endif // ANALYZER_H
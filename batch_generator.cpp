@@ -0,0 +1,579 @@
+#include "batch_generator.h"
+#include "music_theory.h"
+#include <algorithm>
+
+// The AVX2 / AVX-512 kernels use per-function target attributes, so they build
+// without -mavx* flags and are picked at runtime from the CPU features
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CRAZYFINGERS_BATCH_SIMD 1
+#include <immintrin.h>
+#else
+#define CRAZYFINGERS_BATCH_SIMD 0
+#endif
+
+namespace Guitar {
+
+namespace {
+
+// ============================================================================
+// Constants - Lane Layout
+// ============================================================================
+
+constexpr int MAX_LANES = 16;
+constexpr int MAX_BOX_WIDTH = 2 * MAX_PROFILE_BOX_RADIUS + 1;  // Frets a Position Box can span
+constexpr int MAX_SLOTS = MAX_STRINGS * MAX_BOX_WIDTH;           // (string, box offset) candidates
+constexpr int MAX_PITCH = NUM_MIDI_PITCHES - 1;
+constexpr int NO_STRING = -1;
+
+// ============================================================================
+// Lane Group - Structure-of-arrays state, one column per exercise
+// ============================================================================
+
+struct LaneGroup {
+    // Kernel inputs, refreshed before every step
+    alignas(64) std::int32_t prev_string[MAX_LANES];
+    alignas(64) std::int32_t prev_fret[MAX_LANES];
+    alignas(64) std::int32_t excluded_string[MAX_LANES];  // NO_STRING unless a change is forced
+    alignas(64) std::int32_t box_min[MAX_LANES];
+    alignas(64) std::int32_t box_max[MAX_LANES];
+    alignas(64) std::int32_t band_lo[MAX_LANES];          // Local AND global band
+    alignas(64) std::int32_t band_hi[MAX_LANES];
+    alignas(64) std::int32_t scale_mask[MAX_LANES];
+    alignas(64) std::uint32_t rng[MAX_LANES];
+
+    // Kernel outputs
+    alignas(64) std::int32_t cumulative[MAX_SLOTS][MAX_LANES];  // Running weight per slot
+    alignas(64) std::int32_t total[MAX_LANES];
+    alignas(64) std::int32_t count[MAX_LANES];                  // Allowed slots (weight may be 0)
+    alignas(64) std::int32_t pick[MAX_LANES];                   // Slot drawn when total > 0
+
+    // Per-lane bookkeeping (scalar)
+    std::int32_t pitches[NUM_NOTES][MAX_LANES];
+    std::int32_t run[MAX_LANES];                  // Consecutive notes on the same string
+    std::int32_t global_min[MAX_LANES];
+    std::int32_t global_max[MAX_LANES];
+};
+
+// Constants of one batch: open pitch (capo included) per string, so that
+// pitch = base + fret capped at 127, and the profile's rules
+struct StepTable {
+    std::int32_t base[MAX_STRINGS];
+    int num_strings;
+    int box_width;     // 2 * position_box_radius + 1
+    int num_slots;     // num_strings * box_width
+    GeneratorProfile rules;
+};
+
+using StepKernel = void (*)(LaneGroup&, const StepTable&, int lanes);
+
+// ============================================================================
+// Random Stream Helpers - Identical in every backend
+// ============================================================================
+
+constexpr std::uint32_t xorshift32(std::uint32_t x) noexcept {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+// floor(x * range / 2^32) split in 16-bit halves so it stays in 32-bit lanes
+constexpr std::int32_t scaleToRange(std::uint32_t x, std::int32_t range) noexcept {
+    const auto r = static_cast<std::uint32_t>(range);
+    return static_cast<std::int32_t>(((x >> 16) * r + (((x & 0xFFFFu) * r) >> 16)) >> 16);
+}
+
+std::int32_t drawBelow(std::uint32_t& state, std::int32_t range) noexcept {
+    state = xorshift32(state);
+    return scaleToRange(state, range);
+}
+
+constexpr std::uint32_t laneSeed(std::uint32_t seed, std::uint32_t exercise) noexcept {
+    std::uint32_t x = seed * 0x9E3779B9u + exercise * 0x85EBCA6Bu + 0x6A09E667u;
+    x = (x ^ (x >> 16)) * 0x7FEB352Du;
+    x = (x ^ (x >> 15)) * 0x846CA68Bu;
+    x ^= x >> 16;
+    return x != 0 ? x : 0x1234567u;  // xorshift must not start at 0
+}
+
+// ============================================================================
+// Scalar Reference - Same rules as LayoutNoteGenerator::buildCandidates
+// ============================================================================
+
+// Pitch class without a division: exact for every MIDI pitch
+constexpr std::int32_t pitchClassOf(std::int32_t pitch) noexcept {
+    return pitch - ((pitch * 171) >> 11) * Music::SEMITONES_IN_OCTAVE;
+}
+
+constexpr std::int32_t slotPitch(const StepTable& table, int str, int fret) noexcept {
+    return std::min(table.base[str] + fret, MAX_PITCH);
+}
+
+// Scale & Position Box & pitch bands (what findClosestPitchNote keeps)
+bool isInsideBands(const LaneGroup& g, const StepTable& table, int lane, int str, int fret) noexcept {
+    if (fret < g.box_min[lane] || fret > g.box_max[lane]) return false;
+    const std::int32_t pitch = slotPitch(table, str, fret);
+    return ((g.scale_mask[lane] >> pitchClassOf(pitch)) & 1) != 0 &&
+           pitch >= g.band_lo[lane] && pitch <= g.band_hi[lane];
+}
+
+// Candidate weight, or -1 when the position is not a candidate
+std::int32_t candidateWeight(const LaneGroup& g, const StepTable& table, int lane, int str, int fret) noexcept {
+    if (!isInsideBands(g, table, lane, str, fret)) return -1;
+
+    const bool same_string = (str == g.prev_string[lane]);
+    if (str == g.excluded_string[lane]) return -1;
+    if (same_string && fret == g.prev_fret[lane]) return -1;
+
+    return table.rules.weightFor(fret - g.prev_fret[lane], same_string);
+}
+
+void stepLanesScalar(LaneGroup& g, const StepTable& table, int lanes) {
+    for (int lane = 0; lane < lanes; ++lane) {
+        std::int32_t cumulative = 0;
+        std::int32_t count = 0;
+        int slot = 0;
+        for (int str = 0; str < table.num_strings; ++str) {
+            for (int offset = 0; offset < table.box_width; ++offset, ++slot) {
+                const std::int32_t weight = candidateWeight(g, table, lane, str, g.box_min[lane] + offset);
+                if (weight >= 0) {
+                    cumulative += weight;
+                    ++count;
+                }
+                g.cumulative[slot][lane] = cumulative;
+            }
+        }
+        g.total[lane] = cumulative;
+        g.count[lane] = count;
+
+        const std::int32_t target = drawBelow(g.rng[lane], cumulative);
+        int pick = 0;
+        while (pick < table.num_slots && g.cumulative[pick][lane] <= target) ++pick;
+        g.pick[lane] = pick;
+    }
+}
+
+// ============================================================================
+// SIMD Kernels - The scalar reference, all lanes per instruction
+// ============================================================================
+
+#if CRAZYFINGERS_BATCH_SIMD
+
+[[gnu::target("avx2")]]
+void stepLanesAvx2(LaneGroup& g, const StepTable& table, int /* lanes */) {
+    const __m256i prev_string = _mm256_load_si256(reinterpret_cast<const __m256i*>(g.prev_string));
+    const __m256i prev_fret = _mm256_load_si256(reinterpret_cast<const __m256i*>(g.prev_fret));
+    const __m256i excluded = _mm256_load_si256(reinterpret_cast<const __m256i*>(g.excluded_string));
+    const __m256i box_min = _mm256_load_si256(reinterpret_cast<const __m256i*>(g.box_min));
+    const __m256i box_max = _mm256_load_si256(reinterpret_cast<const __m256i*>(g.box_max));
+    const __m256i lo = _mm256_load_si256(reinterpret_cast<const __m256i*>(g.band_lo));
+    const __m256i hi = _mm256_load_si256(reinterpret_cast<const __m256i*>(g.band_hi));
+    const __m256i scale_mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(g.scale_mask));
+
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i max_pitch = _mm256_set1_epi32(MAX_PITCH);
+    const __m256i two = _mm256_set1_epi32(2);
+    const __m256i three = _mm256_set1_epi32(3);
+    const __m256i reach = _mm256_set1_epi32(farReach(table.rules.position_box_radius));
+
+    __m256i cumulative = _mm256_setzero_si256();
+    __m256i count = _mm256_setzero_si256();
+    int slot = 0;
+    for (int str = 0; str < table.num_strings; ++str) {
+        const __m256i string_index = _mm256_set1_epi32(str);
+        const __m256i base = _mm256_set1_epi32(table.base[str]);
+        const __m256i same_string = _mm256_cmpeq_epi32(prev_string, string_index);
+        const __m256i is_excluded = _mm256_cmpeq_epi32(excluded, string_index);
+
+        // Same-string bonus folded into the weight table of this string
+        const __m256i close = _mm256_blendv_epi8(_mm256_set1_epi32(table.rules.weightFor(0, false)),
+                                                 _mm256_set1_epi32(table.rules.weightFor(0, true)), same_string);
+        const __m256i medium = _mm256_blendv_epi8(_mm256_set1_epi32(table.rules.weightFor(3, false)),
+                                                  _mm256_set1_epi32(table.rules.weightFor(3, true)), same_string);
+        const __m256i far = _mm256_blendv_epi8(_mm256_set1_epi32(table.rules.weightFor(4, false)),
+                                               _mm256_set1_epi32(table.rules.weightFor(4, true)), same_string);
+
+        for (int offset = 0; offset < table.box_width; ++offset, ++slot) {
+            const __m256i fret = _mm256_add_epi32(box_min, _mm256_set1_epi32(offset));
+            const __m256i pitch = _mm256_min_epi32(_mm256_add_epi32(fret, base), max_pitch);
+
+            // 12-bit scale mask indexed per lane by pitch class
+            const __m256i octave = _mm256_srli_epi32(_mm256_mullo_epi32(pitch, _mm256_set1_epi32(171)), 11);
+            const __m256i pitch_class = _mm256_sub_epi32(pitch,
+                _mm256_mullo_epi32(octave, _mm256_set1_epi32(Music::SEMITONES_IN_OCTAVE)));
+            const __m256i in_scale = _mm256_cmpeq_epi32(
+                _mm256_and_si256(_mm256_srlv_epi32(scale_mask, pitch_class), one), one);
+
+            // AVX2 only compares for > and ==: collect every reason to reject
+            __m256i rejected = _mm256_cmpgt_epi32(fret, box_max);
+            rejected = _mm256_or_si256(rejected, _mm256_cmpgt_epi32(lo, pitch));
+            rejected = _mm256_or_si256(rejected, _mm256_cmpgt_epi32(pitch, hi));
+            rejected = _mm256_or_si256(rejected, is_excluded);
+            rejected = _mm256_or_si256(rejected, _mm256_and_si256(same_string, _mm256_cmpeq_epi32(fret, prev_fret)));
+            const __m256i allowed = _mm256_andnot_si256(rejected, in_scale);
+
+            const __m256i distance = _mm256_abs_epi32(_mm256_sub_epi32(fret, prev_fret));
+            __m256i weight = _mm256_andnot_si256(_mm256_cmpgt_epi32(distance, two), close);
+            weight = _mm256_or_si256(weight, _mm256_and_si256(_mm256_cmpeq_epi32(distance, three), medium));
+            const __m256i is_far = _mm256_andnot_si256(_mm256_cmpgt_epi32(distance, reach),
+                                                       _mm256_cmpgt_epi32(distance, three));
+            weight = _mm256_or_si256(weight, _mm256_and_si256(is_far, far));
+
+            cumulative = _mm256_add_epi32(cumulative, _mm256_and_si256(weight, allowed));
+            count = _mm256_sub_epi32(count, allowed);  // allowed lanes are -1
+            _mm256_store_si256(reinterpret_cast<__m256i*>(g.cumulative[slot]), cumulative);
+        }
+    }
+    _mm256_store_si256(reinterpret_cast<__m256i*>(g.total), cumulative);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(g.count), count);
+
+    // Vectorized xorshift32 + range reduction (scaleToRange)
+    __m256i state = _mm256_load_si256(reinterpret_cast<const __m256i*>(g.rng));
+    state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 13));
+    state = _mm256_xor_si256(state, _mm256_srli_epi32(state, 17));
+    state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 5));
+    _mm256_store_si256(reinterpret_cast<__m256i*>(g.rng), state);
+
+    const __m256i high = _mm256_mullo_epi32(_mm256_srli_epi32(state, 16), cumulative);
+    const __m256i low = _mm256_mullo_epi32(_mm256_and_si256(state, _mm256_set1_epi32(0xFFFF)), cumulative);
+    const __m256i target = _mm256_srli_epi32(_mm256_add_epi32(high, _mm256_srli_epi32(low, 16)), 16);
+
+    // Cumulative weights are non-decreasing: the drawn slot is the number
+    // of slots whose running total is still <= target
+    __m256i pick = _mm256_set1_epi32(table.num_slots);
+    for (int s = 0; s < table.num_slots; ++s) {
+        const __m256i running = _mm256_load_si256(reinterpret_cast<const __m256i*>(g.cumulative[s]));
+        pick = _mm256_add_epi32(pick, _mm256_cmpgt_epi32(running, target));
+    }
+    _mm256_store_si256(reinterpret_cast<__m256i*>(g.pick), pick);
+}
+
+// GCC 12's AVX-512 headers self-initialize their "undefined" vectors, which
+// trips the uninitialized warnings on every intrinsic
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#if !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+[[gnu::target("avx512f")]]
+void stepLanesAvx512(LaneGroup& g, const StepTable& table, int /* lanes */) {
+    const __m512i prev_string = _mm512_load_si512(g.prev_string);
+    const __m512i prev_fret = _mm512_load_si512(g.prev_fret);
+    const __m512i excluded = _mm512_load_si512(g.excluded_string);
+    const __m512i box_min = _mm512_load_si512(g.box_min);
+    const __m512i box_max = _mm512_load_si512(g.box_max);
+    const __m512i lo = _mm512_load_si512(g.band_lo);
+    const __m512i hi = _mm512_load_si512(g.band_hi);
+    const __m512i scale_mask = _mm512_load_si512(g.scale_mask);
+
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i max_pitch = _mm512_set1_epi32(MAX_PITCH);
+    const __m512i two = _mm512_set1_epi32(2);
+    const __m512i three = _mm512_set1_epi32(3);
+    const __m512i reach = _mm512_set1_epi32(farReach(table.rules.position_box_radius));
+
+    __m512i cumulative = _mm512_setzero_si512();
+    __m512i count = _mm512_setzero_si512();
+    int slot = 0;
+    for (int str = 0; str < table.num_strings; ++str) {
+        const __m512i string_index = _mm512_set1_epi32(str);
+        const __m512i base = _mm512_set1_epi32(table.base[str]);
+        const __mmask16 same_string = _mm512_cmpeq_epi32_mask(prev_string, string_index);
+        const __mmask16 string_ok = _mm512_cmpneq_epi32_mask(excluded, string_index);
+
+        // Same-string bonus folded into the weight table of this string
+        const __m512i close = _mm512_mask_mov_epi32(_mm512_set1_epi32(table.rules.weightFor(0, false)),
+                                                    same_string, _mm512_set1_epi32(table.rules.weightFor(0, true)));
+        const __m512i medium = _mm512_mask_mov_epi32(_mm512_set1_epi32(table.rules.weightFor(3, false)),
+                                                     same_string, _mm512_set1_epi32(table.rules.weightFor(3, true)));
+        const __m512i far = _mm512_mask_mov_epi32(_mm512_set1_epi32(table.rules.weightFor(4, false)),
+                                                  same_string, _mm512_set1_epi32(table.rules.weightFor(4, true)));
+
+        for (int offset = 0; offset < table.box_width; ++offset, ++slot) {
+            const __m512i fret = _mm512_add_epi32(box_min, _mm512_set1_epi32(offset));
+            const __m512i pitch = _mm512_min_epi32(_mm512_add_epi32(fret, base), max_pitch);
+
+            // 12-bit scale mask indexed per lane by pitch class
+            const __m512i octave = _mm512_srli_epi32(_mm512_mullo_epi32(pitch, _mm512_set1_epi32(171)), 11);
+            const __m512i pitch_class = _mm512_sub_epi32(pitch,
+                _mm512_mullo_epi32(octave, _mm512_set1_epi32(Music::SEMITONES_IN_OCTAVE)));
+            const __mmask16 in_scale = _mm512_test_epi32_mask(_mm512_srlv_epi32(scale_mask, pitch_class), one);
+
+            const __mmask16 allowed = in_scale & string_ok &
+                _mm512_cmple_epi32_mask(fret, box_max) &
+                _mm512_cmpge_epi32_mask(pitch, lo) &
+                _mm512_cmple_epi32_mask(pitch, hi) &
+                static_cast<__mmask16>(~(same_string & _mm512_cmpeq_epi32_mask(fret, prev_fret)));
+
+            const __m512i distance = _mm512_abs_epi32(_mm512_sub_epi32(fret, prev_fret));
+            __m512i weight = _mm512_maskz_mov_epi32(_mm512_cmple_epi32_mask(distance, two), close);
+            weight = _mm512_mask_mov_epi32(weight, _mm512_cmpeq_epi32_mask(distance, three), medium);
+            weight = _mm512_mask_mov_epi32(weight, _mm512_cmpgt_epi32_mask(distance, three) &
+                                                   _mm512_cmple_epi32_mask(distance, reach), far);
+
+            cumulative = _mm512_mask_add_epi32(cumulative, allowed, cumulative, weight);
+            count = _mm512_mask_add_epi32(count, allowed, count, one);
+            _mm512_store_si512(g.cumulative[slot], cumulative);
+        }
+    }
+    _mm512_store_si512(g.total, cumulative);
+    _mm512_store_si512(g.count, count);
+
+    // Vectorized xorshift32 + range reduction (scaleToRange)
+    __m512i state = _mm512_load_si512(g.rng);
+    state = _mm512_xor_si512(state, _mm512_slli_epi32(state, 13));
+    state = _mm512_xor_si512(state, _mm512_srli_epi32(state, 17));
+    state = _mm512_xor_si512(state, _mm512_slli_epi32(state, 5));
+    _mm512_store_si512(g.rng, state);
+
+    const __m512i high = _mm512_mullo_epi32(_mm512_srli_epi32(state, 16), cumulative);
+    const __m512i low = _mm512_mullo_epi32(_mm512_and_si512(state, _mm512_set1_epi32(0xFFFF)), cumulative);
+    const __m512i target = _mm512_srli_epi32(_mm512_add_epi32(high, _mm512_srli_epi32(low, 16)), 16);
+
+    // Cumulative weights are non-decreasing: the drawn slot is the number
+    // of slots whose running total is still <= target
+    __m512i pick = _mm512_setzero_si512();
+    for (int s = 0; s < table.num_slots; ++s) {
+        const __m512i running = _mm512_load_si512(g.cumulative[s]);
+        pick = _mm512_mask_add_epi32(pick, _mm512_cmple_epi32_mask(running, target), pick, one);
+    }
+    _mm512_store_si512(g.pick, pick);
+}
+
+#pragma GCC diagnostic pop
+
+#endif // CRAZYFINGERS_BATCH_SIMD
+
+StepKernel getKernel(BatchBackend backend) noexcept {
+#if CRAZYFINGERS_BATCH_SIMD
+    if (backend == BatchBackend::Avx512) return stepLanesAvx512;
+    if (backend == BatchBackend::Avx2) return stepLanesAvx2;
+#else
+    (void)backend;
+#endif
+    return stepLanesScalar;
+}
+
+// ============================================================================
+// Lane Bookkeeping - First note, bands and fallbacks (scalar, per lane)
+// ============================================================================
+
+void startLane(LaneGroup& g, const InstrumentConfig& instrument, const GeneratorProfile& rules,
+               int lane, Note& first) {
+    const int num_strings = instrument.num_strings;
+    const std::uint32_t scale = static_cast<std::uint32_t>(g.scale_mask[lane]);
+    auto inScale = [&](int str, int fret) {
+        return ((scale >> (instrument.getPitch(str, fret) % Music::SEMITONES_IN_OCTAVE)) & 1u) != 0;
+    };
+
+    // Same start as generateFirstNote: middle strings, frets 5-12, 50 retries
+    int str = 1 + drawBelow(g.rng[lane], num_strings - 2);
+    int fret = 5 + drawBelow(g.rng[lane], 8);
+    for (int attempts = 0; !inScale(str, fret) && attempts < 50; ++attempts) {
+        str = 1 + drawBelow(g.rng[lane], num_strings - 2);
+        fret = 5 + drawBelow(g.rng[lane], 8);
+    }
+
+    // Fallback: any in-scale position on the neck
+    if (!inScale(str, fret)) {
+        std::int32_t valid = 0;
+        for (int s = 0; s < num_strings; ++s) {
+            for (int f = MIN_FRET; f <= instrument.getMaxFret(); ++f) valid += inScale(s, f) ? 1 : 0;
+        }
+        if (valid > 0) {
+            std::int32_t chosen = drawBelow(g.rng[lane], valid);
+            for (int s = 0; s < num_strings && chosen >= 0; ++s) {
+                for (int f = MIN_FRET; f <= instrument.getMaxFret() && chosen >= 0; ++f) {
+                    if (inScale(s, f) && chosen-- == 0) {
+                        str = s;
+                        fret = f;
+                    }
+                }
+            }
+        }
+    }
+
+    PositionBox box{};
+    box.initialize(fret, instrument.getMaxFret(), rules.position_box_radius);
+    g.box_min[lane] = box.min_fret;
+    g.box_max[lane] = box.max_fret;
+
+    const int pitch = instrument.getPitch(str, fret);
+    g.pitches[0][lane] = pitch;
+    g.global_min[lane] = pitch;
+    g.global_max[lane] = pitch;
+    g.run[lane] = 0;
+    g.prev_string[lane] = str;
+    g.prev_fret[lane] = fret;
+    first = Note{{str, num_strings}, {fret}};
+}
+
+// Kernel inputs for note `index` (getAllowedPitchBand, merged into one band)
+void prepareLane(LaneGroup& g, const GeneratorProfile& rules, int lane, int index) {
+    int window_min = g.pitches[index - 1][lane];
+    int window_max = window_min;
+    for (int i = std::max(0, index - rules.local_window_size); i < index; ++i) {
+        window_min = std::min(window_min, g.pitches[i][lane]);
+        window_max = std::max(window_max, g.pitches[i][lane]);
+    }
+    g.band_lo[lane] = std::max(window_max - rules.max_local_range, g.global_max[lane] - rules.max_global_range);
+    g.band_hi[lane] = std::min(window_min + rules.max_local_range, g.global_min[lane] + rules.max_global_range);
+    g.excluded_string[lane] = (g.run[lane] >= rules.max_consecutive_same_string) ? g.prev_string[lane] : NO_STRING;
+}
+
+// Turns the kernel result into the next note, applying the generator's
+// fallbacks for lanes the weighted draw cannot serve
+Note resolveLane(LaneGroup& g, const StepTable& table, const FretboardPitchIndex& pitch_index, int lane) {
+    const int num_strings = table.num_strings;
+    const int prev_string = g.prev_string[lane];
+    const int prev_fret = g.prev_fret[lane];
+
+    int slot = -1;
+    if (g.total[lane] > 0) {
+        slot = g.pick[lane];
+    } else if (g.count[lane] > 0) {
+        // Only zero-weight candidates: selectWeighted draws uniformly
+        std::int32_t chosen = drawBelow(g.rng[lane], g.count[lane]);
+        for (int s = 0; s < table.num_slots; ++s) {
+            if (candidateWeight(g, table, lane, s / table.box_width, g.box_min[lane] + s % table.box_width) >= 0 &&
+                chosen-- == 0) {
+                slot = s;
+                break;
+            }
+        }
+    }
+    if (slot >= 0) {
+        return Note{{slot / table.box_width, num_strings}, {g.box_min[lane] + slot % table.box_width}};
+    }
+
+    // findClosestPitchNote: closest in-band pitch, first in (string, fret) order
+    const auto nearest = pitch_index.findNearestIf(
+        slotPitch(table, prev_string, prev_fret), g.band_lo[lane], g.band_hi[lane],
+        [&](int str, int fret) { return isInsideBands(g, table, lane, str, fret); });
+    if (nearest) return Note{{nearest->string_idx, num_strings}, {nearest->fret}};
+
+    // Ultimate fallback: adjacent string, same fret
+    int str = (prev_string < num_strings / 2) ? prev_string + 1 : prev_string - 1;
+    str = std::clamp(str, 0, num_strings - 1);
+    return Note{{str, num_strings}, {prev_fret}};
+}
+
+void advanceLane(LaneGroup& g, const InstrumentConfig& instrument, int lane, int index, const Note& note) {
+    const int pitch = instrument.getPitch(note.string_idx.value, note.fret.value);
+    g.pitches[index][lane] = pitch;
+    g.global_min[lane] = std::min(g.global_min[lane], pitch);
+    g.global_max[lane] = std::max(g.global_max[lane], pitch);
+    g.run[lane] = (note.string_idx.value == g.prev_string[lane]) ? g.run[lane] + 1 : 0;
+    g.prev_string[lane] = note.string_idx.value;
+    g.prev_fret[lane] = note.fret.value;
+}
+
+} // namespace
+
+// ============================================================================
+// Backend Queries
+// ============================================================================
+
+bool isBatchBackendSupported(BatchBackend backend) noexcept {
+    switch (backend) {
+        case BatchBackend::Scalar:
+            return true;
+#if CRAZYFINGERS_BATCH_SIMD
+        case BatchBackend::Avx2:
+            return __builtin_cpu_supports("avx2");
+        case BatchBackend::Avx512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+    }
+}
+
+BatchBackend detectBatchBackend() noexcept {
+    if (isBatchBackendSupported(BatchBackend::Avx512)) return BatchBackend::Avx512;
+    if (isBatchBackendSupported(BatchBackend::Avx2)) return BatchBackend::Avx2;
+    return BatchBackend::Scalar;
+}
+
+int getBatchLaneCount(BatchBackend backend) noexcept {
+    switch (backend) {
+        case BatchBackend::Avx512: return 16;
+        case BatchBackend::Avx2:   return 8;
+        default:                   return 8;  // Scalar keeps the lane state warm in cache
+    }
+}
+
+const char* getBatchBackendName(BatchBackend backend) noexcept {
+    switch (backend) {
+        case BatchBackend::Avx512: return "AVX-512";
+        case BatchBackend::Avx2:   return "AVX2";
+        default:                   return "Escalar";
+    }
+}
+
+// ============================================================================
+// BatchGenerator Implementation
+// ============================================================================
+
+BatchGenerator::BatchGenerator(const InstrumentConfig& instrument, const GeneratorProfile& profile)
+    : BatchGenerator(instrument, profile, detectBatchBackend()) {}
+
+BatchGenerator::BatchGenerator(const InstrumentConfig& instrument, const GeneratorProfile& profile,
+                               BatchBackend backend)
+    : instrument_{instrument}
+    , profile_{profile}
+    , backend_{isBatchBackendSupported(backend) ? backend : BatchBackend::Scalar}
+    , pitch_index_{instrument_} {}
+
+void BatchGenerator::generate(const std::vector<std::uint16_t>& scale_masks, std::uint32_t seed,
+                              std::vector<Note>& out) const {
+    if (scale_masks.empty()) return;
+
+    StepTable table{};
+    table.num_strings = instrument_.num_strings;
+    table.box_width = 2 * profile_.position_box_radius + 1;
+    table.num_slots = instrument_.num_strings * table.box_width;
+    table.rules = profile_;
+    for (int s = 0; s < instrument_.num_strings; ++s) {
+        table.base[s] = instrument_.open_midi[s] + instrument_.capo;
+    }
+
+    const StepKernel kernel = getKernel(backend_);
+    const int lanes = getBatchLaneCount(backend_);
+    const std::size_t total = scale_masks.size();
+    const std::size_t first_out = out.size();
+    out.resize(first_out + total * NUM_NOTES);
+
+    LaneGroup group;
+    for (std::size_t first = 0; first < total; first += lanes) {
+        const int active = static_cast<int>(std::min<std::size_t>(lanes, total - first));
+
+        // Idle lanes of the last group replay exercise `first`; their notes are dropped
+        Note scratch[NUM_NOTES];
+        auto notesOf = [&](int lane) {
+            return lane < active ? &out[first_out + (first + lane) * NUM_NOTES] : scratch;
+        };
+
+        for (int lane = 0; lane < lanes; ++lane) {
+            const std::size_t exercise = first + (lane < active ? lane : 0);
+            group.scale_mask[lane] = scale_masks[exercise];
+            group.rng[lane] = laneSeed(seed, static_cast<std::uint32_t>(exercise));
+            startLane(group, instrument_, profile_, lane, notesOf(lane)[0]);
+        }
+
+        for (int index = 1; index < NUM_NOTES; ++index) {
+            for (int lane = 0; lane < lanes; ++lane) prepareLane(group, profile_, lane, index);
+
+            kernel(group, table, lanes);
+
+            for (int lane = 0; lane < lanes; ++lane) {
+                const Note note = resolveLane(group, table, pitch_index_, lane);
+                notesOf(lane)[index] = note;
+                advanceLane(group, instrument_, lane, index, note);
+            }
+        }
+    }
+}
+
+} // namespace Guitar
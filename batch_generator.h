@@ -0,0 +1,62 @@
+#ifndef BATCH_GENERATOR_H
+#define BATCH_GENERATOR_H
+
+#include <cstdint>
+#include <vector>
+#include "generator.h"
+
+namespace Guitar {
+
+// ============================================================================
+// Batch Backends - One exercise per SIMD lane
+// ============================================================================
+
+enum class BatchBackend {
+    Scalar,   // Portable loop over the lanes (any compiler / CPU)
+    Avx2,     // 8 lanes of 32 bits
+    Avx512    // 16 lanes of 32 bits
+};
+
+// Best backend supported by this build and CPU (checked at runtime)
+[[nodiscard]] BatchBackend detectBatchBackend() noexcept;
+[[nodiscard]] bool isBatchBackendSupported(BatchBackend backend) noexcept;
+[[nodiscard]] int getBatchLaneCount(BatchBackend backend) noexcept;
+[[nodiscard]] const char* getBatchBackendName(BatchBackend backend) noexcept;
+
+// ============================================================================
+// Batch Generator - Many exercises advanced in lockstep
+// ============================================================================
+
+// Bulk counterpart of NoteGenerator::generateTablature for corpus building.
+// Every lane runs the profile-only constraints of buildCandidates (scale,
+// Position Box, local/global pitch bands, no repeated note, forced string
+// change) with the profile's weights and the same fallbacks. The loaded
+// WeightTable, TransitionModel and RuleSet are not applied, and the random
+// stream differs (per-lane xorshift32 instead of mt19937).
+class BatchGenerator {
+public:
+    explicit BatchGenerator(const InstrumentConfig& instrument,
+                            const GeneratorProfile& profile = STANDARD_PROFILE);
+    BatchGenerator(const InstrumentConfig& instrument, const GeneratorProfile& profile,
+                   BatchBackend backend);  // Unsupported -> Scalar
+
+    // One exercise per scale mask, NUM_NOTES notes each, appended to `out`
+    // in exercise order. Exercise i draws from a stream derived from
+    // (seed, i), so the output does not depend on the backend or lane count.
+    void generate(const std::vector<std::uint16_t>& scale_masks, std::uint32_t seed,
+                  std::vector<Note>& out) const;
+
+    [[nodiscard]] BatchBackend getBackend() const noexcept { return backend_; }
+    [[nodiscard]] const InstrumentConfig& getInstrument() const noexcept { return instrument_; }
+    [[nodiscard]] const GeneratorProfile& getProfile() const noexcept { return profile_; }
+
+private:
+    InstrumentConfig instrument_;
+    GeneratorProfile profile_;  // Rules read at runtime (kernels broadcast them once per step)
+    BatchBackend backend_;
+    FretboardPitchIndex pitch_index_;  // Closest-pitch fallback
+};
+
+} // namespace Guitar
+
+#endif // BATCH_GENERATOR_H
@@ -0,0 +1,239 @@
+#include "calibrator.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <tuple>
+#include <vector>
+
+namespace Guitar {
+
+namespace {
+
+// ============================================================================
+// Constants - Nelder-Mead
+// ============================================================================
+
+constexpr double SIMPLEX_STEP = 0.5;      // Log-ratio step of the starting simplex
+constexpr double BONUS_STEP = 0.4;        // Same-string bonus step (1.0 = 100%)
+constexpr double MAX_LOG_RATIO = 7.0;     // Beyond this a weight rounds to 0 anyway
+constexpr double REFLECTION = 1.0;
+constexpr double EXPANSION = 2.0;
+constexpr double CONTRACTION = 0.5;
+constexpr double SHRINK = 0.5;
+
+struct Evaluation {
+    ScaleWeights weights;
+    std::array<double, NUM_DISTANCE_CLASSES> realized;
+    double same_string;
+    double error;
+};
+
+struct Vertex {
+    std::vector<double> x;
+    double error;
+};
+
+// ============================================================================
+// Objective - simulated distance shares against the target
+// ============================================================================
+
+class Objective {
+public:
+    Objective(const CalibrationSpec& spec, const std::string& scale)
+        : spec_{spec}
+        , fit_bonus_{spec.target.same_string >= 0.0} {
+        analysis_.instruments = {spec.instrument};
+        analysis_.scales = {scale};
+        analysis_.seed = spec.seed;
+        analysis_.num_threads = spec.num_threads;
+
+        // Every key gets `blocks` combos of their own seed, so the work
+        // spreads over many threads and does not depend on their count
+        const long long per_key = std::max(1LL, spec.exercises / Music::NUM_KEYS);
+        const long long blocks = std::max(1LL, (per_key + CALIBRATION_BLOCK / 2) / CALIBRATION_BLOCK);
+        analysis_.exercises = std::max(1LL, per_key / blocks);
+        for (long long b = 0; b < blocks; ++b) {
+            for (int key = 0; key < Music::NUM_KEYS; ++key) {
+                analysis_.keys.push_back(static_cast<Music::KeyIndex>(key));
+            }
+        }
+    }
+
+    [[nodiscard]] std::size_t dimensions() const noexcept { return fit_bonus_ ? 3 : 2; }
+
+    [[nodiscard]] std::vector<double> startPoint() const {
+        const GeneratorProfile& profile = spec_.profile;
+        const double close = std::max(profile.weight_close, 1);
+        std::vector<double> x{std::log(std::max(profile.weight_medium, 1) / close),
+                              std::log(std::max(profile.weight_far, 1) / close)};
+        if (fit_bonus_) x.push_back(profile.same_string_bonus / 100.0);
+        return x;
+    }
+
+    // Largest weight at MAX_PROFILE_WEIGHT for the finest rounding
+    [[nodiscard]] ScaleWeights toWeights(const std::vector<double>& x) const {
+        const double medium = std::exp(std::clamp(x[0], -MAX_LOG_RATIO, MAX_LOG_RATIO));
+        const double far = std::exp(std::clamp(x[1], -MAX_LOG_RATIO, MAX_LOG_RATIO));
+        const double scale = MAX_PROFILE_WEIGHT / std::max({1.0, medium, far});
+        ScaleWeights weights{};
+        weights.weight_close = static_cast<int>(std::lround(scale));
+        weights.weight_medium = static_cast<int>(std::lround(medium * scale));
+        weights.weight_far = static_cast<int>(std::lround(far * scale));
+        weights.same_string_bonus = fit_bonus_
+            ? static_cast<int>(std::clamp(std::lround(x[2] * 100.0), 0L, static_cast<long>(MAX_PROFILE_BONUS)))
+            : spec_.profile.same_string_bonus;
+        return weights;
+    }
+
+    const Evaluation& evaluate(const std::vector<double>& x) {
+        const ScaleWeights weights = toWeights(x);
+        const auto key = std::make_tuple(weights.weight_close, weights.weight_medium, weights.weight_far,
+                                         weights.same_string_bonus);
+        const auto cached = cache_.find(key);
+        if (cached != cache_.end()) return cached->second;
+
+        analysis_.profile = spec_.profile;
+        analysis_.profile.weight_close = weights.weight_close;
+        analysis_.profile.weight_medium = weights.weight_medium;
+        analysis_.profile.weight_far = weights.weight_far;
+        analysis_.profile.same_string_bonus = weights.same_string_bonus;
+        const UsageHistogram usage = runAnalysis(analysis_).usage[0];
+        ++simulations_;
+
+        Evaluation evaluation{};
+        evaluation.weights = weights;
+        const double moves = std::max(1LL, usage.moves);
+        for (int c = 0; c < NUM_DISTANCE_CLASSES; ++c) {
+            evaluation.realized[c] = 100.0 * usage.distance_class[c] / moves;
+        }
+        const long long same_string = std::accumulate(usage.same_string_class.begin(),
+                                                      usage.same_string_class.end(), 0LL);
+        evaluation.same_string = 100.0 * same_string / moves;
+
+        double squares = 0.0;
+        for (std::size_t c = 0; c < spec_.target.distance.size(); ++c) {
+            const double diff = evaluation.realized[c] - spec_.target.distance[c];
+            squares += diff * diff;
+        }
+        if (fit_bonus_) {
+            const double diff = evaluation.same_string - spec_.target.same_string;
+            squares += diff * diff;
+        }
+        evaluation.error = std::sqrt(squares / static_cast<double>(spec_.target.distance.size() + fit_bonus_));
+        return cache_.emplace(key, evaluation).first->second;
+    }
+
+    [[nodiscard]] int getSimulations() const noexcept { return simulations_; }
+
+private:
+    const CalibrationSpec& spec_;
+    bool fit_bonus_;
+    AnalysisSpec analysis_;
+    std::map<std::tuple<int, int, int, int>, Evaluation> cache_;  // By rounded weights
+    int simulations_ = 0;
+};
+
+// x + t * (y - x)
+std::vector<double> along(const std::vector<double>& x, const std::vector<double>& y, double t) {
+    std::vector<double> point(x.size());
+    for (std::size_t i = 0; i < x.size(); ++i) point[i] = x[i] + t * (y[i] - x[i]);
+    return point;
+}
+
+} // namespace
+
+// ============================================================================
+// Target Parsing
+// ============================================================================
+
+std::optional<std::array<double, 3>> parseDistanceTarget(const std::string& text) {
+    std::string spaced = text;
+    std::replace(spaced.begin(), spaced.end(), ',', ' ');
+    std::istringstream in(spaced);
+
+    std::array<double, 3> shares{};
+    std::string extra;
+    if (!(in >> shares[0] >> shares[1] >> shares[2]) || (in >> extra)) return std::nullopt;
+    if (std::any_of(shares.begin(), shares.end(), [](double share) { return !(share >= 0.0); })) {
+        return std::nullopt;
+    }
+    const double total = shares[0] + shares[1] + shares[2];
+    if (total <= 0.0) return std::nullopt;
+    for (auto& share : shares) share *= 100.0 / total;
+    return shares;
+}
+
+// ============================================================================
+// Nelder-Mead
+// ============================================================================
+
+ScaleCalibration calibrateScale(const CalibrationSpec& spec, const std::string& scale) {
+    Objective objective(spec, scale);
+    const std::size_t n = objective.dimensions();
+
+    auto score = [&](std::vector<double> x) {
+        const double error = objective.evaluate(x).error;
+        return Vertex{std::move(x), error};
+    };
+
+    std::vector<Vertex> simplex;
+    const std::vector<double> start = objective.startPoint();
+    simplex.push_back(score(start));
+    for (std::size_t i = 0; i < n; ++i) {
+        std::vector<double> x = start;
+        x[i] += i < 2 ? SIMPLEX_STEP : BONUS_STEP;
+        simplex.push_back(score(std::move(x)));
+    }
+
+    // Cache hits cost nothing, so iterations are capped separately
+    for (int iteration = 0; iteration < 4 * spec.max_evaluations; ++iteration) {
+        std::sort(simplex.begin(), simplex.end(),
+                  [](const Vertex& a, const Vertex& b) { return a.error < b.error; });
+        if (objective.getSimulations() >= spec.max_evaluations || simplex[0].error <= CALIBRATION_TOLERANCE) break;
+
+        // Collapsed: every vertex rounds to the same weights
+        const ScaleWeights best = objective.toWeights(simplex[0].x);
+        if (std::all_of(simplex.begin(), simplex.end(),
+                        [&](const Vertex& v) { return objective.toWeights(v.x) == best; })) {
+            break;
+        }
+
+        std::vector<double> centroid(n, 0.0);
+        for (std::size_t v = 0; v < n; ++v) {
+            for (std::size_t i = 0; i < n; ++i) centroid[i] += simplex[v].x[i] / static_cast<double>(n);
+        }
+        Vertex& worst = simplex[n];
+
+        const Vertex reflected = score(along(centroid, worst.x, -REFLECTION));
+        if (reflected.error < simplex[0].error) {
+            const Vertex expanded = score(along(centroid, worst.x, -EXPANSION));
+            worst = expanded.error < reflected.error ? expanded : reflected;
+            continue;
+        }
+        if (reflected.error < simplex[n - 1].error) {
+            worst = reflected;
+            continue;
+        }
+
+        const bool outside = reflected.error < worst.error;
+        const Vertex contracted = score(along(centroid, outside ? reflected.x : worst.x, CONTRACTION));
+        if (contracted.error < std::min(worst.error, reflected.error)) {
+            worst = contracted;
+            continue;
+        }
+
+        for (std::size_t v = 1; v <= n; ++v) {
+            simplex[v] = score(along(simplex[0].x, simplex[v].x, SHRINK));
+        }
+    }
+
+    const auto best = std::min_element(simplex.begin(), simplex.end(),
+                                       [](const Vertex& a, const Vertex& b) { return a.error < b.error; });
+    const Evaluation& evaluation = objective.evaluate(best->x);
+    return {scale, evaluation.weights, evaluation.realized, evaluation.same_string, evaluation.error,
+            objective.getSimulations()};
+}
+
+} // namespace Guitar
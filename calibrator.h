@@ -0,0 +1,67 @@
+#ifndef CALIBRATOR_H
+#define CALIBRATOR_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include "analyzer.h"
+#include "fretboard.h"
+#include "generator.h"
+
+namespace Guitar {
+
+// ============================================================================
+// Constants - Weight Calibration
+// ============================================================================
+
+constexpr long long DEFAULT_CALIBRATION_COUNT = 12000;   // Exercises per evaluation (all 12 keys)
+constexpr long long CALIBRATION_BLOCK = 250;             // Exercises per simulated combo
+constexpr int DEFAULT_CALIBRATION_EVALUATIONS = 80;      // Simulations per scale
+constexpr double CALIBRATION_TOLERANCE = 0.25;           // RMS error (points) good enough to stop
+
+// ============================================================================
+// Calibration
+// ============================================================================
+
+struct CalibrationTarget {
+    std::array<double, 3> distance{70.0, 25.0, 5.0};  // Percent of 0-2 / 3 / 4 fret moves
+    double same_string = -1.0;                        // Percent of same-string moves; < 0 keeps the bonus
+};
+
+// "70,25,5" or "70 25 5": three non-negative shares, scaled to 100%
+[[nodiscard]] std::optional<std::array<double, 3>> parseDistanceTarget(const std::string& text);
+
+struct CalibrationSpec {
+    InstrumentConfig instrument = getInstrumentConfig(InstrumentType::Guitar);
+    GeneratorProfile profile = STANDARD_PROFILE;  // Rules kept fixed; its weights are the start point
+    CalibrationTarget target;
+    long long exercises = DEFAULT_CALIBRATION_COUNT;
+    int max_evaluations = DEFAULT_CALIBRATION_EVALUATIONS;
+    std::uint32_t seed = 1;
+    unsigned num_threads = 0;                       // 0 = every core
+};
+
+struct ScaleCalibration {
+    std::string scale;
+    ScaleWeights weights;
+    std::array<double, NUM_DISTANCE_CLASSES> realized;  // Percent of moves with the fitted weights
+    double same_string;                                  // Percent of same-string moves
+    double error;                                        // RMS distance to the target, in points
+    int evaluations;                                     // Simulations run
+};
+
+// Nelder-Mead over the log ratios medium/close and far/close (plus the
+// same-string bonus when the target has a same-string share); every point
+// is scored by simulating spec.exercises exercises over the 12 keys with
+// runAnalysis, split in CALIBRATION_BLOCK-sized combos so all cores share
+// each evaluation. The seeds are the same for every evaluation (common
+// random numbers), which keeps the objective deterministic, and points
+// are rounded to integer weights, the same integer point is never
+// simulated twice. WeightTable::getInstance() must be empty: the
+// simulation has to run the candidate weights, not the table's.
+[[nodiscard]] ScaleCalibration calibrateScale(const CalibrationSpec& spec, const std::string& scale);
+
+} // namespace Guitar
+
+#endif // CALIBRATOR_H
@@ -0,0 +1,1868 @@
+#include "cli.h"
+#include "analyzer.h"
+#include "batch_generator.h"
+#include "calibrator.h"
+#include "difficulty.h"
+#include "exporter.h"
+#include "fingering.h"
+#include "formatter.h"
+#include "generator.h"
+#include "music_theory.h"
+#include "performance.h"
+#include "practice.h"
+#include "practice_book.h"
+#include "rule_set.h"
+#include "scale_dictionary.h"
+#include "scale_finder.h"
+#include "similarity.h"
+#include "svg_sheet.h"
+#include "synth.h"
+#include "tab_parser.h"
+#include "thread_count.h"
+#include "transition_model.h"
+#include "transcriber.h"
+#include "verifier.h"
+#include "voicing.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+
+namespace Cli {
+
+// ============================================================================
+// Arguments Implementation
+// ============================================================================
+
+bool Arguments::has(const std::string& name) const {
+    return options.find(name) != options.end();
+}
+
+std::string Arguments::get(const std::string& name, const std::string& fallback) const {
+    auto it = options.find(name);
+    return it != options.end() ? it->second : fallback;
+}
+
+long long Arguments::getInt(const std::string& name, long long fallback) const {
+    auto it = options.find(name);
+    if (it == options.end()) return fallback;
+    try {
+        return std::stoll(it->second);
+    } catch (...) {
+        return fallback;
+    }
+}
+
+Arguments parseArguments(int argc, char* argv[], int first) {
+    Arguments args;
+    for (int i = first; i < argc; ++i) {
+        const std::string token = argv[i];
+        if (token.size() > 2 && token.rfind("--", 0) == 0) {
+            const std::string name = token.substr(2);
+            const bool has_value = (i + 1 < argc) && std::string(argv[i + 1]).rfind("--", 0) != 0;
+            args.options[name] = has_value ? argv[++i] : "true";
+        } else {
+            args.positional.push_back(token);
+        }
+    }
+    return args;
+}
+
+std::optional<Guitar::InstrumentConfig> parseInstrumentOptions(const Arguments& args) {
+    using namespace Guitar;
+
+    std::string preset = args.get("instrument", "guitar");
+    if (preset == "guitarra") preset = "guitar";
+    if (preset == "bajo") preset = "bass";
+
+    auto base = findInstrumentPreset(preset);
+    if (!base) {
+        std::cerr << "Instrumento desconocido: " << preset
+                  << " (guitar, guitar7, guitar8, bass, bass5, bass6, drop-d, open-g, open-d, dadgad)"
+                  << std::endl;
+        return std::nullopt;
+    }
+
+    // Open pitches back to the lowest-first order used by tunings
+    std::vector<int> low_to_high(base->open_midi.rend() - base->num_strings, base->open_midi.rend());
+    std::string name = base->name;
+    std::string tuning_name = base->tuning_name;
+
+    if (args.has("tuning")) {
+        auto tuning = parseTuning(args.get("tuning", ""));
+        if (!tuning) {
+            std::cerr << "Afinacion invalida: " << args.get("tuning", "")
+                      << " (ej: \"D2 A2 D3 G3 B3 E4\")" << std::endl;
+            return std::nullopt;
+        }
+        if (tuning->size() != low_to_high.size()) {
+            name = std::to_string(tuning->size()) + "-String " +
+                   (base->type == InstrumentType::Bass ? "Bass" : "Guitar");
+        }
+        low_to_high = *tuning;
+        tuning_name = "Custom";
+    }
+
+    const int num_frets = static_cast<int>(args.getInt("frets", base->num_frets));
+    const int capo = static_cast<int>(args.getInt("capo", 0));
+
+    auto instrument = makeInstrument(base->type, name, tuning_name, low_to_high, num_frets, capo);
+    if (!instrument) {
+        std::cerr << "Instrumento invalido: 3-" << MAX_STRINGS << " cuerdas, "
+                  << POSITION_MIN_FRETS << "-" << MAX_SUPPORTED_FRET
+                  << " trastes y al menos " << POSITION_MIN_FRETS << " trastes libres tras la cejilla"
+                  << std::endl;
+    }
+    return instrument;
+}
+
+std::optional<Guitar::GeneratorProfile> parseProfileOptions(const Arguments& args) {
+    using namespace Guitar;
+
+    GeneratorProfile profile = STANDARD_PROFILE;
+    if (args.has("profile")) {
+        const std::string source = args.get("profile", "");
+        auto loaded = findGeneratorProfile(source);
+        if (!loaded) loaded = loadGeneratorProfile(source);
+        if (!loaded) {
+            std::cerr << "Perfil invalido: " << source
+                      << " (standard, beginner, advanced o un archivo \"clave = valor\")" << std::endl;
+            return std::nullopt;
+        }
+        profile = *loaded;
+    }
+
+    // "--box-radius" sets "box_radius", and so on for every key
+    for (const auto& key : getProfileKeys()) {
+        std::string flag = key;
+        std::replace(flag.begin(), flag.end(), '_', '-');
+        if (args.has(flag) && !setProfileValue(profile, key, args.get(flag, ""))) {
+            std::cerr << "Valor invalido para --" << flag << ": " << args.get(flag, "") << std::endl;
+            return std::nullopt;
+        }
+    }
+
+    if (!isValidProfile(profile)) {
+        std::cerr << "Perfil fuera de rango: radio 1-" << MAX_PROFILE_BOX_RADIUS << ", ventana 1-"
+                  << MAX_PROFILE_WINDOW_SIZE << ", rangos 1-" << MAX_PROFILE_RANGE << ", pesos 0-"
+                  << MAX_PROFILE_WEIGHT << ", bonus 0-" << MAX_PROFILE_BONUS << "%" << std::endl;
+        return std::nullopt;
+    }
+    return profile;
+}
+
+bool loadWeightTable(const Arguments& args) {
+    using namespace Guitar;
+
+    WeightTable& table = WeightTable::getInstance();
+    if (args.has("no-weights")) return true;
+    if (args.has("weights")) {
+        const std::string path = args.get("weights", "");
+        if (table.load(path)) return true;
+        std::cerr << "No se pudo leer la tabla de pesos: " << path << std::endl;
+        return false;
+    }
+    if (!std::ifstream(DEFAULT_WEIGHT_TABLE)) return true;
+    if (!table.load(DEFAULT_WEIGHT_TABLE)) {
+        std::cerr << "Aviso: " << DEFAULT_WEIGHT_TABLE << " invalido, se usan los pesos del perfil" << std::endl;
+    }
+    return true;
+}
+
+bool loadTransitionModel(const Arguments& args) {
+    using namespace Guitar;
+
+    TransitionModel& model = TransitionModel::getInstance();
+    if (args.has("no-model")) return true;
+    if (args.has("model")) {
+        const std::string path = args.get("model", "");
+        if (model.load(path)) return true;
+        std::cerr << "No se pudo leer el modelo de transiciones: " << path << std::endl;
+        return false;
+    }
+    if (!std::ifstream(DEFAULT_TRANSITION_MODEL)) return true;
+    if (!model.load(DEFAULT_TRANSITION_MODEL)) {
+        std::cerr << "Aviso: " << DEFAULT_TRANSITION_MODEL << " invalido, se usan los pesos del perfil" << std::endl;
+    }
+    return true;
+}
+
+bool loadRules(const Arguments& args) {
+    using namespace Guitar;
+
+    RuleSet& rules = RuleSet::getInstance();
+    if (args.has("no-rules")) return true;
+
+    // Every bad rule as "source:line: reason"
+    auto parseSource = [&rules](const std::string& source, const std::string& text) {
+        const auto errors = rules.parse(text);
+        for (const auto& error : errors) {
+            std::cerr << source << ":" << error.line << ": " << error.reason << std::endl;
+        }
+        return errors.empty();
+    };
+    auto readFile = [](const std::string& path, std::string& text) {
+        std::ifstream in(path);
+        if (!in) return false;
+        std::ostringstream buffer;
+        buffer << in.rdbuf();
+        text = buffer.str();
+        return true;
+    };
+
+    std::string text;
+    if (!args.has("rules") && !args.has("rule")) {
+        if (!readFile(DEFAULT_RULE_FILE, text)) return true;
+        if (!parseSource(DEFAULT_RULE_FILE, text)) {
+            std::cerr << "Aviso: " << DEFAULT_RULE_FILE << " invalido, se generan ejercicios sin reglas" << std::endl;
+        }
+        return true;
+    }
+    if (args.has("rules")) {
+        const std::string path = args.get("rules", "");
+        if (!readFile(path, text)) {
+            std::cerr << "No se pudo leer el archivo de reglas: " << path << std::endl;
+            return false;
+        }
+        if (!parseSource(path, text)) return false;
+    }
+    return !args.has("rule") || parseSource("--rule", args.get("rule", ""));
+}
+
+namespace {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+std::vector<std::unique_ptr<Guitar::Note>> toOwned(const std::vector<Guitar::Note>& notes) {
+    std::vector<std::unique_ptr<Guitar::Note>> owned;
+    owned.reserve(notes.size());
+    for (const auto& note : notes) {
+        owned.push_back(std::make_unique<Guitar::Note>(note));
+    }
+    return owned;
+}
+
+// "--scales <archivo>" adds user scales to the dictionary for any command
+bool loadUserScales(const Arguments& args) {
+    if (!args.has("scales")) return true;
+    const std::string path = args.get("scales", "");
+    if (Music::ScaleDictionary::getInstance().loadScaleFile(path)) return true;
+    std::cerr << "No se pudo abrir el archivo de escalas: " << path << std::endl;
+    return false;
+}
+
+// "--key" / "--scale" narrow a sweep over every key and scale
+bool parseSweepOptions(const Arguments& args, std::vector<Music::KeyIndex>& keys, std::vector<std::string>& scales) {
+    const auto& dict = Music::ScaleDictionary::getInstance();
+    if (args.has("key")) {
+        const int key = Music::parseKeyName(args.get("key", ""));
+        if (key < 0) {
+            std::cerr << "Tonalidad invalida: " << args.get("key", "") << std::endl;
+            return false;
+        }
+        keys.push_back(static_cast<Music::KeyIndex>(key));
+    } else {
+        for (int key = 0; key < Music::NUM_KEYS; ++key) keys.push_back(static_cast<Music::KeyIndex>(key));
+    }
+    if (args.has("scale")) {
+        if (!dict.hasScale(args.get("scale", ""))) {
+            std::cerr << "Escala invalida: " << args.get("scale", "") << std::endl;
+            return false;
+        }
+        scales.push_back(args.get("scale", ""));
+    } else {
+        scales = dict.getAllScaleNames();
+    }
+    return true;
+}
+
+// The options of `args` that shape generation, as "--name value" flags
+// for a reproduction command line
+std::string forwardGeneratorOptions(const Arguments& args) {
+    std::vector<std::string> names = {"instrument", "tuning", "frets", "capo", "profile", "scales", "weights",
+                                      "no-weights", "model", "no-model", "rules", "rule", "no-rules"};
+    for (const auto& key : Guitar::getProfileKeys()) {
+        std::string flag = key;
+        std::replace(flag.begin(), flag.end(), '_', '-');
+        names.push_back(flag);
+    }
+
+    std::string flags;
+    for (const auto& name : names) {
+        if (!args.has(name)) continue;
+        const std::string value = args.get(name, "");
+        flags += " --" + name;
+        if (value == "true") continue;
+        flags += value.find_first_of(" ;") == std::string::npos ? " " + value : " \"" + value + "\"";
+    }
+    return flags;
+}
+
+// Double-stop / chord exercises for generate --voicing; the generator only
+// picks key and scale, tables are rebuilt when they change
+int generateVoicings(Guitar::TablatureGenerator& generator, Guitar::VoicingType type,
+                     const Guitar::GeneratorProfile& profile, long long count, std::uint32_t seed) {
+    using namespace Guitar;
+
+    const InstrumentConfig& instrument = generator.getInstrument();
+    Music::ScaleManager scale_mgr;
+    std::unique_ptr<FretboardValidator> validator;
+    std::unique_ptr<VoicingTable> table;
+    std::unique_ptr<VoicingGenerator> voicing_gen;
+    std::string label;
+    std::vector<Voicing> voicings;
+    std::vector<std::vector<Note>> columns;
+
+    Formatter::printInstrumentInfo(instrument);
+    for (long long i = 0; i < count; ++i) {
+        generator.generate();
+        const auto& current = generator.getScaleManager();
+        if (current.getFullDescription() != label) {
+            scale_mgr.setKeyAndScale(generator.getCurrentKeyIndex(), generator.getCurrentScaleName());
+            validator = std::make_unique<FretboardValidator>(scale_mgr, instrument);
+            table = std::make_unique<VoicingTable>(*validator, type);
+            voicing_gen = std::make_unique<VoicingGenerator>(*table, instrument, profile,
+                                                             seed + static_cast<std::uint32_t>(i));
+            label = current.getFullDescription();
+        }
+
+        std::cout << std::endl;
+        if (!voicing_gen->generate(voicings)) {
+            std::cout << "(" << label << ": sin formas tocables de " << getVoicingTypeName(type) << ")" << std::endl;
+            continue;
+        }
+        columns.clear();
+        for (const auto& voicing : voicings) {
+            columns.push_back(voicingNotes(voicing, instrument.num_strings));
+        }
+        Formatter::printChordTablature(columns, instrument);
+        Formatter::printHarmonicInfo(current.getCurrentKeyName(), current.getCurrentScaleName(),
+                                     current.getScaleNotes());
+    }
+    return 0;
+}
+
+// ============================================================================
+// Commands
+// ============================================================================
+
+int commandGenerate(const Arguments& args) {
+    using namespace Guitar;
+
+    const auto instrument = parseInstrumentOptions(args);
+    if (!instrument) return 1;
+    const auto profile = parseProfileOptions(args);
+    if (!profile) return 1;
+
+    TablatureGenerator generator(*instrument);
+    generator.setProfile(*profile);
+
+    if (args.has("key") || args.has("scale")) {
+        const int key = Music::parseKeyName(args.get("key", "C"));
+        const std::string scale = args.get("scale", "Major");
+        if (key < 0 || !Music::ScaleDictionary::getInstance().hasScale(scale)) {
+            std::cerr << "Tonalidad o escala invalida: " << args.get("key", "C") << " " << scale << std::endl;
+            return 1;
+        }
+        generator.setKeyAndScale(static_cast<Music::KeyIndex>(key), scale);
+    }
+
+    std::optional<DifficultyBand> band;
+    if (args.has("difficulty")) {
+        band = parseDifficultyBand(args.get("difficulty", ""));
+        if (!band) {
+            std::cerr << "Dificultad invalida: usar un rango como 30-45 (0-100)" << std::endl;
+            return 1;
+        }
+    }
+    const auto seed = static_cast<std::uint32_t>(args.getInt("seed", std::random_device{}()));
+    const long long count = std::max(1LL, args.getInt("count", 1));
+    if (args.has("seed")) generator.setSeed(seed);
+
+    if (args.has("voicing")) {
+        const auto type = parseVoicingType(args.get("voicing", ""));
+        if (!type || band) {
+            std::cerr << "--voicing acepta thirds, sixths o triads (sin --difficulty)" << std::endl;
+            return 1;
+        }
+        return generateVoicings(generator, *type, *profile, count, seed);
+    }
+
+    Formatter::printInstrumentInfo(generator.getInstrument());
+
+    // Targeted mode: the generator only picks key and scale; the exercise
+    // comes from a TargetedGenerator kept while they stay the same
+    Music::ScaleManager target_scale;
+    std::unique_ptr<FretboardValidator> target_validator;
+    std::unique_ptr<TargetedGenerator> targeted;
+    std::string target_label;
+    const DifficultyScorer scorer(*instrument);
+    std::vector<Note> notes;
+
+    for (long long i = 0; i < count; ++i) {
+        generator.generate();
+        const auto& scale_mgr = generator.getScaleManager();
+
+        DifficultyScore score{};
+        if (band) {
+            const std::string label = scale_mgr.getFullDescription();
+            if (label != target_label) {
+                target_scale.setKeyAndScale(generator.getCurrentKeyIndex(), generator.getCurrentScaleName());
+                target_validator = std::make_unique<FretboardValidator>(target_scale, *instrument);
+                targeted = std::make_unique<TargetedGenerator>(*target_validator, *band,
+                                                               seed + static_cast<std::uint32_t>(i));
+                target_label = label;
+            }
+            score = targeted->generate(notes);
+        } else {
+            notes.clear();
+            for (const auto& note : generator.getNotes()) notes.push_back(*note);
+            score = scorer.score(notes, scale_mgr.getPitchClassMask());
+        }
+
+        std::cout << std::endl;
+        Formatter::printTablature(toOwned(notes), generator.getInstrument());
+        Formatter::printFingering(assignFingering(notes), generator.getInstrument());
+        Formatter::printHarmonicInfo(scale_mgr.getCurrentKeyName(),
+                                     scale_mgr.getCurrentScaleName(),
+                                     scale_mgr.getScaleNotes());
+        std::cout << "Dificultad: " << std::fixed << std::setprecision(0) << score.total << "/100" << std::endl;
+        if (!band && generator.getStats().rule_failures > 0) {
+            std::cerr << "Aviso: ninguno de " << MAX_RULE_ATTEMPTS << " intentos cumple las reglas, se muestra el "
+                         "que menos las rompe" << std::endl;
+        }
+    }
+
+    if (targeted) {
+        std::cout << std::endl << "(" << targeted->getMisses() << " fuera de la banda " << args.get("difficulty", "")
+                  << ")" << std::endl;
+    }
+    return 0;
+}
+
+int commandBook(const Arguments& args) {
+    using namespace Guitar;
+
+    const auto instrument = parseInstrumentOptions(args);
+    if (!instrument) return 1;
+    const auto profile = parseProfileOptions(args);
+    if (!profile) return 1;
+
+    PracticeBookSpec spec;
+    spec.instrument = *instrument;
+    spec.profile = *profile;
+    spec.scale_name = args.get("scale", "Major");
+    spec.seed = static_cast<std::uint32_t>(args.getInt("seed", std::random_device{}()));
+
+    const int key = Music::parseKeyName(args.get("key", "C"));
+    if (key < 0 || !Music::ScaleDictionary::getInstance().hasScale(spec.scale_name)) {
+        std::cerr << "Tonalidad o escala invalida: " << args.get("key", "C") << " " << spec.scale_name << std::endl;
+        return 1;
+    }
+    spec.base_key = static_cast<Music::KeyIndex>(key);
+
+    const auto start = Clock::now();
+    const auto pages = buildPracticeBook(spec);
+    const double build_ms = elapsedMs(start);
+
+    Formatter::printInstrumentInfo(spec.instrument);
+    int regenerated = 0;
+    for (const auto& page : pages) {
+        std::cout << std::endl;
+        Formatter::printTablature(toOwned(page.notes), spec.instrument);
+        Formatter::printFingering(assignFingering(page.notes), spec.instrument);
+
+        const std::vector<int> intervals = Music::ScaleDictionary::getInstance().getIntervals(spec.scale_name);
+        Formatter::printHarmonicInfo(Music::pitchClassToName(page.key), spec.scale_name,
+                                     Music::computeScaleNotes(page.key, intervals));
+        if (page.regenerated) {
+            std::cout << "(regenerado: desplazado no cabe en el diapason, la escala o las reglas)" << std::endl;
+            ++regenerated;
+        } else if (page.fret_shift != 0) {
+            std::cout << "(transpuesto " << std::showpos << page.fret_shift << std::noshowpos
+                      << " trastes)" << std::endl;
+        }
+    }
+
+    std::cout << std::endl << pages.size() << " tonalidades en " << std::fixed << std::setprecision(3)
+              << build_ms << " ms, " << regenerated << " regeneradas (semilla " << spec.seed << ")" << std::endl;
+    return 0;
+}
+
+// "corpus.mid" + 12 -> "corpus_00012.mid"
+std::string numberedPath(const std::string& path, long long number) {
+    const auto dot = path.find_last_of('.');
+    std::string digits = std::to_string(number);
+    digits.insert(0, digits.size() < 5 ? 5 - digits.size() : 0, '0');
+    return path.substr(0, dot) + "_" + digits + path.substr(dot);
+}
+
+// Exercises for export and sheet: a practice book (--book) or a seeded
+// stream (--count, --seed) with a fixed or random --key and --scale
+class ExerciseStream {
+public:
+    // Prints the problem and returns false on invalid options
+    [[nodiscard]] bool open(const Arguments& args, const Guitar::InstrumentConfig& instrument,
+                            const Guitar::GeneratorProfile& profile);
+
+    [[nodiscard]] long long size() const noexcept { return count_; }
+    [[nodiscard]] std::uint32_t getSeed() const noexcept { return seed_; }  // --seed, or the random one drawn
+
+    void next(std::vector<Guitar::Note>& notes, Music::KeyIndex& key, std::string& scale);
+
+private:
+    Guitar::InstrumentConfig instrument_;
+    Guitar::GeneratorProfile profile_;
+    int fixed_key_ = -1;
+    std::string fixed_scale_;
+    std::uint32_t seed_ = 0;
+    long long count_ = 0;
+    long long produced_ = 0;
+
+    std::vector<Guitar::PracticeBookPage> book_;
+    std::vector<std::string> scale_names_;
+    std::unique_ptr<Guitar::RandomEngine> picker_;
+    Music::ScaleManager scale_mgr_;
+    std::unique_ptr<Guitar::FretboardValidator> validator_;
+    std::unique_ptr<Guitar::NoteGenerator> generator_;
+    std::string current_;  // Key + scale of generator_
+};
+
+bool ExerciseStream::open(const Arguments& args, const Guitar::InstrumentConfig& instrument,
+                          const Guitar::GeneratorProfile& profile) {
+    using namespace Guitar;
+
+    const auto& dict = Music::ScaleDictionary::getInstance();
+    instrument_ = instrument;
+    profile_ = profile;
+    fixed_key_ = args.has("key") ? Music::parseKeyName(args.get("key", "")) : -1;
+    fixed_scale_ = args.get("scale", args.has("book") ? "Major" : "");
+    if ((args.has("key") && fixed_key_ < 0) || (!fixed_scale_.empty() && !dict.hasScale(fixed_scale_))) {
+        std::cerr << "Tonalidad o escala invalida: " << args.get("key", "") << " " << fixed_scale_ << std::endl;
+        return false;
+    }
+
+    seed_ = static_cast<std::uint32_t>(args.getInt("seed", std::random_device{}()));
+    picker_ = std::make_unique<RandomEngine>(seed_);
+    scale_names_ = dict.getAllScaleNames();
+
+    if (args.has("book")) {
+        PracticeBookSpec spec;
+        spec.instrument = instrument_;
+        spec.profile = profile_;
+        spec.scale_name = fixed_scale_;
+        spec.base_key = static_cast<Music::KeyIndex>(std::max(fixed_key_, 0));
+        spec.seed = seed_;
+        book_ = buildPracticeBook(spec);
+        count_ = static_cast<long long>(book_.size());
+    } else {
+        count_ = std::max(1LL, args.getInt("count", 1));
+    }
+    return true;
+}
+
+void ExerciseStream::next(std::vector<Guitar::Note>& notes, Music::KeyIndex& key, std::string& scale) {
+    using namespace Guitar;
+
+    const long long index = produced_++;
+    if (!book_.empty()) {
+        notes = book_[index].notes;
+        key = book_[index].key;
+        scale = fixed_scale_;
+        return;
+    }
+
+    key = static_cast<Music::KeyIndex>(fixed_key_ >= 0 ? fixed_key_ : picker_->generateInt(0, Music::NUM_KEYS - 1));
+    scale = !fixed_scale_.empty()
+        ? fixed_scale_
+        : scale_names_[picker_->generateInt(0, static_cast<int>(scale_names_.size()) - 1)];
+
+    const std::string label = Music::pitchClassToName(key) + " " + scale;
+    if (label != current_) {
+        scale_mgr_.setKeyAndScale(key, scale);
+        validator_ = std::make_unique<FretboardValidator>(scale_mgr_, instrument_);
+        generator_ = makeNoteGenerator(*validator_, profile_, seed_ + static_cast<std::uint32_t>(index));
+        current_ = label;
+    }
+
+    notes.clear();
+    for (const auto& note : generator_->generateTablature()) {
+        notes.push_back(*note);
+    }
+}
+
+int commandExport(const Arguments& args) {
+    using namespace Guitar;
+
+    const auto format = args.positional.empty() ? std::nullopt : exportFormatFromPath(args.positional[0]);
+    if (!format) {
+        std::cerr << "Uso: crazyfingers export <archivo.mid|archivo.musicxml> [--count N] [--seed S]"
+                     " [--key K] [--scale NOMBRE] [--tempo BPM] [--value 4|8|16] [--split] [--book] [--no-fingering]"
+                  << std::endl;
+        return 1;
+    }
+    const std::string path = args.positional[0];
+
+    const auto instrument = parseInstrumentOptions(args);
+    if (!instrument) return 1;
+    const auto profile = parseProfileOptions(args);
+    if (!profile) return 1;
+
+    ExportOptions options;
+    options.tempo_bpm = static_cast<int>(args.getInt("tempo", options.tempo_bpm));
+    options.note_value = static_cast<int>(args.getInt("value", options.note_value));
+    options.title = args.get("title", options.title);
+    options.fingering = !args.has("no-fingering");
+    if (!isValidExportOptions(options)) {
+        std::cerr << "Exportacion invalida: tempo " << MIN_EXPORT_TEMPO << "-" << MAX_EXPORT_TEMPO
+                  << " y --value 4, 8 o 16" << std::endl;
+        return 1;
+    }
+
+    ExerciseStream exercises;
+    if (!exercises.open(args, *instrument, *profile)) return 1;
+    const long long count = exercises.size();
+    const bool split = args.has("split");
+
+    std::vector<Note> notes;
+    Music::KeyIndex key = 0;
+    std::string scale;
+    std::ofstream out;
+    std::unique_ptr<ExerciseWriter> writer;
+    bool ok = true;
+    const auto start = Clock::now();
+
+    for (long long i = 0; i < count; ++i) {
+        exercises.next(notes, key, scale);
+
+        if (!writer) {
+            const std::string file = split ? numberedPath(path, i + 1) : path;
+            out.open(file, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                std::cerr << "No se pudo escribir " << file << std::endl;
+                return 1;
+            }
+            writer = makeExerciseWriter(*format, out, *instrument, options);
+        }
+        writer->write(notes, Music::pitchClassToName(key) + " " + scale);
+
+        if (split || i + 1 == count) {
+            ok = writer->finish() && ok;
+            writer.reset();
+            out.close();
+        }
+    }
+
+    std::cout << "Exportados " << count << " ejercicios en " << std::fixed << std::setprecision(1)
+              << elapsedMs(start) << " ms -> " << (split ? numberedPath(path, 1) + " ..." : path) << std::endl;
+    if (!ok) std::cerr << "Error de escritura" << std::endl;
+    return ok ? 0 : 1;
+}
+
+int commandSheet(const Arguments& args) {
+    using namespace Guitar;
+
+    if (args.positional.empty()) {
+        std::cerr << "Uso: crazyfingers sheet <archivo.svg> [--count N | --book] [--per-page K]"
+                     " [--seed S] [--key K] [--scale NOMBRE] [--title T]" << std::endl;
+        return 1;
+    }
+    const std::string path = args.positional[0];
+
+    const auto instrument = parseInstrumentOptions(args);
+    if (!instrument) return 1;
+    const auto profile = parseProfileOptions(args);
+    if (!profile) return 1;
+
+    ExerciseStream exercises;
+    if (!exercises.open(args, *instrument, *profile)) return 1;
+
+    SheetOptions options;
+    options.title = args.get("title", options.title);
+    options.exercises_per_page = static_cast<int>(args.getInt("per-page", 0));
+    options.box_radius = profile->position_box_radius;
+    SvgSheetRenderer renderer(*instrument, options);
+
+    const auto& dict = Music::ScaleDictionary::getInstance();
+    const long long count = exercises.size();
+    const long long per_page = renderer.getExercisesPerPage();
+    const auto pages = static_cast<int>((count + per_page - 1) / per_page);
+
+    std::vector<SheetExercise> page(static_cast<std::size_t>(per_page));
+    Music::KeyIndex key = 0;
+    const auto start = Clock::now();
+
+    for (int number = 1; number <= pages; ++number) {
+        const long long first = static_cast<long long>(number - 1) * per_page;
+        page.resize(static_cast<std::size_t>(std::min(per_page, count - first)));
+        for (auto& exercise : page) {
+            exercises.next(exercise.notes, key, exercise.scale_name);
+            exercise.key_name = Music::pitchClassToName(key);
+            exercise.scale_notes = Music::computeScaleNotes(key, dict.getIntervals(exercise.scale_name));
+        }
+
+        const std::string file = pages > 1 ? numberedPath(path, number) : path;
+        std::ofstream out(file, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "No se pudo escribir " << file << std::endl;
+            return 1;
+        }
+        renderer.renderPage(out, page, number, pages);
+        if (!out) {
+            std::cerr << "Error de escritura en " << file << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << pages << " paginas (" << count << " ejercicios) en " << std::fixed << std::setprecision(1)
+              << elapsedMs(start) << " ms -> " << (pages > 1 ? numberedPath(path, 1) + " ..." : path) << std::endl;
+    return 0;
+}
+
+int commandRender(const Arguments& args) {
+    using namespace Guitar;
+
+    if (args.positional.empty()) {
+        std::cerr << "Uso: crazyfingers render <archivo.wav> [--count N | --book] [--tempo BPM] [--value 4|8|16]"
+                     " [--rate HZ] [--bits 16|24] [--split] [--threads T] [--seed S] [--key K] [--scale NOMBRE]"
+                  << std::endl;
+        return 1;
+    }
+    const std::string path = args.positional[0];
+
+    const auto instrument = parseInstrumentOptions(args);
+    if (!instrument) return 1;
+    const auto profile = parseProfileOptions(args);
+    if (!profile) return 1;
+
+    RenderOptions options;
+    options.sample_rate = static_cast<int>(args.getInt("rate", options.sample_rate));
+    options.bits = static_cast<int>(args.getInt("bits", options.bits));
+    options.tempo_bpm = static_cast<int>(args.getInt("tempo", options.tempo_bpm));
+    options.note_value = static_cast<int>(args.getInt("value", options.note_value));
+    if (!isValidRenderOptions(options)) {
+        std::cerr << "Audio invalido: --rate " << MIN_SAMPLE_RATE << "-" << MAX_SAMPLE_RATE
+                  << ", --bits 16 o 24, tempo 20-400 y --value 4, 8 o 16" << std::endl;
+        return 1;
+    }
+
+    ExerciseStream exercises;
+    if (!exercises.open(args, *instrument, *profile)) return 1;
+    // Pluck noise follows the exercise seed, so a rerun gives the same file
+    options.seed = exercises.getSeed();
+    const StringSynth synth(*instrument, options);
+
+    const long long count = exercises.size();
+    const bool split = args.has("split");
+    const std::uint64_t exercise_samples = synth.getExerciseLength(static_cast<std::size_t>(NUM_NOTES));
+    if (!fitsWavFile(split ? exercise_samples : exercise_samples * static_cast<std::uint64_t>(count), options.bits)) {
+        std::cerr << "El audio supera los 4 GB de un archivo WAV: use --split o menos ejercicios (--count)"
+                  << std::endl;
+        return 1;
+    }
+    const auto num_threads = static_cast<unsigned>(std::max(0LL, args.getInt("threads", 0)));
+    const unsigned workers = resolveThreads(num_threads);
+    const auto batch_size = static_cast<long long>(64 * workers);
+
+    std::vector<std::vector<Note>> batch;
+    std::vector<std::vector<float>> audio;
+    Music::KeyIndex key = 0;
+    std::string scale;
+    std::ofstream out;
+    std::size_t total_samples = 0;
+    const auto start = Clock::now();
+
+    auto open = [&](const std::string& file) {
+        out.open(file, std::ios::binary | std::ios::trunc);
+        if (!out) std::cerr << "No se pudo escribir " << file << std::endl;
+        // Sizes are patched once the samples are written
+        writeWavHeader(out, 0, options.sample_rate, options.bits);
+        return static_cast<bool>(out);
+    };
+    auto close = [&](std::size_t samples) {
+        out.seekp(0);
+        writeWavHeader(out, samples, options.sample_rate, options.bits);
+        out.close();
+        return !out.fail();
+    };
+
+    if (!split && !open(path)) return 1;
+    bool ok = true;
+    for (long long first = 0; first < count; first += batch_size) {
+        batch.resize(static_cast<std::size_t>(std::min(batch_size, count - first)));
+        for (auto& notes : batch) exercises.next(notes, key, scale);
+        renderExercises(synth, batch, static_cast<std::uint32_t>(first), num_threads, audio);
+
+        for (std::size_t i = 0; i < audio.size(); ++i) {
+            if (split && !open(numberedPath(path, first + static_cast<long long>(i) + 1))) return 1;
+            writeWavSamples(out, audio[i], options.bits);
+            total_samples += audio[i].size();
+            if (split) ok = close(audio[i].size()) && ok;
+        }
+    }
+    if (!split) ok = close(total_samples) && ok;
+
+    const double ms = elapsedMs(start);
+    const double seconds = static_cast<double>(total_samples) / options.sample_rate;
+    std::cout << "Renderizados " << count << " ejercicios (" << std::fixed << std::setprecision(1) << seconds
+              << " s de audio) en " << ms << " ms (" << std::setprecision(0) << seconds * 1000.0 / std::max(ms, 0.001)
+              << "x tiempo real) -> " << (split ? numberedPath(path, 1) + " ..." : path) << std::endl;
+    if (!ok) std::cerr << "Error de escritura" << std::endl;
+    return ok ? 0 : 1;
+}
+
+int commandPractice(const Arguments& args) {
+    using namespace Guitar;
+
+    const auto instrument = parseInstrumentOptions(args);
+    if (!instrument) return 1;
+    const auto profile = parseProfileOptions(args);
+    if (!profile) return 1;
+
+    PracticeOptions options;
+    options.tempo_bpm = static_cast<int>(args.getInt("tempo", options.tempo_bpm));
+    options.note_value = static_cast<int>(args.getInt("value", options.note_value));
+    options.count_in = static_cast<int>(args.getInt("count-in", options.count_in));
+    options.loops = static_cast<int>(args.getInt("loops", options.loops));
+    options.bell = !args.has("no-bell");
+    options.redraw = !args.has("plain");
+    options.click_path = args.get("click", "");
+    if (!isValidPracticeOptions(options)) {
+        std::cerr << "Uso: crazyfingers practice [--tempo " << MIN_PRACTICE_TEMPO << "-" << MAX_PRACTICE_TEMPO
+                  << "] [--value 4|8|16] [--count-in 0-" << MAX_COUNT_IN_BEATS << "] [--loops 1-"
+                  << MAX_PRACTICE_LOOPS << "] [--click archivo.wav|fifo] [--no-bell] [--plain]"
+                     " [--seed S] [--key K] [--scale NOMBRE]" << std::endl;
+        return 1;
+    }
+
+    // One exercise, practiced --loops times
+    ExerciseStream exercises;
+    if (!exercises.open(args, *instrument, *profile)) return 1;
+    std::vector<Note> notes;
+    Music::KeyIndex key = 0;
+    std::string scale;
+    exercises.next(notes, key, scale);
+
+    Formatter::printInstrumentInfo(*instrument);
+    std::cout << Music::pitchClassToName(key) << " " << scale << " - " << options.tempo_bpm << " BPM, 1/"
+              << options.note_value << std::endl << std::endl;
+
+    const auto jitter = runPractice(notes, *instrument, options);
+    if (!jitter) {
+        std::cerr << "No se pudo escribir " << options.click_path << std::endl;
+        return 1;
+    }
+    std::cout << std::endl << formatJitterReport(*jitter) << std::endl;
+    return 0;
+}
+
+int commandScore(const Arguments& args) {
+    using namespace Guitar;
+
+    const int note_value = static_cast<int>(args.getInt("value", 16));
+    const long long tempo = args.getInt("tempo", 0);
+    const int band = static_cast<int>(args.getInt("band", DEFAULT_SCORE_BAND));
+    if (args.positional.empty() || (note_value != 4 && note_value != 8 && note_value != 16) || tempo < 0 ||
+        band < 1) {
+        std::cerr << "Uso: crazyfingers score <toma.mid> [toma2.mid ...] [--exercise \"3:7 2:5 ...\" |"
+                     " --seed S --key K --scale NOMBRE] [--value 4|8|16] [--tempo BPM] [--band N] [--notes]"
+                  << std::endl;
+        return 1;
+    }
+
+    const auto instrument = parseInstrumentOptions(args);
+    if (!instrument) return 1;
+
+    // The exercise: given in compact notation, or regenerated as export does
+    std::vector<Note> exercise;
+    if (args.has("exercise")) {
+        if (!Formatter::parseCompact(args.get("exercise", ""), instrument->num_strings, exercise)) {
+            std::cerr << "Ejercicio invalido. Formato: \"cuerda:traste\" (ej: \"3:7 2:5 2:7\")" << std::endl;
+            return 1;
+        }
+    } else {
+        const auto profile = parseProfileOptions(args);
+        if (!profile) return 1;
+        ExerciseStream exercises;
+        if (!exercises.open(args, *instrument, *profile)) return 1;
+        Music::KeyIndex key = 0;
+        std::string scale;
+        exercises.next(exercise, key, scale);
+    }
+
+    // Without --tempo the grid follows the tempo of each take
+    const double seconds_per_note = tempo > 0 ? 60.0 / static_cast<double>(tempo) * 4.0 / note_value : 0.0;
+    PerformanceGrader grader(exercise, *instrument, note_value, seconds_per_note, band);
+    const bool details = args.has("notes") || args.positional.size() == 1;
+
+    PerformanceScore score;
+    int failed = 0;
+    double accuracy_sum = 0.0;
+    const auto start = Clock::now();
+
+    for (const auto& path : args.positional) {
+        std::ifstream in(path, std::ios::binary);
+        const auto take = in ? readMidiTake(in) : std::nullopt;
+        if (!take) {
+            std::cerr << path << ": no es un archivo MIDI valido" << std::endl;
+            ++failed;
+            continue;
+        }
+        if (!grader.grade(*take, score)) {
+            std::cerr << path << ": la toma no se alinea con el ejercicio (--band " << band << ")" << std::endl;
+            ++failed;
+            continue;
+        }
+        accuracy_sum += score.accuracy;
+
+        std::cout << path << ": " << score.correct << "/" << exercise.size() << " correctas, " << score.wrong
+                  << " equivocadas, " << score.missed << " omitidas, " << score.extra << " extra - precision "
+                  << std::fixed << std::setprecision(1) << score.accuracy << "%, desvio medio "
+                  << score.mean_deviation_ms << " ms, " << std::setprecision(0) << score.tempo_bpm << " BPM"
+                  << std::endl;
+        if (!details) continue;
+
+        for (std::size_t i = 0; i < exercise.size(); ++i) {
+            const NoteGrade& grade = score.notes[i];
+            std::cout << "  " << std::setw(3) << i + 1 << "  " << std::left << std::setw(6)
+                      << Formatter::formatCompact({exercise[i]}) << std::setw(5)
+                      << Music::midiToNoteName(exercise[i].getMidiPitch(*instrument)) << std::right;
+            if (grade.verdict == NoteVerdict::Missed) {
+                std::cout << "omitida" << std::endl;
+                continue;
+            }
+            std::cout << (grade.verdict == NoteVerdict::Correct ? "ok     " : "mal    ")
+                      << std::left << std::setw(5)
+                      << (grade.verdict == NoteVerdict::Wrong ? Music::midiToNoteName(grade.played_pitch) : "")
+                      << std::right << std::showpos << std::setprecision(1)
+                      << (std::abs(grade.deviation_ms) < 0.05 ? 0.0 : grade.deviation_ms)
+                      << std::noshowpos << " ms" << std::endl;
+        }
+    }
+
+    const double ms = elapsedMs(start);
+    const auto graded = static_cast<long long>(args.positional.size()) - failed;
+    if (args.positional.size() > 1) {
+        std::cout << graded << " tomas en " << std::fixed << std::setprecision(1) << ms << " ms ("
+                  << std::setprecision(0) << graded * 1000.0 / std::max(ms, 0.001) << " tomas/s), precision media "
+                  << std::setprecision(1) << (graded > 0 ? accuracy_sum / static_cast<double>(graded) : 0.0) << "%"
+                  << std::endl;
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+int commandTab(const Arguments& args) {
+    using namespace Guitar;
+
+    std::string text;
+    for (const auto& part : args.positional) {
+        text += part + " ";
+    }
+    if (args.has("file")) {
+        std::ifstream in(args.get("file", ""));
+        if (!in) {
+            std::cerr << "No se pudo abrir " << args.get("file", "") << std::endl;
+            return 1;
+        }
+        std::ostringstream content;
+        content << in.rdbuf();
+        text += content.str();
+    }
+    const auto melody = parseMelody(text);
+    if (!melody) {
+        std::cerr << "Uso: crazyfingers tab \"E4 G4 A4 64\" | --file melodia.txt [--compact]"
+                     " [--instrument guitar|bass] [--tuning T] [--capo N] [--profile P]"
+                     " (nombres con octava o numeros MIDI)" << std::endl;
+        return 1;
+    }
+
+    const auto instrument = parseInstrumentOptions(args);
+    if (!instrument) return 1;
+    const auto profile = parseProfileOptions(args);
+    if (!profile) return 1;
+
+    const Transcriber transcriber(*instrument, *profile);
+    for (std::size_t i = 0; i < melody->size(); ++i) {
+        if (!transcriber.canPlay((*melody)[i])) {
+            std::cerr << "La nota " << (i + 1) << " (" << Music::midiToNoteName((*melody)[i])
+                      << ") no existe en " << instrument->name << " (" << describeTuning(*instrument) << ")"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    const auto start = Clock::now();
+    const auto result = transcriber.transcribe(*melody);
+    const double ms = elapsedMs(start);
+
+    if (args.has("compact")) {
+        std::cout << Formatter::formatCompact(result->notes) << std::endl;
+    } else {
+        Formatter::printInstrumentInfo(*instrument);
+        const auto fingers = assignFingering(result->notes);
+        for (std::size_t first = 0; first < result->notes.size(); first += NUM_NOTES) {
+            const std::size_t last = std::min(result->notes.size(), first + NUM_NOTES);
+            std::cout << std::endl;
+            Formatter::printTablature(
+                toOwned(std::vector<Note>(result->notes.begin() + static_cast<std::ptrdiff_t>(first),
+                                          result->notes.begin() + static_cast<std::ptrdiff_t>(last))),
+                *instrument);
+            Formatter::printFingering(std::vector<std::uint8_t>(fingers.begin() + static_cast<std::ptrdiff_t>(first),
+                                                                fingers.begin() + static_cast<std::ptrdiff_t>(last)),
+                                      *instrument);
+        }
+    }
+
+    std::cerr << melody->size() << " notas, costo " << result->cost << ", " << std::fixed
+              << std::setprecision(3) << ms << " ms" << std::endl;
+    return 0;
+}
+
+int commandIndex(const Arguments& args) {
+    using namespace Guitar;
+
+    if (args.positional.empty()) {
+        std::cerr << "Uso: crazyfingers index <archivo> [--count N] [--instrument guitar|bass]"
+                     " [--tuning T] [--capo N] [--seed S] [--threads T] [--key K] [--scale NOMBRE]"
+                     " [--profile P]" << std::endl;
+        return 1;
+    }
+
+    const auto instrument = parseInstrumentOptions(args);
+    if (!instrument) return 1;
+    const auto profile = parseProfileOptions(args);
+    if (!profile) return 1;
+
+    CorpusSpec spec;
+    spec.instrument = *instrument;
+    spec.profile = *profile;
+    const long long count = args.getInt("count", spec.count);
+    if (count < 1 || count > std::numeric_limits<std::uint32_t>::max()) {
+        std::cerr << "Cantidad invalida: --count debe ser al menos 1" << std::endl;
+        return 1;
+    }
+    spec.count = static_cast<std::uint32_t>(count);
+    spec.base_seed = static_cast<std::uint32_t>(args.getInt("seed", spec.base_seed));
+    spec.num_threads = static_cast<unsigned>(args.getInt("threads", 0));
+
+    if (args.has("key")) {
+        spec.key = Music::parseKeyName(args.get("key", ""));
+        if (spec.key < 0) {
+            std::cerr << "Tonalidad invalida: " << args.get("key", "") << std::endl;
+            return 1;
+        }
+    }
+    if (args.has("scale")) {
+        spec.scale_name = args.get("scale", "");
+        if (!Music::ScaleDictionary::getInstance().hasScale(spec.scale_name)) {
+            std::cerr << "Escala desconocida: " << spec.scale_name << std::endl;
+            return 1;
+        }
+    }
+
+    const auto start = Clock::now();
+    SimilarityIndex index;
+    index.build(spec);
+    const double build_ms = elapsedMs(start);
+
+    if (!index.save(args.positional[0])) {
+        std::cerr << "No se pudo escribir " << args.positional[0] << std::endl;
+        return 1;
+    }
+
+    std::cout << "Indexados " << index.size() << " ejercicios en "
+              << std::fixed << std::setprecision(1) << build_ms << " ms -> "
+              << args.positional[0] << std::endl;
+    return 0;
+}
+
+int commandSimilar(const Arguments& args) {
+    using namespace Guitar;
+
+    if (args.positional.empty()) {
+        std::cerr << "Uso: crazyfingers similar \"<cuerda:traste> ...\" [--index archivo] [--top K]"
+                  << std::endl;
+        return 1;
+    }
+
+    const std::string index_path = args.get("index", "corpus.cfsim");
+    SimilarityIndex index;
+    if (!index.load(index_path)) {
+        std::cerr << "No se pudo leer el indice " << index_path
+                  << " (generelo con: crazyfingers index " << index_path << ")" << std::endl;
+        return 1;
+    }
+
+    const int num_strings = index.getInstrument().num_strings;
+    std::string exercise_text;
+    for (const auto& part : args.positional) {
+        exercise_text += part + " ";
+    }
+
+    std::vector<Note> exercise;
+    if (!Formatter::parseCompact(exercise_text, num_strings, exercise)) {
+        std::cerr << "Ejercicio invalido. Formato: \"cuerda:traste\" (ej: \"3:7 2:5 2:7\")" << std::endl;
+        return 1;
+    }
+
+    const auto start = Clock::now();
+    const auto matches = index.query(exercise, static_cast<int>(args.getInt("top", 10)));
+    const double query_ms = elapsedMs(start);
+
+    std::cout << matches.size() << " ejercicios similares (" << std::fixed << std::setprecision(3)
+              << query_ms << " ms sobre " << index.size() << ")" << std::endl;
+
+    for (std::size_t rank = 0; rank < matches.size(); ++rank) {
+        const auto& match = matches[rank];
+        std::cout << "\n#" << (rank + 1) << "  id " << match.id << "  similitud "
+                  << std::setprecision(2) << match.similarity << "  "
+                  << Music::pitchClassToName(index.getKey(match.id)) << " "
+                  << index.getScaleName(match.id) << std::endl;
+
+        const auto notes = index.getExercise(match.id);
+        std::cout << Formatter::formatCompact(notes) << std::endl;
+        if (rank == 0) {
+            Formatter::printTablature(toOwned(notes), index.getInstrument());
+            Formatter::printFingering(assignFingering(notes), index.getInstrument());
+        }
+    }
+
+    return 0;
+}
+
+// Generates `count` exercises with one generator type; returns ns/exercise and
+// folds every note into `checksum` so paths can be compared for identical output
+template<typename Generator>
+double timeGenerator(const Guitar::FretboardValidator& validator, long long count,
+                     std::uint32_t seed, std::uint64_t& checksum) {
+    Generator generator(validator, seed);
+    checksum = 0;
+
+    const auto start = Clock::now();
+    for (long long i = 0; i < count; ++i) {
+        const auto notes = generator.generateTablature();
+        for (const auto& note : notes) {
+            checksum = checksum * 31 + static_cast<std::uint64_t>(note->string_idx.value * 32 + note->fret.value);
+        }
+    }
+    return elapsedMs(start) * 1e6 / static_cast<double>(count);
+}
+
+void printBenchLine(const std::string& label, double ns_per_exercise) {
+    std::cout << "  " << std::left << std::setw(28) << label << std::right << std::fixed
+              << std::setprecision(0) << std::setw(10) << ns_per_exercise << " ns/ejercicio" << std::endl;
+}
+
+int commandAnalyze(const Arguments& args) {
+    using namespace Guitar;
+
+    const auto profile = parseProfileOptions(args);
+    if (!profile) return 1;
+
+    AnalysisSpec spec;
+    spec.profile = *profile;
+    spec.exercises = std::max(1LL, args.getInt("count", DEFAULT_ANALYSIS_COUNT));
+    spec.seed = static_cast<std::uint32_t>(args.getInt("seed", spec.seed));
+    spec.num_threads = static_cast<unsigned>(std::max(0LL, args.getInt("threads", 0)));
+
+    // Default sweep: guitar and bass, every key, every scale
+    if (args.has("instrument") || args.has("tuning")) {
+        const auto instrument = parseInstrumentOptions(args);
+        if (!instrument) return 1;
+        spec.instruments.push_back(*instrument);
+    } else {
+        spec.instruments = {getInstrumentConfig(InstrumentType::Guitar), getInstrumentConfig(InstrumentType::Bass)};
+    }
+
+    if (!parseSweepOptions(args, spec.keys, spec.scales)) return 1;
+
+    const AnalysisReport report = runAnalysis(spec);
+    const long long total = static_cast<long long>(report.combos.size()) * spec.exercises;
+    std::cout << "Analisis: " << spec.instruments.size() << " instrumento(s) x " << spec.keys.size()
+              << " tonalidad(es) x " << spec.scales.size() << " escala(s), " << spec.exercises
+              << " ejercicios c/u (" << total << ") en " << std::fixed << std::setprecision(1) << report.seconds
+              << " s (" << std::setprecision(0) << static_cast<double>(total) / std::max(report.seconds, 1e-9)
+              << " ejercicios/s), perfil " << describeProfile(spec.profile) << std::endl;
+    const WeightTable& table = WeightTable::getInstance();
+    if (!table.empty() && table.getBaseProfile() == spec.profile) {
+        std::cout << "Con pesos calibrados para " << table.size() << " escala(s); entre parentesis, los del perfil"
+                  << std::endl;
+    }
+    const RuleSet& rules = RuleSet::getInstance();
+    if (!rules.empty()) {
+        std::cout << "Con " << rules.size() << " regla(s):";
+        for (const auto& rule : rules.getRules()) std::cout << " " << rule << ";";
+        std::cout << std::endl;
+    }
+    const TransitionModel& model = TransitionModel::getInstance();
+    if (!model.empty()) {
+        std::cout << "Con modelo de transiciones (" << model.getNumStrings() << " cuerdas, " << model.getTransitions()
+                  << " transiciones): reemplaza los pesos por distancia en ese instrumento" << std::endl;
+    }
+
+    const auto intended = getIntendedDistanceShares(spec.profile);
+    auto share = [](long long part, long long whole) {
+        return whole > 0 ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+    };
+    for (std::size_t i = 0; i < spec.instruments.size(); ++i) {
+        const InstrumentConfig& instrument = spec.instruments[i];
+        const UsageHistogram& usage = report.usage[i];
+
+        GeneratorStats fallbacks;
+        long long out_of_scale = 0;
+        long long duplicates = 0;
+        for (const auto& combo : report.combos) {
+            if (combo.instrument != i) continue;
+            fallbacks.first_note_fallbacks += combo.generator.first_note_fallbacks;
+            fallbacks.nearest_fallbacks += combo.generator.nearest_fallbacks;
+            fallbacks.ultimate_fallbacks += combo.generator.ultimate_fallbacks;
+            fallbacks.rule_retries += combo.generator.rule_retries;
+            fallbacks.rule_failures += combo.generator.rule_failures;
+            out_of_scale += combo.out_of_scale;
+            duplicates += combo.duplicates;
+        }
+        long long same_string = 0;
+        for (const auto count : usage.same_string_class) same_string += count;
+        const int far_reach = farReach(spec.profile.position_box_radius);
+        const std::string far_label = far_reach > MIN_FAR_DISTANCE
+            ? std::to_string(MIN_FAR_DISTANCE) + "-" + std::to_string(far_reach) : std::to_string(MIN_FAR_DISTANCE);
+
+        std::cout << std::endl << instrument.name << " (" << describeTuning(instrument) << ")" << std::endl
+                  << std::setprecision(1) << "  Distancias   0-2 trastes " << share(usage.distance_class[0], usage.moves)
+                  << "% (pesos " << intended[0] << "%), 3 trastes " << share(usage.distance_class[1], usage.moves)
+                  << "% (" << intended[1] << "%), " << far_label << " trastes " << share(usage.distance_class[2], usage.moves)
+                  << "% (" << intended[2] << "%), mas de " << far_reach << " " << share(usage.distance_class[3], usage.moves) << "%"
+                  << std::endl
+                  << "  Misma cuerda " << share(same_string, usage.moves) << "% de los movimientos" << std::endl
+                  << "  Anclas       ";
+        for (int f = 0; f <= instrument.num_frets; ++f) {
+            const long long count = usage.anchor_fret[static_cast<std::size_t>(f)];
+            if (count > 0) std::cout << f << ":" << share(count, usage.exercises) << "% ";
+        }
+        std::cout << std::endl << std::setprecision(3)
+                  << "  Fallbacks    primera nota " << share(fallbacks.first_note_fallbacks, usage.exercises)
+                  << "% de los ejercicios, nota mas cercana " << share(fallbacks.nearest_fallbacks, usage.moves)
+                  << "% y ultimo recurso " << share(fallbacks.ultimate_fallbacks, usage.moves)
+                  << "% de los movimientos (" << out_of_scale << " notas fuera de escala)" << std::endl;
+        if (!rules.empty()) {
+            std::cout << "  Reglas       " << share(fallbacks.rule_retries, usage.exercises)
+                      << " reintentos cada 100 ejercicios, " << share(fallbacks.rule_failures, usage.exercises)
+                      << "% de los ejercicios no las cumplen" << std::endl;
+        }
+        std::cout << "  Duplicados   " << share(duplicates, usage.exercises) << "%" << std::endl << std::endl;
+        printUsageHeatmap(std::cout, usage, instrument);
+    }
+
+    // Combos whose rules leave the fewest candidates
+    std::vector<const ComboStats*> worst;
+    for (const auto& combo : report.combos) {
+        if (combo.generator.nearest_fallbacks + combo.generator.ultimate_fallbacks > 0) worst.push_back(&combo);
+    }
+    const auto fallbackRate = [](const ComboStats* combo) {
+        return combo->generator.nearest_fallbacks + combo->generator.ultimate_fallbacks;
+    };
+    std::sort(worst.begin(), worst.end(), [&](const ComboStats* a, const ComboStats* b) {
+        return fallbackRate(a) > fallbackRate(b);
+    });
+    if (!worst.empty()) std::cout << std::endl << "Mas fallbacks por movimiento:" << std::endl;
+    for (std::size_t i = 0; i < std::min<std::size_t>(worst.size(), 10); ++i) {
+        const ComboStats& combo = *worst[i];
+        std::cout << "  " << std::left << std::setw(18) << spec.instruments[combo.instrument].name << std::setw(4)
+                  << Music::pitchClassToName(combo.key) << std::setw(28) << combo.scale << std::right
+                  << std::setprecision(3) << share(fallbackRate(&combo), combo.generator.exercises * (NUM_NOTES - 1))
+                  << "%" << std::endl;
+    }
+
+    auto writeReport = [&](const std::string& option, auto writer) {
+        if (!args.has(option)) return true;
+        const std::string path = args.get(option, "");
+        std::ofstream out(path);
+        if (out) writer(out, report, spec);
+        if (!out) {
+            std::cerr << "No se pudo escribir " << path << std::endl;
+            return false;
+        }
+        std::cout << option << " -> " << path << std::endl;
+        return true;
+    };
+    const bool csv_ok = writeReport("csv", writeAnalysisCsv);
+    const bool json_ok = writeReport("json", writeAnalysisJson);
+    return csv_ok && json_ok ? 0 : 1;
+}
+
+int commandCalibrate(const Arguments& args) {
+    using namespace Guitar;
+
+    const auto profile = parseProfileOptions(args);
+    const auto instrument = parseInstrumentOptions(args);
+    if (!profile || !instrument) return 1;
+
+    CalibrationSpec spec;
+    spec.instrument = *instrument;
+    spec.profile = *profile;
+    spec.exercises = std::max(1LL, args.getInt("count", DEFAULT_CALIBRATION_COUNT));
+    spec.max_evaluations = static_cast<int>(std::max(1LL, args.getInt("evaluations", DEFAULT_CALIBRATION_EVALUATIONS)));
+    spec.seed = static_cast<std::uint32_t>(args.getInt("seed", spec.seed));
+    spec.num_threads = static_cast<unsigned>(std::max(0LL, args.getInt("threads", 0)));
+    if (args.has("target")) {
+        const auto target = parseDistanceTarget(args.get("target", ""));
+        if (!target) {
+            std::cerr << "Objetivo invalido: " << args.get("target", "")
+                      << " (tres porcentajes: 0-2 trastes, 3 trastes, 4 trastes; ej. 70,25,5)" << std::endl;
+            return 1;
+        }
+        spec.target.distance = *target;
+    }
+    if (args.has("same-string")) {
+        spec.target.same_string = static_cast<double>(args.getInt("same-string", -1));
+        if (spec.target.same_string < 0.0 || spec.target.same_string > 100.0) {
+            std::cerr << "--same-string debe ser un porcentaje 0-100" << std::endl;
+            return 1;
+        }
+    }
+
+    const auto& dict = Music::ScaleDictionary::getInstance();
+    std::vector<std::string> scales;
+    if (args.has("scale")) {
+        if (!dict.hasScale(args.get("scale", ""))) {
+            std::cerr << "Escala invalida: " << args.get("scale", "") << std::endl;
+            return 1;
+        }
+        scales.push_back(args.get("scale", ""));
+    } else {
+        scales = dict.getAllScaleNames();
+    }
+
+    // Re-calibrating some scales keeps the other lines of the same profile
+    const std::string path = args.positional.empty() ? DEFAULT_WEIGHT_TABLE : args.positional[0];
+    WeightTable table(spec.profile);
+    WeightTable previous;
+    if (std::ifstream(path) && previous.load(path) && previous.getBaseProfile() == spec.profile) {
+        table = previous;
+    }
+
+    std::cout << "Calibrando " << scales.size() << " escala(s) en " << spec.instrument.name << ", objetivo "
+              << std::fixed << std::setprecision(1) << spec.target.distance[0] << "/" << spec.target.distance[1]
+              << "/" << spec.target.distance[2] << "%";
+    if (spec.target.same_string >= 0.0) std::cout << ", misma cuerda " << spec.target.same_string << "%";
+    std::cout << " (" << spec.exercises << " ejercicios por evaluacion)" << std::endl;
+
+    const auto start = Clock::now();
+    double worst_error = 0.0;
+    for (std::size_t i = 0; i < scales.size(); ++i) {
+        const ScaleCalibration fit = calibrateScale(spec, scales[i]);
+        table.set(fit.scale, fit.weights);
+        worst_error = std::max(worst_error, fit.error);
+        std::cout << "  [" << (i + 1) << "/" << scales.size() << "] " << std::left << std::setw(28) << fit.scale
+                  << std::right << std::setw(4) << fit.weights.weight_close << std::setw(4)
+                  << fit.weights.weight_medium << std::setw(4) << fit.weights.weight_far << std::setw(5)
+                  << fit.weights.same_string_bonus << "%  -> " << fit.realized[0] << "/" << fit.realized[1] << "/"
+                  << fit.realized[2] << "%, misma cuerda " << fit.same_string << "% (error " << std::setprecision(2)
+                  << fit.error << ", " << fit.evaluations << " simulaciones)" << std::setprecision(1) << std::endl;
+    }
+
+    std::ofstream out(path);
+    if (out) {
+        out << "# Crazy Fingers - pesos calibrados para " << spec.instrument.name << ", objetivo "
+            << spec.target.distance[0] << "/" << spec.target.distance[1] << "/" << spec.target.distance[2] << "%";
+        if (spec.target.same_string >= 0.0) out << ", misma cuerda " << spec.target.same_string << "%";
+        out << "\n";
+        table.write(out);
+    }
+    if (!out) {
+        std::cerr << "No se pudo escribir " << path << std::endl;
+        return 1;
+    }
+    std::cout << "Tabla de " << table.size() << " escala(s) -> " << path << " en " << std::setprecision(1)
+              << elapsedMs(start) / 1000.0 << " s (error maximo " << std::setprecision(2) << worst_error
+              << " puntos)" << std::endl;
+    return 0;
+}
+
+int commandVerify(const Arguments& args) {
+    using namespace Guitar;
+
+    const auto profile = parseProfileOptions(args);
+    const auto instrument = parseInstrumentOptions(args);
+    if (!profile || !instrument) return 1;
+
+    VerifySpec spec;
+    spec.instrument = *instrument;
+    spec.profile = *profile;
+    spec.exercises = std::max(1LL, args.getInt("count", DEFAULT_VERIFY_COUNT));
+    spec.seed = static_cast<std::uint32_t>(args.getInt("seed", spec.seed));
+    spec.num_threads = static_cast<unsigned>(std::max(0LL, args.getInt("threads", 0)));
+    if (!parseSweepOptions(args, spec.keys, spec.scales)) return 1;
+
+    const VerifyReport report = runVerification(spec);
+    std::cout << "Verificados " << report.exercises << " ejercicios de " << spec.instrument.name << " ("
+              << spec.keys.size() << " tonalidad(es) x " << spec.scales.size() << " escala(s), semillas "
+              << spec.seed << "-" << spec.seed + static_cast<std::uint32_t>(report.exercises - 1) << ") en "
+              << std::fixed << std::setprecision(1) << report.seconds << " s ("
+              << std::setprecision(0) << static_cast<double>(report.exercises) / std::max(report.seconds, 1e-9)
+              << " ejercicios/s)" << std::endl;
+
+    const std::string flags = forwardGeneratorOptions(args);
+    for (int v = 0; v < NUM_INVARIANTS; ++v) {
+        const ViolationReport& violation = report.violations[static_cast<std::size_t>(v)];
+        std::cout << "  " << std::left << std::setw(17) << getInvariantName(static_cast<Invariant>(v)) << std::right;
+        if (violation.count == 0) {
+            std::cout << "OK" << std::endl;
+            continue;
+        }
+        std::cout << "FALLA en " << violation.count << " ejercicio(s) (" << std::setprecision(4)
+                  << 100.0 * static_cast<double>(violation.count) / static_cast<double>(report.exercises) << "%)"
+                  << std::endl
+                  << "    Primera: semilla " << violation.seed << ", " << Music::pitchClassToName(violation.key) << " "
+                  << violation.scale << ", nota " << (violation.note_index + 1) << ": "
+                  << Formatter::formatCompact(violation.notes) << std::endl
+                  << "    Reproducir: crazyfingers generate" << flags << " --key " << Music::pitchClassToName(violation.key)
+                  << " --scale \"" << violation.scale << "\" --seed " << violation.seed << std::endl;
+    }
+
+    if (report.isClean()) {
+        std::cout << "Todas las invariantes se cumplen" << std::endl;
+        return 0;
+    }
+    std::cout << report.violating_exercises << " ejercicio(s) violan alguna invariante" << std::endl;
+    return 2;
+}
+
+int commandLint(const Arguments& args) {
+    using namespace Guitar;
+
+    if (args.positional.empty()) {
+        std::cerr << "Uso: crazyfingers lint <archivo...> [--key K [--scale NOMBRE]] [--profile P] [--threads T]"
+                     " [--notes]" << std::endl;
+        return 1;
+    }
+
+    const auto profile = parseProfileOptions(args);
+    if (!profile) return 1;
+
+    TabLintOptions options;
+    options.profile = *profile;
+    options.num_threads = static_cast<unsigned>(std::max(0LL, args.getInt("threads", 0)));
+    if (args.has("key") || args.has("scale")) {
+        const int key = Music::parseKeyName(args.get("key", "C"));
+        const std::string scale = args.get("scale", "Major");
+        if (key < 0) {
+            std::cerr << "Tonalidad invalida: " << args.get("key", "") << std::endl;
+            return 1;
+        }
+        if (!Music::ScaleDictionary::getInstance().hasScale(scale)) {
+            std::cerr << "Escala desconocida: " << scale << std::endl;
+            return 1;
+        }
+        options.scale_mask = buildScaleMask(static_cast<Music::KeyIndex>(key), scale);
+    }
+
+    const auto start = Clock::now();
+    const std::vector<TabFileResult> results = lintTabFiles(args.positional, options);
+    const double seconds = elapsedMs(start) / 1000.0;
+
+    static constexpr std::array<const char*, 3> SEVERITY = {"error", "aviso", "regla"};
+    std::array<long long, 3> counts{};
+    std::size_t bytes = 0;
+    std::size_t tabs = 0;
+    std::size_t notes = 0;
+    const auto& instruments = getTabInstruments();
+
+    for (const auto& result : results) {
+        if (!result.readable) {
+            std::cerr << result.path << ": error: no se pudo leer el archivo" << std::endl;
+            ++counts[0];
+            continue;
+        }
+        bytes += result.bytes;
+        tabs += result.tabs.size();
+        notes += result.notes.size();
+        for (const auto& diagnostic : result.diagnostics) {
+            const auto severity = static_cast<std::size_t>(diagnostic.severity);
+            ++counts[severity];
+            std::cout << result.path << ":" << diagnostic.line;
+            if (diagnostic.column > 0) std::cout << ":" << diagnostic.column;
+            std::cout << ": " << SEVERITY[severity] << ": " << diagnostic.message << "\n";
+        }
+        if (!args.has("notes")) continue;
+        for (const auto& tab : result.tabs) {
+            if (tab.instrument < 0) continue;
+            const InstrumentConfig& instrument = instruments[static_cast<std::size_t>(tab.instrument)];
+            std::cout << result.path << ":" << tab.first_line << ": " << instrument.name << " ("
+                      << instrument.tuning_name << (tab.labels_matched ? "" : ", por cuerdas") << "): "
+                      << Formatter::formatCompact(std::vector<Note>(result.notes.begin() + tab.first_note,
+                                                                    result.notes.begin() + tab.first_note +
+                                                                        tab.num_notes))
+                      << "\n";
+        }
+    }
+
+    const double megabytes = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    std::cerr << results.size() << " archivo(s), " << std::fixed << std::setprecision(1) << megabytes << " MB, "
+              << tabs << " tablatura(s), " << notes << " nota(s) en " << std::setprecision(3) << seconds << " s ("
+              << std::setprecision(0) << megabytes / std::max(seconds, 1e-9) << " MB/s): " << counts[0]
+              << " error(es), " << counts[1] << " aviso(s), " << counts[2] << " regla(s) violada(s)" << std::endl;
+    return counts[0] + counts[2] > 0 ? 2 : 0;
+}
+
+int commandTrain(const Arguments& args) {
+    using namespace Guitar;
+
+    if (args.positional.empty()) {
+        std::cerr << "Uso: crazyfingers train <archivo...> [--out " << DEFAULT_TRANSITION_MODEL
+                  << "] [--instrument P] [--threads T]" << std::endl;
+        return 1;
+    }
+    const auto instrument = parseInstrumentOptions(args);
+    if (!instrument) return 1;
+
+    TrainingSpec spec;
+    spec.num_strings = instrument->num_strings;
+    spec.num_threads = static_cast<unsigned>(std::max(0LL, args.getInt("threads", 0)));
+    const TrainingReport report = trainTransitions(args.positional, spec);
+    if (report.unreadable_files > 0) {
+        std::cerr << report.unreadable_files << " archivo(s) no se pudieron leer" << std::endl;
+    }
+    if (report.counts.getTransitions() == 0) {
+        std::cerr << "Ninguna tablatura de " << spec.num_strings << " cuerdas con notas para entrenar" << std::endl;
+        return 1;
+    }
+
+    const auto build_start = Clock::now();
+    const TransitionModel model(report.counts, spec.num_strings);
+    const double build_ms = elapsedMs(build_start);
+    const std::string path = args.get("out", DEFAULT_TRANSITION_MODEL);
+    if (!model.save(path)) {
+        std::cerr << "No se pudo escribir " << path << std::endl;
+        return 1;
+    }
+
+    // Reload as generate would, to report what startup pays
+    TransitionModel loaded;
+    const auto load_start = Clock::now();
+    const bool reloaded = loaded.load(path);
+    const double load_us = elapsedMs(load_start) * 1000.0;
+
+    const double megabytes = static_cast<double>(report.bytes) / (1024.0 * 1024.0);
+    std::cout << report.files << " archivo(s), " << std::fixed << std::setprecision(1) << megabytes << " MB, "
+              << report.tabs << " tablatura(s) (" << report.skipped_tabs << " de otro instrumento) en "
+              << std::setprecision(3) << report.seconds << " s (" << std::setprecision(0)
+              << megabytes / std::max(report.seconds, 1e-9) << " MB/s)" << std::endl;
+    std::cout << report.counts.getTransitions() << " transiciones en " << report.counts.getSequences()
+              << " secuencia(s) -> " << model.size() << " entradas (" << std::setprecision(1) << build_ms
+              << " ms)" << std::endl;
+    std::cout << "Modelo de " << spec.num_strings << " cuerdas guardado en " << path;
+    if (reloaded) std::cout << " (carga: " << std::setprecision(0) << load_us << " us)";
+    std::cout << std::endl;
+    return reloaded ? 0 : 1;
+}
+
+int commandBench(const Arguments& args) {
+    using namespace Guitar;
+
+    const auto instrument = parseInstrumentOptions(args);
+    if (!instrument) return 1;
+    const auto profile = parseProfileOptions(args);
+    if (!profile) return 1;
+
+    const int key = Music::parseKeyName(args.get("key", "C"));
+    const std::string scale = args.get("scale", "Major");
+    if (key < 0 || !Music::ScaleDictionary::getInstance().hasScale(scale)) {
+        std::cerr << "Tonalidad o escala invalida" << std::endl;
+        return 1;
+    }
+
+    Music::ScaleManager scale_mgr;
+    scale_mgr.setKeyAndScale(static_cast<Music::KeyIndex>(key), scale);
+    FretboardValidator validator(scale_mgr, *instrument);
+
+    const long long count = std::max(1LL, args.getInt("count", 200000));
+    const auto seed = static_cast<std::uint32_t>(args.getInt("seed", 1));
+
+    std::cout << "Benchmark: " << count << " ejercicios, " << instrument->name << " ("
+              << describeTuning(*instrument) << "), " << scale_mgr.getFullDescription()
+              << ", perfil " << describeProfile(*profile) << " (lotes)" << std::endl;
+
+    // Layout specialization: static layout vs. the table-driven dynamic path
+    std::uint64_t dynamic_sum = 0;
+    const double dynamic_ns = timeGenerator<LayoutNoteGenerator<DynamicLayout>>(validator, count, seed, dynamic_sum);
+    printBenchLine("DynamicLayout", dynamic_ns);
+
+    std::uint64_t static_sum = 0;
+    double static_ns = 0.0;
+    if (isStandardGuitar(*instrument)) {
+        static_ns = timeGenerator<LayoutNoteGenerator<GuitarLayout>>(validator, count, seed, static_sum);
+        printBenchLine("GuitarLayout (constexpr)", static_ns);
+    } else if (isStandardBass(*instrument)) {
+        static_ns = timeGenerator<LayoutNoteGenerator<BassLayout>>(validator, count, seed, static_sum);
+        printBenchLine("BassLayout (constexpr)", static_ns);
+    }
+
+    if (static_ns > 0.0) {
+        std::cout << "  Aceleracion: " << std::setprecision(2) << dynamic_ns / static_ns << "x, salida "
+                  << (static_sum == dynamic_sum ? "identica" : "DISTINTA") << std::endl;
+    }
+
+    // Profile specialization: the standard rules as constants vs. read at runtime
+    std::uint64_t profile_sum = 0;
+    const double profile_ns = timeGenerator<LayoutNoteGenerator<DynamicLayout, DynamicProfile>>(
+        validator, count, seed, profile_sum);
+    printBenchLine("DynamicProfile (standard)", profile_ns);
+    std::cout << "  Costo del perfil en tiempo de ejecucion: " << std::showpos << std::setprecision(1)
+              << (profile_ns / dynamic_ns - 1.0) * 100.0 << std::noshowpos << "%, salida "
+              << (profile_sum == dynamic_sum ? "identica" : "DISTINTA") << std::endl;
+
+    // Batch path: one exercise per SIMD lane, every backend this CPU runs.
+    // It applies the profile only: loaded weights, model or rules are named
+    std::string skipped;
+    auto skip = [&skipped](bool loaded, const char* what) {
+        if (loaded) skipped += (skipped.empty() ? "" : ", ") + std::string(what);
+    };
+    skip(!WeightTable::getInstance().empty(), "pesos calibrados");
+    skip(TransitionModel::getInstance().appliesTo(instrument->num_strings), "modelo de transiciones");
+    skip(!RuleSet::getInstance().empty(), "reglas");
+    if (!skipped.empty()) {
+        std::cout << "  Los lotes usan solo el perfil, sin: " << skipped << std::endl;
+    }
+    const double scalar_ns = static_ns > 0.0 ? std::min(static_ns, dynamic_ns) : dynamic_ns;
+    const std::vector<std::uint16_t> masks(static_cast<std::size_t>(count), validator.getScaleMask());
+    std::vector<Note> batch;
+    batch.reserve(masks.size() * NUM_NOTES);
+
+    std::uint64_t reference_sum = 0;
+    bool batches_match = true;
+    double best_batch_ns = 0.0;
+    for (const auto backend : {BatchBackend::Scalar, BatchBackend::Avx2, BatchBackend::Avx512}) {
+        if (!isBatchBackendSupported(backend)) continue;
+
+        const BatchGenerator generator(*instrument, *profile, backend);
+        batch.clear();
+        const auto start = Clock::now();
+        generator.generate(masks, seed, batch);
+        const double batch_ns = elapsedMs(start) * 1e6 / static_cast<double>(count);
+
+        std::uint64_t batch_sum = 0;
+        for (const auto& note : batch) {
+            batch_sum = batch_sum * 31 + static_cast<std::uint64_t>(note.string_idx.value * 32 + note.fret.value);
+        }
+        if (backend == BatchBackend::Scalar) reference_sum = batch_sum;
+        batches_match = batches_match && batch_sum == reference_sum;
+        best_batch_ns = batch_ns;
+
+        printBenchLine(std::string("Lote ") + getBatchBackendName(backend) + " (" +
+                       std::to_string(getBatchLaneCount(backend)) + " carriles)", batch_ns);
+    }
+
+    std::cout << "  Lote vs generateTablature: " << std::setprecision(2) << scalar_ns / best_batch_ns
+              << "x, backends " << (batches_match ? "identicos" : "DISTINTOS") << std::endl;
+
+    // Fingering: one Viterbi pass per exercise of the last batch
+    FingeringEngine fingering;
+    std::vector<std::uint8_t> fingers;
+    long long fingering_cost = 0;
+    const std::span<const Note> exercises(batch);
+    const auto fingering_start = Clock::now();
+    for (std::size_t i = 0; i + NUM_NOTES <= exercises.size(); i += NUM_NOTES) {
+        fingering_cost += fingering.assign(exercises.subspan(i, NUM_NOTES), fingers);
+    }
+    printBenchLine("Digitacion (Viterbi)", elapsedMs(fingering_start) * 1e6 / static_cast<double>(count));
+    std::cout << "  Costo medio de digitacion: " << std::setprecision(1)
+              << static_cast<double>(fingering_cost) / static_cast<double>(count) << std::endl;
+
+    // Difficulty: score the same batch, then steer generation into a band around its mean
+    const DifficultyScorer scorer(*instrument);
+    double difficulty_sum = 0.0;
+    const auto score_start = Clock::now();
+    for (std::size_t i = 0; i + NUM_NOTES <= exercises.size(); i += NUM_NOTES) {
+        difficulty_sum += scorer.score(exercises.subspan(i, NUM_NOTES), validator.getScaleMask()).total;
+    }
+    printBenchLine("Puntaje de dificultad", elapsedMs(score_start) * 1e6 / static_cast<double>(count));
+
+    const auto mean = static_cast<float>(difficulty_sum / static_cast<double>(count));
+    const DifficultyBand band{mean - 3.0f, mean + 3.0f};
+    TargetedGenerator targeted(validator, band, seed);
+    std::vector<Note> targeted_notes;
+    const auto targeted_start = Clock::now();
+    for (long long i = 0; i < count; ++i) {
+        targeted.generate(targeted_notes);
+    }
+    const double targeted_ns = elapsedMs(targeted_start) * 1e6 / static_cast<double>(count);
+    printBenchLine("Generacion dirigida", targeted_ns);
+    std::cout << "  Banda " << std::setprecision(0) << band.min << "-" << band.max << ": " << std::setprecision(2)
+              << static_cast<double>(targeted.getAttempts()) / static_cast<double>(count)
+              << " intentos/ejercicio, " << targeted_ns / scalar_ns << "x generateTablature, "
+              << std::setprecision(1) << 100.0 * static_cast<double>(targeted.getMisses()) / static_cast<double>(count)
+              << "% fuera" << std::endl;
+
+    // Voicings: every table for this instrument, then triad exercises in the benchmark scale
+    const auto all_scales = Music::ScaleDictionary::getInstance().getAllScaleNames();
+    std::size_t shapes = 0;
+    const auto tables_start = Clock::now();
+    for (const auto& name : all_scales) {
+        for (int k = 0; k < Music::NUM_KEYS; ++k) {
+            Music::ScaleManager table_scale;
+            table_scale.setKeyAndScale(static_cast<Music::KeyIndex>(k), name);
+            const FretboardValidator table_validator(table_scale, *instrument);
+            for (const auto type : {VoicingType::Thirds, VoicingType::Sixths, VoicingType::Triads}) {
+                shapes += VoicingTable(table_validator, type).getVoicings().size();
+            }
+        }
+    }
+    std::cout << "  Tablas de voicings: " << std::setprecision(1) << elapsedMs(tables_start) << " ms ("
+              << all_scales.size() * Music::NUM_KEYS * 3 << " tablas, " << shapes << " formas)" << std::endl;
+
+    const VoicingTable triads(validator, VoicingType::Triads);
+    VoicingGenerator voicing_gen(triads, *instrument, *profile, seed);
+    std::vector<Voicing> voicings;
+    const auto voicing_start = Clock::now();
+    for (long long i = 0; i < count; ++i) {
+        voicing_gen.generate(voicings);
+    }
+    printBenchLine("Voicings (triadas)", elapsedMs(voicing_start) * 1e6 / static_cast<double>(count));
+
+    return 0;
+}
+
+int commandFit(const Arguments& args) {
+    using namespace Music;
+
+    std::string notes_text;
+    for (const auto& part : args.positional) {
+        notes_text += part + " ";
+    }
+    const auto query = parsePitchClassSet(notes_text);
+    if (!query) {
+        std::cerr << "Uso: crazyfingers fit \"C E G Bb\" [--top K] [--min N]"
+                     " (nombres de nota o 0-11)" << std::endl;
+        return 1;
+    }
+
+    const ScaleFinder finder;
+    const auto top = static_cast<std::size_t>(std::max(1LL, args.getInt("top", 10)));
+    const int query_size = std::popcount(static_cast<unsigned>(*query));
+
+    const auto start = Clock::now();
+    auto matches = args.has("min")
+        ? finder.findPartial(*query, static_cast<int>(args.getInt("min", query_size)), top)
+        : finder.find(*query, top);
+    const bool partial = !args.has("min") && matches.empty();
+    if (partial) matches = finder.findPartial(*query, query_size - 1, top);
+    const double query_ms = elapsedMs(start);
+
+    std::cout << "Notas: " << describePitchClassSet(*query) << " (" << std::fixed << std::setprecision(3)
+              << query_ms << " ms sobre " << finder.getScaleCount() * NUM_KEYS << " pares)" << std::endl;
+    if (partial) std::cout << "Ninguna escala las contiene todas; coincidencias parciales:" << std::endl;
+
+    for (const auto& match : matches) {
+        const std::string name = pitchClassToName(match.key) + " " + finder.getScaleName(match.scale);
+        std::cout << "  " << std::left << std::setw(32) << name << std::right
+                  << match.matched << "/" << query_size << "  +" << match.extra << "  ("
+                  << describePitchClassSet(finder.getMask(match.key, match.scale)) << ")" << std::endl;
+    }
+    return 0;
+}
+
+int commandScales(const Arguments& args) {
+    const auto& dict = Music::ScaleDictionary::getInstance();
+    const std::string only = args.get("category", "");
+
+    for (const auto& category : dict.getCategoryNames()) {
+        if (!only.empty() && category != only) continue;
+        std::cout << category << std::endl;
+        for (const auto& name : dict.getScalesByCategory(category)) {
+            std::cout << "  [" << dict.getScaleId(name).value_or(0) << "] " << name << ": "
+                      << Music::computeScaleNotes(0, dict.getIntervals(name)) << std::endl;
+        }
+    }
+
+    const auto errors = dict.getScaleFileErrors();
+    for (const auto& error : errors) {
+        std::cerr << error.path << ":" << error.line << ": " << error.reason << std::endl;
+    }
+    return errors.empty() ? 0 : 1;
+}
+
+struct Command {
+    const char* name;
+    const char* summary;
+    int (*handler)(const Arguments&);
+};
+
+constexpr std::array<Command, 18> COMMANDS = {{
+    {"analyze",  "Estadisticas Monte Carlo del generador (CSV/JSON, mapa de calor)", commandAnalyze},
+    {"bench",    "Mide el rendimiento de las rutas de generacion",                  commandBench},
+    {"book",     "Una escala en las 12 tonalidades (--scale, --key base, --seed)",  commandBook},
+    {"calibrate", "Ajusta los pesos por escala a una distribucion de distancias", commandCalibrate},
+    {"export",   "Exporta ejercicios a MIDI (.mid) o MusicXML (.musicxml)",         commandExport},
+    {"fit",      "Escalas y tonalidades que contienen unas notas (\"C E G Bb\")",  commandFit},
+    {"generate", "Genera ejercicios (--instrument, --tuning, --capo, --key, --scale)", commandGenerate},
+    {"index",   "Genera e indexa un corpus de ejercicios (LSH)", commandIndex},
+    {"lint",    "Lee tablaturas ASCII y las revisa con las reglas del generador", commandLint},
+    {"practice", "Practica un ejercicio con metronomo y cursor sobre la tab", commandPractice},
+    {"render",  "Sintetiza ejercicios a WAV (cuerdas Karplus-Strong)", commandRender},
+    {"score",   "Califica tomas MIDI contra el ejercicio (notas, tiempos)", commandScore},
+    {"scales",  "Lista las escalas y valida los archivos de --scales", commandScales},
+    {"sheet",   "Hojas de practica en SVG (N ejercicios por pagina)",  commandSheet},
+    {"similar", "Busca ejercicios similares en un indice",       commandSimilar},
+    {"tab",     "Transcribe una melodia (notas o MIDI) a tablatura", commandTab},
+    {"train",   "Aprende los pesos de movimiento de un corpus de tablaturas ASCII", commandTrain},
+    {"verify",   "Verifica las invariantes sobre millones de ejercicios (codigo 2 si falla)", commandVerify},
+}};
+
+void printUsage() {
+    std::cout << "Uso: crazyfingers [comando] [opciones]" << std::endl;
+    std::cout << "Sin comando se abre el menu interactivo." << std::endl;
+    std::cout << "Todos los comandos aceptan --scales <archivo> con escalas propias y --weights <archivo>" << std::endl;
+    std::cout << "con pesos calibrados (por defecto " << Guitar::DEFAULT_WEIGHT_TABLE << " si existe; --no-weights lo ignora)."
+              << std::endl;
+    std::cout << "Igual con --model <archivo> (por defecto " << Guitar::DEFAULT_TRANSITION_MODEL
+              << " si existe; --no-model lo ignora)" << std::endl;
+    std::cout << "y con --rules <archivo> / --rule \"only string 2-5; end root\" (por defecto "
+              << Guitar::DEFAULT_RULE_FILE << " si existe; --no-rules las ignora)." << std::endl << std::endl;
+    for (const auto& command : COMMANDS) {
+        std::cout << "  " << std::left << std::setw(10) << command.name << command.summary << std::endl;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Entry Point
+// ============================================================================
+
+int run(int argc, char* argv[]) {
+    const std::string name = argc > 1 ? argv[1] : "";
+
+    for (const auto& command : COMMANDS) {
+        if (name == command.name) {
+            const Arguments args = parseArguments(argc, argv, 2);
+            if (!loadUserScales(args)) return 1;
+            // calibrate simulates candidate weights, never the table's
+            if (name != "calibrate" && !loadWeightTable(args)) return 1;
+            // train builds a model; calibrate, as above, measures the profile
+            if (name != "calibrate" && name != "train" && !loadTransitionModel(args)) return 1;
+            if (name != "calibrate" && name != "train" && !loadRules(args)) return 1;
+            return command.handler(args);
+        }
+    }
+
+    printUsage();
+    return (name == "help" || name == "--help") ? 0 : 1;
+}
+
+} // namespace Cli
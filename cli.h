@@ -0,0 +1,61 @@
+#ifndef CLI_H
+#define CLI_H
+
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "fretboard.h"
+#include "generator.h"
+
+namespace Cli {
+
+// ============================================================================
+// Parsed Arguments - positionals plus "--name value" options
+// ============================================================================
+
+struct Arguments {
+    std::vector<std::string> positional;
+    std::unordered_map<std::string, std::string> options;  // "--flag" alone stores "true"
+
+    [[nodiscard]] bool has(const std::string& name) const;
+    [[nodiscard]] std::string get(const std::string& name, const std::string& fallback) const;
+    [[nodiscard]] long long getInt(const std::string& name, long long fallback) const;
+};
+
+[[nodiscard]] Arguments parseArguments(int argc, char* argv[], int first);
+
+// Instrument from "--instrument <preset>" (default guitar) refined by
+// "--tuning \"D2 A2 D3 G3 B3 E4\"", "--frets N" and "--capo N"
+// Prints the problem and returns std::nullopt on invalid options
+[[nodiscard]] std::optional<Guitar::InstrumentConfig> parseInstrumentOptions(const Arguments& args);
+
+// Generator rules from "--profile <standard|beginner|advanced|file>" refined
+// by one flag per config key ("--box-radius 3", "--weight-far 0", ...)
+// Prints the problem and returns std::nullopt on invalid options
+[[nodiscard]] std::optional<Guitar::GeneratorProfile> parseProfileOptions(const Arguments& args);
+
+// Per-scale weights for every generator: "--weights <file>", else
+// DEFAULT_WEIGHT_TABLE when it exists ("--no-weights" skips both). False
+// only when an explicit --weights file cannot be read.
+[[nodiscard]] bool loadWeightTable(const Arguments& args);
+
+// Learned move weights: "--model <file>", else DEFAULT_TRANSITION_MODEL
+// when it exists ("--no-model" skips both). False only when an explicit
+// --model file cannot be read.
+[[nodiscard]] bool loadTransitionModel(const Arguments& args);
+
+// Exercise rules (see RuleSet): "--rules <file>" and/or "--rule \"a; b\"",
+// else DEFAULT_RULE_FILE when it exists ("--no-rules" skips all of them).
+// Prints every bad rule and returns false when an explicit source has any.
+[[nodiscard]] bool loadRules(const Arguments& args);
+
+// ============================================================================
+// Entry Point - non-interactive subcommands ("crazyfingers <command> ...")
+// ============================================================================
+
+[[nodiscard]] int run(int argc, char* argv[]);
+
+} // namespace Cli
+
+#endif // CLI_H
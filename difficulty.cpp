@@ -0,0 +1,251 @@
+#include "difficulty.h"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+
+namespace Guitar {
+
+namespace {
+
+// ============================================================================
+// Constants - Score Weights (sum to 1)
+// ============================================================================
+
+constexpr float WEIGHT_STRETCH = 0.30f;
+constexpr float WEIGHT_SKIPS = 0.15f;
+constexpr float WEIGHT_RUNS = 0.10f;
+constexpr float WEIGHT_RANGE = 0.15f;
+constexpr float WEIGHT_POSITION = 0.10f;
+constexpr float WEIGHT_SCALE = 0.20f;
+
+constexpr float FULL_STRETCH = 3.0f;     // Extra frets per move that count as 1
+constexpr float FULL_SKIP = 2.0f;        // Strings skipped per move that count as 1
+constexpr float FULL_RANGE = 24.0f;      // Semitones
+constexpr float FULL_HEIGHT = 15.0f;     // Mean fret
+
+// Ends of the level ramp: tighter than BEGINNER_PROFILE, looser than ADVANCED_PROFILE
+constexpr GeneratorProfile EASIEST_PROFILE{
+    .position_box_radius = 2,
+    .max_local_range = 7,
+    .max_global_range = 12,
+    .local_window_size = LOCAL_WINDOW_SIZE,
+    .weight_close = 90,
+    .weight_medium = 8,
+    .weight_far = 2,
+    .max_consecutive_same_string = 4,
+    .same_string_bonus = 200,
+};
+
+constexpr GeneratorProfile HARDEST_PROFILE{
+    .position_box_radius = MAX_PROFILE_BOX_RADIUS,
+    .max_local_range = 24,
+    .max_global_range = 36,
+    .local_window_size = LOCAL_WINDOW_SIZE,
+    .weight_close = 20,
+    .weight_medium = 40,
+    .weight_far = 40,
+    .max_consecutive_same_string = 1,
+    .same_string_bonus = 50,
+};
+
+float clampUnit(float value) noexcept {
+    return std::clamp(value, 0.0f, 1.0f);
+}
+
+int interpolate(int easy, int hard, int level) noexcept {
+    return easy + ((hard - easy) * level + (NUM_DIFFICULTY_LEVELS - 1) / 2) / (NUM_DIFFICULTY_LEVELS - 1);
+}
+
+} // namespace
+
+// ============================================================================
+// Difficulty Score
+// ============================================================================
+
+float scaleComplexity(std::uint16_t scale_mask) noexcept {
+    const int size = std::popcount(scale_mask);
+    if (size == 0) return 0.0f;
+
+    // Semitone pairs, wrapping B -> C
+    const auto rotated = static_cast<std::uint16_t>(((scale_mask >> 1) | (scale_mask << 11)) & 0x0FFF);
+    const int semitones = std::popcount(static_cast<std::uint16_t>(scale_mask & rotated));
+
+    const float size_term = clampUnit(static_cast<float>(size - 5) / 7.0f);
+    return 0.5f * size_term + 0.5f * static_cast<float>(semitones) / static_cast<float>(size);
+}
+
+DifficultyScorer::DifficultyScorer(const InstrumentConfig& instrument)
+    : instrument_{instrument}
+    , fret_width_{} {
+    for (int fret = 0; fret <= MAX_SUPPORTED_FRET; ++fret) {
+        fret_width_[fret] = static_cast<float>(std::exp2((5 - fret) / 12.0));
+    }
+}
+
+DifficultyScore DifficultyScorer::score(std::span<const Note> notes, std::uint16_t scale_mask) const noexcept {
+    DifficultyScore result{};
+    result.scale = scaleComplexity(scale_mask);
+    if (notes.empty()) {
+        result.total = MAX_DIFFICULTY * WEIGHT_SCALE * result.scale;
+        return result;
+    }
+
+    float stretch = 0.0f;
+    int skips = 0;
+    int runs = 0;
+    int fretted_moves = 0;
+    int fret_sum = 0;
+    int fretted = 0;
+    int min_pitch = NUM_MIDI_PITCHES;
+    int max_pitch = -1;
+
+    for (std::size_t i = 0; i < notes.size(); ++i) {
+        const int string_idx = notes[i].string_idx.value;
+        const int fret = notes[i].fret.value;
+        const int pitch = instrument_.getPitch(string_idx, fret);
+        min_pitch = std::min(min_pitch, pitch);
+        max_pitch = std::max(max_pitch, pitch);
+        if (fret > MIN_FRET) {
+            fret_sum += fret;
+            ++fretted;
+        }
+        if (i == 0) continue;
+
+        const int prev_string = notes[i - 1].string_idx.value;
+        const int prev_fret = notes[i - 1].fret.value;
+        const int string_distance = std::abs(string_idx - prev_string);
+        skips += std::max(0, string_distance - 1);
+        if (string_distance == 0 && fret != prev_fret) ++runs;
+
+        // The same reach costs more near the nut, where frets are wider
+        if (fret > MIN_FRET && prev_fret > MIN_FRET) {
+            const int extra = std::max(0, std::abs(fret - prev_fret) - 1);
+            stretch += static_cast<float>(extra) * fret_width_[std::min(fret, prev_fret)];
+            ++fretted_moves;
+        }
+    }
+
+    const auto moves = static_cast<float>(std::max<std::size_t>(1, notes.size() - 1));
+    result.stretch = clampUnit(stretch / (FULL_STRETCH * static_cast<float>(std::max(1, fretted_moves))));
+    result.skips = clampUnit(static_cast<float>(skips) / (FULL_SKIP * moves));
+    result.runs = clampUnit(static_cast<float>(runs) / moves);
+    result.range = clampUnit(static_cast<float>(max_pitch - min_pitch) / FULL_RANGE);
+    result.position = fretted > 0 ? clampUnit(static_cast<float>(fret_sum) / (FULL_HEIGHT * fretted)) : 0.0f;
+    result.total = MAX_DIFFICULTY * (WEIGHT_STRETCH * result.stretch + WEIGHT_SKIPS * result.skips +
+                                     WEIGHT_RUNS * result.runs + WEIGHT_RANGE * result.range +
+                                     WEIGHT_POSITION * result.position + WEIGHT_SCALE * result.scale);
+    return result;
+}
+
+std::optional<DifficultyBand> parseDifficultyBand(const std::string& text) {
+    const auto dash = text.find('-');
+    if (dash == std::string::npos) return std::nullopt;
+
+    int lo = -1;
+    int hi = -1;
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    const auto first = std::from_chars(begin, begin + dash, lo);
+    const auto second = std::from_chars(begin + dash + 1, end, hi);
+    if (first.ec != std::errc{} || first.ptr != begin + dash || second.ec != std::errc{} || second.ptr != end) {
+        return std::nullopt;
+    }
+    if (lo < 0 || hi > static_cast<int>(MAX_DIFFICULTY) || lo > hi) return std::nullopt;
+    return DifficultyBand{static_cast<float>(lo), static_cast<float>(hi)};
+}
+
+// ============================================================================
+// Targeted Generator
+// ============================================================================
+
+GeneratorProfile getDifficultyProfile(int level) {
+    level = std::clamp(level, 0, NUM_DIFFICULTY_LEVELS - 1);
+    const GeneratorProfile& easy = EASIEST_PROFILE;
+    const GeneratorProfile& hard = HARDEST_PROFILE;
+    return GeneratorProfile{
+        .position_box_radius = interpolate(easy.position_box_radius, hard.position_box_radius, level),
+        .max_local_range = interpolate(easy.max_local_range, hard.max_local_range, level),
+        .max_global_range = interpolate(easy.max_global_range, hard.max_global_range, level),
+        .local_window_size = interpolate(easy.local_window_size, hard.local_window_size, level),
+        .weight_close = interpolate(easy.weight_close, hard.weight_close, level),
+        .weight_medium = interpolate(easy.weight_medium, hard.weight_medium, level),
+        .weight_far = interpolate(easy.weight_far, hard.weight_far, level),
+        .max_consecutive_same_string = interpolate(easy.max_consecutive_same_string,
+                                                   hard.max_consecutive_same_string, level),
+        .same_string_bonus = interpolate(easy.same_string_bonus, hard.same_string_bonus, level),
+    };
+}
+
+TargetedGenerator::TargetedGenerator(const FretboardValidator& validator, const DifficultyBand& band,
+                                     std::uint32_t seed)
+    : validator_{validator}
+    , band_{band}
+    , seed_{seed}
+    , scorer_{validator.getInstrument()}
+    , scale_mask_{validator.getScaleMask()}
+    , generators_{}
+    , mean_{}
+    , samples_{}
+    , candidate_{}
+    , attempts_{0}
+    , misses_{0} {
+    // Prior until a level has produced exercises: an even ramp over the scale
+    for (int level = 0; level < NUM_DIFFICULTY_LEVELS; ++level) {
+        mean_[level] = 10.0f + 60.0f * static_cast<float>(level) / (NUM_DIFFICULTY_LEVELS - 1);
+    }
+}
+
+int TargetedGenerator::nearestLevel() const noexcept {
+    const float centre = 0.5f * (band_.min + band_.max);
+    int best = 0;
+    for (int level = 1; level < NUM_DIFFICULTY_LEVELS; ++level) {
+        if (std::fabs(mean_[level] - centre) < std::fabs(mean_[best] - centre)) best = level;
+    }
+    return best;
+}
+
+NoteGenerator& TargetedGenerator::levelGenerator(int level) {
+    auto& generator = generators_[level];
+    if (!generator) {
+        generator = makeNoteGenerator(validator_, getDifficultyProfile(level),
+                                      seed_ + static_cast<std::uint32_t>(level) * 0x9E3779B9u);
+    }
+    return *generator;
+}
+
+DifficultyScore TargetedGenerator::generate(std::vector<Note>& notes) {
+    DifficultyScore best{};
+    float best_distance = MAX_DIFFICULTY + 1.0f;
+    int level = nearestLevel();
+
+    for (int attempt = 0; attempt < MAX_TARGET_ATTEMPTS; ++attempt) {
+        candidate_.clear();
+        for (const auto& note : levelGenerator(level).generateTablature()) {
+            candidate_.push_back(*note);
+        }
+        ++attempts_;
+
+        const DifficultyScore score = scorer_.score(candidate_, scale_mask_);
+        // Running mean; after 32 samples it follows recent exercises
+        mean_[level] += (score.total - mean_[level]) / static_cast<float>(std::min(++samples_[level], 32));
+
+        const float distance = score.total < band_.min ? band_.min - score.total
+                             : score.total > band_.max ? score.total - band_.max : 0.0f;
+        if (distance < best_distance) {
+            best_distance = distance;
+            best = score;
+            notes.swap(candidate_);
+        }
+        if (distance == 0.0f) return best;
+
+        // Steer: one level toward the band
+        level = std::clamp(level + (score.total < band_.min ? 1 : -1), 0, NUM_DIFFICULTY_LEVELS - 1);
+    }
+
+    ++misses_;
+    return best;
+}
+
+} // namespace Guitar
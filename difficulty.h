@@ -0,0 +1,111 @@
+#ifndef DIFFICULTY_H
+#define DIFFICULTY_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+#include "fretboard.h"
+#include "generator.h"
+
+namespace Guitar {
+
+// ============================================================================
+// Difficulty Score
+// ============================================================================
+
+constexpr float MAX_DIFFICULTY = 100.0f;
+
+// Every component is normalized to [0, 1]; total is their weighted sum on
+// a 0-100 scale
+struct DifficultyScore {
+    float stretch;     // Fret distance between fretted notes, scaled by fret width
+    float skips;       // Strings jumped over between consecutive notes
+    float runs;        // Moves that slide along one string
+    float range;       // Pitch span of the exercise (two octaves = 1)
+    float position;    // Mean height of the fretted notes on the neck
+    float scale;       // Scale complexity (see scaleComplexity)
+    float total;
+};
+
+// 0 for pentatonic-like scales, growing with size and semitone clusters
+// (Major ~0.29, chromatic 1)
+[[nodiscard]] float scaleComplexity(std::uint16_t scale_mask) noexcept;
+
+// One pass over the notes with the instrument's pitch table; no allocation
+class DifficultyScorer {
+public:
+    explicit DifficultyScorer(const InstrumentConfig& instrument);
+
+    [[nodiscard]] DifficultyScore score(std::span<const Note> notes, std::uint16_t scale_mask) const noexcept;
+
+private:
+    InstrumentConfig instrument_;
+    std::array<float, MAX_SUPPORTED_FRET + 1> fret_width_;  // Relative to the 5th fret
+};
+
+// ============================================================================
+// Difficulty Band - "30-50" on the 0-100 scale
+// ============================================================================
+
+struct DifficultyBand {
+    float min;
+    float max;
+
+    [[nodiscard]] bool contains(float difficulty) const noexcept {
+        return difficulty >= min && difficulty <= max;
+    }
+};
+
+// "LO-HI" with 0 <= LO <= HI <= 100; std::nullopt otherwise
+[[nodiscard]] std::optional<DifficultyBand> parseDifficultyBand(const std::string& text);
+
+// ============================================================================
+// Targeted Generator - steer the profile toward a difficulty band
+// ============================================================================
+
+constexpr int NUM_DIFFICULTY_LEVELS = 8;    // Profiles from easiest to hardest
+constexpr int MAX_TARGET_ATTEMPTS = 3;      // Exercises tried before taking the closest
+
+// Profile of `level` in [0, NUM_DIFFICULTY_LEVELS): interpolated from a
+// tight box with close steps (level 0) to a wide box with free jumps
+[[nodiscard]] GeneratorProfile getDifficultyProfile(int level);
+
+// Keeps one generator per difficulty level and a running mean of the
+// scores each level produces. Every exercise starts at the level whose mean
+// is nearest the band centre; a miss moves one level up or down. Levels are
+// calibrated from the exercises themselves, so the band is usually hit on
+// the first try and the cost stays close to plain generation.
+class TargetedGenerator {
+public:
+    TargetedGenerator(const FretboardValidator& validator, const DifficultyBand& band, std::uint32_t seed);
+
+    // Exercise inside the band, or the closest of MAX_TARGET_ATTEMPTS
+    DifficultyScore generate(std::vector<Note>& notes);
+
+    [[nodiscard]] long long getAttempts() const noexcept { return attempts_; }
+    [[nodiscard]] long long getMisses() const noexcept { return misses_; }
+
+private:
+    [[nodiscard]] int nearestLevel() const noexcept;
+    [[nodiscard]] NoteGenerator& levelGenerator(int level);
+
+    const FretboardValidator& validator_;
+    DifficultyBand band_;
+    std::uint32_t seed_;
+    DifficultyScorer scorer_;
+    std::uint16_t scale_mask_;
+    std::array<std::unique_ptr<NoteGenerator>, NUM_DIFFICULTY_LEVELS> generators_;  // Built on first use
+    std::array<float, NUM_DIFFICULTY_LEVELS> mean_;       // Running mean score per level
+    std::array<int, NUM_DIFFICULTY_LEVELS> samples_;
+    std::vector<Note> candidate_;
+    long long attempts_;
+    long long misses_;
+};
+
+} // namespace Guitar
+
+#endif // DIFFICULTY_H
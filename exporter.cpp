@@ -0,0 +1,329 @@
+#include "exporter.h"
+#include "music_theory.h"
+#include <algorithm>
+#include <cctype>
+
+namespace Guitar {
+
+namespace {
+
+// ============================================================================
+// Constants - General MIDI
+// ============================================================================
+
+constexpr std::uint8_t PROGRAM_CLEAN_GUITAR = 27;   // "Electric Guitar (clean)"
+constexpr std::uint8_t PROGRAM_FINGER_BASS = 33;    // "Electric Bass (finger)"
+constexpr std::uint8_t NOTE_ON_VELOCITY = 96;
+constexpr std::uint8_t NOTE_OFF_VELOCITY = 64;
+
+constexpr std::uint8_t META_TEXT = 0x01;
+constexpr std::uint8_t META_TRACK_NAME = 0x03;
+constexpr std::uint8_t META_INSTRUMENT_NAME = 0x04;
+constexpr std::uint8_t META_MARKER = 0x06;
+
+// ============================================================================
+// SMF Encoding Helpers
+// ============================================================================
+
+void appendBigEndian(std::string& out, std::uint32_t value, int bytes) {
+    for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xFF));
+    }
+}
+
+// Variable-length quantity (delta times and meta lengths)
+void appendVarLen(std::string& out, std::uint32_t value) {
+    char bytes[5];
+    int count = 0;
+    do {
+        bytes[count++] = static_cast<char>(value & 0x7F);
+        value >>= 7;
+    } while (value > 0);
+    while (count > 1) {
+        out.push_back(static_cast<char>(bytes[--count] | 0x80));
+    }
+    out.push_back(bytes[0]);
+}
+
+void appendMeta(std::string& out, std::uint32_t delta, std::uint8_t type, const std::string& data) {
+    appendVarLen(out, delta);
+    out.push_back(static_cast<char>(0xFF));
+    out.push_back(static_cast<char>(type));
+    appendVarLen(out, static_cast<std::uint32_t>(data.size()));
+    out += data;
+}
+
+void appendEndOfTrack(std::string& out) {
+    appendMeta(out, 0, 0x2F, "");
+}
+
+// ============================================================================
+// MusicXML Helpers
+// ============================================================================
+
+// <step>C</step><alter>1</alter><octave>4</octave> (sharps, as NOTE_NAMES)
+void appendPitch(std::string& out, const char* step_tag, const char* alter_tag, const char* octave_tag,
+                 int midi_pitch) {
+    const char* name = Music::NOTE_NAMES[midi_pitch % Music::SEMITONES_IN_OCTAVE];
+    out += "<"; out += step_tag; out += ">"; out += name[0]; out += "</"; out += step_tag; out += ">";
+    if (name[1] == '#') {
+        out += "<"; out += alter_tag; out += ">1</"; out += alter_tag; out += ">";
+    }
+    out += "<"; out += octave_tag; out += ">" + std::to_string(midi_pitch / Music::SEMITONES_IN_OCTAVE - 1);
+    out += "</"; out += octave_tag; out += ">";
+}
+
+const char* noteTypeName(int note_value) {
+    switch (note_value) {
+        case 4:  return "quarter";
+        case 8:  return "eighth";
+        default: return "16th";
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Export Options
+// ============================================================================
+
+std::string escapeXml(const std::string& text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '&':  escaped += "&amp;"; break;
+            case '<':  escaped += "&lt;"; break;
+            case '>':  escaped += "&gt;"; break;
+            case '"':  escaped += "&quot;"; break;
+            case '\'': escaped += "&apos;"; break;
+            default:   escaped.push_back(c);
+        }
+    }
+    return escaped;
+}
+
+bool isValidExportOptions(const ExportOptions& options) noexcept {
+    const bool tempo_ok = options.tempo_bpm >= MIN_EXPORT_TEMPO && options.tempo_bpm <= MAX_EXPORT_TEMPO;
+    const bool value_ok = options.note_value == 4 || options.note_value == 8 || options.note_value == 16;
+    return tempo_ok && value_ok;
+}
+
+std::optional<ExportFormat> exportFormatFromPath(const std::string& path) {
+    const auto dot = path.find_last_of('.');
+    if (dot == std::string::npos) return std::nullopt;
+
+    std::string extension = path.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (extension == "mid" || extension == "midi") return ExportFormat::Midi;
+    if (extension == "musicxml" || extension == "xml") return ExportFormat::MusicXml;
+    return std::nullopt;
+}
+
+// ============================================================================
+// MidiFileWriter Implementation
+// ============================================================================
+
+MidiFileWriter::MidiFileWriter(std::ostream& out, const InstrumentConfig& instrument,
+                               const ExportOptions& options)
+    : out_{out}
+    , instrument_{instrument}
+    , options_{options}
+    , length_pos_{}
+    , track_bytes_{0}
+    , buffer_{}
+    , fingering_{}
+    , fingers_{} {
+    std::string header = "MThd";
+    appendBigEndian(header, 6, 4);
+    appendBigEndian(header, 1, 2);                        // Type 1
+    appendBigEndian(header, 2, 2);                        // Conductor + notes
+    appendBigEndian(header, MIDI_TICKS_PER_QUARTER, 2);
+
+    // Conductor track: title, tempo, 4/4
+    std::string conductor;
+    appendMeta(conductor, 0, META_TRACK_NAME, options_.title);
+    std::string tempo;
+    appendBigEndian(tempo, static_cast<std::uint32_t>(60000000 / options_.tempo_bpm), 3);
+    appendMeta(conductor, 0, 0x51, tempo);
+    appendMeta(conductor, 0, 0x58, std::string("\x04\x02\x18\x08", 4));
+    appendEndOfTrack(conductor);
+
+    header += "MTrk";
+    appendBigEndian(header, static_cast<std::uint32_t>(conductor.size()), 4);
+    header += conductor;
+    header += "MTrk";
+    out_.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    // Note track length is unknown until finish()
+    length_pos_ = out_.tellp();
+    const char placeholder[4] = {0, 0, 0, 0};
+    out_.write(placeholder, 4);
+
+    buffer_.clear();
+    appendMeta(buffer_, 0, META_TRACK_NAME, instrument_.name);
+    appendMeta(buffer_, 0, META_INSTRUMENT_NAME, instrument_.name + " (" + describeTuning(instrument_) + ")");
+    buffer_.push_back(0);
+    buffer_.push_back(static_cast<char>(0xC0));
+    buffer_.push_back(static_cast<char>(instrument_.type == InstrumentType::Bass ? PROGRAM_FINGER_BASS
+                                                                                 : PROGRAM_CLEAN_GUITAR));
+    track_bytes_ += static_cast<std::uint32_t>(buffer_.size());
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+}
+
+void MidiFileWriter::write(const std::vector<Note>& notes, const std::string& label) {
+    const auto ticks = static_cast<std::uint32_t>(MIDI_TICKS_PER_QUARTER * 4 / options_.note_value);
+
+    if (options_.fingering) fingering_.assign(notes, fingers_);
+
+    buffer_.clear();
+    appendMeta(buffer_, 0, META_MARKER, label);
+    for (std::size_t i = 0; i < notes.size(); ++i) {
+        const Note& note = notes[i];
+        const auto pitch = static_cast<char>(note.getMidiPitch(instrument_));
+        std::string position = std::to_string(note.string_idx.value + 1) + ":" + std::to_string(note.fret.value);
+        if (options_.fingering) position += " f" + std::to_string(fingers_[i]);
+        appendMeta(buffer_, 0, META_TEXT, position);
+
+        buffer_.push_back(0);
+        buffer_.push_back(static_cast<char>(0x90));
+        buffer_.push_back(pitch);
+        buffer_.push_back(static_cast<char>(NOTE_ON_VELOCITY));
+
+        appendVarLen(buffer_, ticks);
+        buffer_.push_back(static_cast<char>(0x80));
+        buffer_.push_back(pitch);
+        buffer_.push_back(static_cast<char>(NOTE_OFF_VELOCITY));
+    }
+
+    track_bytes_ += static_cast<std::uint32_t>(buffer_.size());
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+}
+
+bool MidiFileWriter::finish() {
+    buffer_.clear();
+    appendEndOfTrack(buffer_);
+    track_bytes_ += static_cast<std::uint32_t>(buffer_.size());
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+
+    std::string length;
+    appendBigEndian(length, track_bytes_, 4);
+    const auto end = out_.tellp();
+    out_.seekp(length_pos_);
+    out_.write(length.data(), 4);
+    out_.seekp(end);
+    out_.flush();
+    return out_.good();
+}
+
+// ============================================================================
+// MusicXmlWriter Implementation
+// ============================================================================
+
+MusicXmlWriter::MusicXmlWriter(std::ostream& out, const InstrumentConfig& instrument,
+                               const ExportOptions& options)
+    : out_{out}
+    , instrument_{instrument}
+    , options_{options}
+    , measure_{0}
+    , beat_in_measure_{0}
+    , buffer_{}
+    , fingering_{}
+    , fingers_{} {
+    buffer_ =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n"
+        "<!DOCTYPE score-partwise PUBLIC \"-//Recordare//DTD MusicXML 4.0 Partwise//EN\""
+        " \"http://www.musicxml.org/dtds/partwise.dtd\">\n"
+        "<score-partwise version=\"4.0\">\n"
+        "  <work><work-title>" + escapeXml(options_.title) + "</work-title></work>\n"
+        "  <part-list>\n"
+        "    <score-part id=\"P1\"><part-name>" + escapeXml(instrument_.name) + "</part-name></score-part>\n"
+        "  </part-list>\n"
+        "  <part id=\"P1\">\n";
+    out_ << buffer_;
+}
+
+void MusicXmlWriter::write(const std::vector<Note>& notes, const std::string& label) {
+    if (options_.fingering) fingering_.assign(notes, fingers_);
+
+    buffer_.clear();
+    const int divisions = options_.note_value / 4;  // Every note lasts one division
+
+    for (std::size_t i = 0; i < notes.size(); ++i) {
+        if (beat_in_measure_ == 0) {
+            buffer_ += "    <measure number=\"" + std::to_string(++measure_) + "\">\n";
+            if (measure_ == 1) {
+                buffer_ += "      <attributes>\n"
+                           "        <divisions>" + std::to_string(divisions) + "</divisions>\n"
+                           "        <key><fifths>0</fifths></key>\n"
+                           "        <time><beats>4</beats><beat-type>4</beat-type></time>\n"
+                           "        <clef><sign>TAB</sign><line>5</line></clef>\n"
+                           "        <staff-details>\n"
+                           "          <staff-lines>" + std::to_string(instrument_.num_strings) + "</staff-lines>\n";
+                // Line 1 is the lowest string
+                for (int line = 1; line <= instrument_.num_strings; ++line) {
+                    buffer_ += "          <staff-tuning line=\"" + std::to_string(line) + "\">";
+                    appendPitch(buffer_, "tuning-step", "tuning-alter", "tuning-octave",
+                                instrument_.open_midi[instrument_.num_strings - line]);
+                    buffer_ += "</staff-tuning>\n";
+                }
+                if (instrument_.capo > 0) {
+                    buffer_ += "          <capo>" + std::to_string(instrument_.capo) + "</capo>\n";
+                }
+                buffer_ += "        </staff-details>\n"
+                           "      </attributes>\n"
+                           "      <sound tempo=\"" + std::to_string(options_.tempo_bpm) + "\"/>\n";
+            }
+        }
+
+        if (i == 0) {
+            buffer_ += "      <direction placement=\"above\"><direction-type><words>" + escapeXml(label) +
+                       "</words></direction-type></direction>\n";
+        }
+
+        const Note& note = notes[i];
+        buffer_ += "      <note><pitch>";
+        appendPitch(buffer_, "step", "alter", "octave", note.getMidiPitch(instrument_));
+        buffer_ += "</pitch><duration>1</duration><voice>1</voice><type>";
+        buffer_ += noteTypeName(options_.note_value);
+        buffer_ += "</type><notations><technical>";
+        if (options_.fingering && fingers_[i] != OPEN_FINGER) {
+            buffer_ += "<fingering>" + std::to_string(fingers_[i]) + "</fingering>";
+        }
+        buffer_ += "<string>" + std::to_string(note.string_idx.value + 1) + "</string><fret>" +
+                   std::to_string(note.fret.value) + "</fret></technical></notations></note>\n";
+
+        if (++beat_in_measure_ == options_.note_value) {
+            buffer_ += "    </measure>\n";
+            beat_in_measure_ = 0;
+        }
+    }
+
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+}
+
+bool MusicXmlWriter::finish() {
+    if (beat_in_measure_ > 0) {
+        out_ << "    </measure>\n";  // Short last measure
+        beat_in_measure_ = 0;
+    }
+    out_ << "  </part>\n</score-partwise>\n";
+    out_.flush();
+    return out_.good();
+}
+
+// ============================================================================
+// Factory
+// ============================================================================
+
+std::unique_ptr<ExerciseWriter> makeExerciseWriter(ExportFormat format, std::ostream& out,
+                                                   const InstrumentConfig& instrument,
+                                                   const ExportOptions& options) {
+    if (format == ExportFormat::Midi) {
+        return std::make_unique<MidiFileWriter>(out, instrument, options);
+    }
+    return std::make_unique<MusicXmlWriter>(out, instrument, options);
+}
+
+} // namespace Guitar
@@ -0,0 +1,111 @@
+#ifndef EXPORTER_H
+#define EXPORTER_H
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "fingering.h"
+#include "fretboard.h"
+
+namespace Guitar {
+
+// ============================================================================
+// Export Options
+// ============================================================================
+
+enum class ExportFormat {
+    Midi,      // Standard MIDI File, Type 1 (.mid / .midi)
+    MusicXml   // MusicXML 4.0 partwise with a TAB staff (.musicxml / .xml)
+};
+
+constexpr int MIDI_TICKS_PER_QUARTER = 480;
+constexpr int MIN_EXPORT_TEMPO = 20;
+constexpr int MAX_EXPORT_TEMPO = 400;
+
+struct ExportOptions {
+    int tempo_bpm = 100;
+    int note_value = 16;            // 4 = quarters, 8 = eighths, 16 = sixteenths
+    std::string title = "CrazyFingers";
+    bool fingering = true;          // Finger per note from FingeringEngine
+};
+
+// Tempo within MIN/MAX_EXPORT_TEMPO and a note value of 4, 8 or 16
+// (exercises then fill whole 4/4 measures)
+[[nodiscard]] bool isValidExportOptions(const ExportOptions& options) noexcept;
+
+// From the file extension; std::nullopt if it is not a known format
+[[nodiscard]] std::optional<ExportFormat> exportFormatFromPath(const std::string& path);
+
+// Text content / attribute value for XML outputs (MusicXML, SVG)
+[[nodiscard]] std::string escapeXml(const std::string& text);
+
+// ============================================================================
+// Exercise Writers - stream exercises straight to the output
+// ============================================================================
+
+// Each exercise is encoded and written as soon as it arrives, so memory
+// stays constant no matter how many exercises go into one file.
+class ExerciseWriter {
+public:
+    virtual ~ExerciseWriter() = default;
+
+    // `label` names the exercise (e.g. "A Pentatonic Minor")
+    virtual void write(const std::vector<Note>& notes, const std::string& label) = 0;
+
+    // Closes the document; false if the stream failed at any point
+    [[nodiscard]] virtual bool finish() = 0;
+};
+
+// Track 0 holds title, tempo and time signature; track 1 the notes, each
+// preceded by a text meta event with its "string:fret" position (plus
+// " f<finger>" when fingering is on, 0 = open string). The track
+// length is patched on finish(), so the stream must be seekable (a file).
+class MidiFileWriter final : public ExerciseWriter {
+public:
+    MidiFileWriter(std::ostream& out, const InstrumentConfig& instrument, const ExportOptions& options);
+
+    void write(const std::vector<Note>& notes, const std::string& label) override;
+    [[nodiscard]] bool finish() override;
+
+private:
+    std::ostream& out_;
+    const InstrumentConfig& instrument_;
+    ExportOptions options_;
+    std::streampos length_pos_;     // Placeholder of the note track length
+    std::uint32_t track_bytes_;
+    std::string buffer_;            // One exercise of events
+    FingeringEngine fingering_;
+    std::vector<std::uint8_t> fingers_;
+};
+
+// One part with a TAB staff (staff-details carry the tuning and capo);
+// every note has <technical><string><fret> (and <fingering> when enabled
+// and the note is fretted), every exercise a <words> label
+class MusicXmlWriter final : public ExerciseWriter {
+public:
+    MusicXmlWriter(std::ostream& out, const InstrumentConfig& instrument, const ExportOptions& options);
+
+    void write(const std::vector<Note>& notes, const std::string& label) override;
+    [[nodiscard]] bool finish() override;
+
+private:
+    std::ostream& out_;
+    const InstrumentConfig& instrument_;
+    ExportOptions options_;
+    int measure_;
+    int beat_in_measure_;           // Notes already in the open measure
+    std::string buffer_;
+    FingeringEngine fingering_;
+    std::vector<std::uint8_t> fingers_;
+};
+
+[[nodiscard]] std::unique_ptr<ExerciseWriter> makeExerciseWriter(ExportFormat format, std::ostream& out,
+                                                                 const InstrumentConfig& instrument,
+                                                                 const ExportOptions& options);
+
+} // namespace Guitar
+
+#endif // EXPORTER_H
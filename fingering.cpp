@@ -0,0 +1,147 @@
+#include "fingering.h"
+#include <cstdlib>
+#include <limits>
+
+namespace Guitar {
+
+// ============================================================================
+// FingeringEngine Implementation
+// ============================================================================
+
+FingeringEngine::FingeringEngine(const FingeringWeights& weights)
+    : weights_{weights}
+    , states_{}
+    , costs_{}
+    , back_{}
+    , counts_{} {}
+
+int FingeringEngine::transitionCost(const State& from, const State& to) const noexcept {
+    int cost = to.finger == NUM_FINGERS ? weights_.pinky : 0;
+    if (from.hand == 0) return cost;  // First fretted note: nothing to move from
+
+    const int fret_delta = to.fret - from.fret;
+    if (to.finger == from.last) {
+        // Same fret on another string is a roll; anywhere else the finger jumps
+        if (fret_delta == 0) return cost;
+        return cost + weights_.reuse + weights_.shift + weights_.shift_per_fret * std::abs(fret_delta);
+    }
+
+    const int finger_delta = to.finger - from.last;
+    if (fret_delta == 0) {
+        return cost + weights_.cramp * std::abs(finger_delta);
+    }
+
+    // Finger order against fret order: when the previous fret still lies
+    // under the new hand position, the hand stays and the fingers cross;
+    // otherwise the reversed order is just a position shift
+    const int held = from.fret - to.hand + 1;  // Slot of the previous fret in the new position
+    if ((fret_delta > 0) != (finger_delta > 0) && held >= 1 && held <= NUM_FINGERS) {
+        return cost + weights_.crossing;
+    }
+
+    // One fret off the finger slots is absorbed by the fingers; more moves the hand
+    const int hand_delta = std::abs(to.hand - from.hand);
+    if (hand_delta == 0) return cost;
+    if (hand_delta == 1) {
+        return cost + (std::abs(fret_delta) > std::abs(finger_delta) ? weights_.stretch : weights_.cramp);
+    }
+    return cost + weights_.shift + weights_.shift_per_fret * hand_delta;
+}
+
+int FingeringEngine::assign(std::span<const Note> notes, std::vector<std::uint8_t>& fingers) {
+    const std::size_t n = notes.size();
+    fingers.assign(n, OPEN_FINGER);
+    if (n == 0) return 0;
+
+    states_.resize(n);
+    costs_.resize(n);
+    back_.resize(n);
+    counts_.resize(n);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const int fret = notes[i].fret.value;
+        const int string = notes[i].string_idx.value;
+
+        if (fret == MIN_FRET) {
+            // Open string: the hand stays put, every previous state carries over
+            if (i == 0) {
+                states_[0][0] = State{OPEN_FINGER, 0, 0, 0, OPEN_FINGER};
+                costs_[0][0] = 0;
+                counts_[0] = 1;
+                continue;
+            }
+            counts_[i] = counts_[i - 1];
+            for (std::uint8_t s = 0; s < counts_[i]; ++s) {
+                states_[i][s] = states_[i - 1][s];
+                states_[i][s].finger = OPEN_FINGER;
+                costs_[i][s] = costs_[i - 1][s];
+                back_[i][s] = s;
+            }
+            continue;
+        }
+
+        std::uint8_t count = 0;
+        for (int finger = 1; finger <= NUM_FINGERS; ++finger) {
+            const int hand = fret - finger + 1;
+            if (hand < 1) break;  // The index finger would sit behind the nut
+
+            const State state{static_cast<std::uint8_t>(finger), hand, fret, string, static_cast<std::uint8_t>(finger)};
+            int best = std::numeric_limits<int>::max();
+            std::uint8_t best_from = 0;
+            if (i == 0) {
+                best = transitionCost(State{OPEN_FINGER, 0, 0, 0, OPEN_FINGER}, state);
+            } else {
+                for (std::uint8_t s = 0; s < counts_[i - 1]; ++s) {
+                    // A repeated note keeps its finger (that state always exists)
+                    const State& from = states_[i - 1][s];
+                    if (from.hand > 0 && from.fret == fret && from.string == string && from.last != finger) continue;
+                    const int cost = costs_[i - 1][s] + transitionCost(from, state);
+                    if (cost < best) {
+                        best = cost;
+                        best_from = s;
+                    }
+                }
+            }
+
+            states_[i][count] = state;
+            costs_[i][count] = best;
+            back_[i][count] = best_from;
+            ++count;
+        }
+        counts_[i] = count;
+    }
+
+    std::uint8_t state = 0;
+    for (std::uint8_t s = 1; s < counts_[n - 1]; ++s) {
+        if (costs_[n - 1][s] < costs_[n - 1][state]) state = s;
+    }
+    const int total = costs_[n - 1][state];
+
+    for (std::size_t i = n; i-- > 0;) {
+        fingers[i] = states_[i][state].finger;
+        state = back_[i][state];
+    }
+    return total;
+}
+
+// ============================================================================
+// Convenience Functions
+// ============================================================================
+
+std::vector<std::uint8_t> assignFingering(std::span<const Note> notes) {
+    FingeringEngine engine;
+    std::vector<std::uint8_t> fingers;
+    engine.assign(notes, fingers);
+    return fingers;
+}
+
+std::vector<std::uint8_t> assignFingering(const std::vector<std::unique_ptr<Note>>& notes) {
+    std::vector<Note> values;
+    values.reserve(notes.size());
+    for (const auto& note : notes) {
+        values.push_back(*note);
+    }
+    return assignFingering(values);
+}
+
+} // namespace Guitar
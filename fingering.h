@@ -0,0 +1,75 @@
+#ifndef FINGERING_H
+#define FINGERING_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+#include "fretboard.h"
+
+namespace Guitar {
+
+// ============================================================================
+// Constants - Fretting Hand
+// ============================================================================
+
+constexpr int NUM_FINGERS = 4;               // 1 = index ... 4 = pinky
+constexpr std::uint8_t OPEN_FINGER = 0;      // Open string: no finger
+
+// Integer costs so equal inputs always pick the same fingering
+struct FingeringWeights {
+    int stretch = 2;          // Per fret a finger reaches beyond its slot
+    int cramp = 1;            // Per fret two fingers squeeze into the same slot
+    int crossing = 12;        // Higher finger on a lower fret within one hand position
+    int reuse = 6;            // Same finger moves to another fret
+    int shift = 5;            // The hand moves to a new position...
+    int shift_per_fret = 2;   // ...plus this per fret travelled
+    int pinky = 1;            // Pinky is the weakest finger
+};
+
+// ============================================================================
+// Fingering Engine - Viterbi over a finger-state lattice
+// ============================================================================
+
+// Every fretted note can take any of the four fingers; the finger fixes
+// where the index finger sits (fret - finger + 1), i.e. the hand position.
+// Open strings keep the hand where it was, so they inherit the states of
+// the previous note. The cheapest path through the lattice (at most 4
+// states per note, 16 transitions) is exact and costs well under a
+// microsecond for one exercise; buffers are reused between calls.
+class FingeringEngine {
+public:
+    explicit FingeringEngine(const FingeringWeights& weights = {});
+
+    // Finger per note (OPEN_FINGER on fret 0); returns the path cost
+    int assign(std::span<const Note> notes, std::vector<std::uint8_t>& fingers);
+
+    [[nodiscard]] const FingeringWeights& getWeights() const noexcept { return weights_; }
+
+private:
+    struct State {
+        std::uint8_t finger;
+        int hand;             // Fret under the index finger (0 = not placed yet)
+        int fret;             // Fret of the last fretted note (meaningful when hand > 0)
+        int string;           // String of the last fretted note (meaningful when hand > 0)
+        std::uint8_t last;    // Finger of the last fretted note
+    };
+
+    [[nodiscard]] int transitionCost(const State& from, const State& to) const noexcept;
+
+    FingeringWeights weights_;
+    std::vector<std::array<State, NUM_FINGERS>> states_;
+    std::vector<std::array<int, NUM_FINGERS>> costs_;
+    std::vector<std::array<std::uint8_t, NUM_FINGERS>> back_;
+    std::vector<std::uint8_t> counts_;
+};
+
+// Convenience for generator output
+[[nodiscard]] std::vector<std::uint8_t> assignFingering(const std::vector<std::unique_ptr<Note>>& notes);
+[[nodiscard]] std::vector<std::uint8_t> assignFingering(std::span<const Note> notes);
+
+} // namespace Guitar
+
+#endif // FINGERING_H
@@ -1,6 +1,9 @@
 #include "formatter.h"
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <sstream>
+#include <cctype>
 
 namespace Guitar {
 
@@ -22,31 +25,87 @@ std::string formatNotePosition(const Note* note, int current_string) {
     return "---";
 }
 
-void printTablature(const std::vector<std::unique_ptr<Note>>& notes, int num_strings) {
-    const auto& labels = (num_strings == GUITAR_NUM_STRINGS) 
-                         ? GUITAR_STRING_LABELS 
-                         : std::array<const char*, 6>{"G", "D", "A", "E", "", ""};
+int getLabelWidth(const InstrumentConfig& instrument) noexcept {
+    // Pad labels so sharps ("C#") keep the bars aligned
+    size_t label_width = 1;
+    for (int s = 0; s < instrument.num_strings; ++s) {
+        label_width = std::max(label_width, instrument.labels[s].size());
+    }
+    return static_cast<int>(label_width);
+}
 
-    for (int string_idx = 0; string_idx < num_strings; ++string_idx) {
-        std::cout << labels[string_idx] << "|";
+std::vector<std::string> formatTablatureLines(const std::vector<Note>& notes, const InstrumentConfig& instrument) {
+    const int label_width = getLabelWidth(instrument);
+    std::vector<std::string> lines;
+    lines.reserve(static_cast<size_t>(instrument.num_strings));
+
+    for (int string_idx = 0; string_idx < instrument.num_strings; ++string_idx) {
+        std::string line = instrument.labels[string_idx];
+        line.resize(static_cast<size_t>(label_width), ' ');
+        line += "|";
 
         for (const auto& note : notes) {
-            const std::string position = formatNotePosition(note.get(), string_idx);
+            const std::string position = formatNotePosition(&note, string_idx);
 
-            std::cout << "-";
+            line += "-";
             if (position.length() == 1) {
-                std::cout << position << "--";
+                line += position + "--";
             } else if (position.length() == 2) {
-                std::cout << position << "-";
+                line += position + "-";
             } else {
-                std::cout << position;
+                line += position;
             }
         }
 
+        lines.push_back(line + "|");
+    }
+    return lines;
+}
+
+void printTablature(const std::vector<std::unique_ptr<Note>>& notes, const InstrumentConfig& instrument) {
+    std::vector<Note> values;
+    values.reserve(notes.size());
+    for (const auto& note : notes) {
+        values.push_back(*note);
+    }
+
+    for (const auto& line : formatTablatureLines(values, instrument)) {
+        std::cout << line << std::endl;
+    }
+}
+
+void printChordTablature(const std::vector<std::vector<Note>>& columns, const InstrumentConfig& instrument) {
+    const int label_width = getLabelWidth(instrument);
+
+    for (int string_idx = 0; string_idx < instrument.num_strings; ++string_idx) {
+        std::cout << std::left << std::setw(label_width)
+                  << instrument.labels[string_idx] << std::right << "|";
+
+        for (const auto& column : columns) {
+            const auto note = std::find_if(column.begin(), column.end(), [&](const Note& n) {
+                return n.string_idx.value == string_idx;
+            });
+            const std::string position = formatNotePosition(note == column.end() ? nullptr : &*note, string_idx);
+
+            std::cout << "-" << position << std::string(3 - std::min<size_t>(3, position.length()), '-');
+        }
+
         std::cout << "|" << std::endl;
     }
 }
 
+void printFingering(const std::vector<std::uint8_t>& fingers, const InstrumentConfig& instrument) {
+    // Same columns as printTablature: label, bar, then "-" + 3 chars per note
+    std::string line(static_cast<size_t>(getLabelWidth(instrument)) + 1, ' ');
+    for (const auto finger : fingers) {
+        line += ' ';
+        line += static_cast<char>('0' + finger);
+        line += "  ";
+    }
+    line.erase(line.find_last_not_of(' ') + 1);
+    std::cout << line << std::endl;
+}
+
 void printHarmonicInfo(const std::string& key_name,
                        const std::string& scale_name,
                        const std::string& scale_notes) {
@@ -54,12 +113,51 @@ void printHarmonicInfo(const std::string& key_name,
     std::cout << key_name << " " << scale_name << " (" << scale_notes << ")" << std::endl;
 }
 
-void printInstrumentInfo(InstrumentType type) {
-    if (type == InstrumentType::Bass) {
-        std::cout << "[Bass Guitar - 4 strings, Standard Tuning (E1-A1-D2-G2)]" << std::endl;
-    } else {
-        std::cout << "[Electric Guitar - 6 strings, Standard Tuning (E2-A2-D3-G3-B3-E4)]" << std::endl;
+void printInstrumentInfo(const InstrumentConfig& instrument) {
+    std::cout << "[" << instrument.name << " - " << instrument.num_strings << " strings, "
+              << instrument.tuning_name << " Tuning (" << describeTuning(instrument) << ")";
+    if (instrument.capo > 0) {
+        std::cout << ", Capo " << instrument.capo;
+    }
+    std::cout << "]" << std::endl;
+}
+
+std::string formatCompact(const std::vector<Note>& notes) {
+    std::ostringstream oss;
+    for (size_t i = 0; i < notes.size(); ++i) {
+        if (i > 0) oss << " ";
+        oss << (notes[i].string_idx.value + 1) << ":" << notes[i].fret.value;
+    }
+    return oss.str();
+}
+
+bool parseCompact(const std::string& text, int num_strings, std::vector<Note>& notes) {
+    notes.clear();
+
+    // Normalize separators so the stream sees "S:F" tokens
+    std::string normalized = text;
+    for (char& c : normalized) {
+        if (c == ',' || c == ';') c = ' ';
+    }
+
+    std::istringstream iss(normalized);
+    std::string token;
+    while (iss >> token) {
+        const auto colon = token.find(':');
+        if (colon == std::string::npos || colon == 0 || colon + 1 == token.size()) return false;
+        if (colon > 2 || token.size() - colon > 3) return false;  // At most "SS:FF"
+
+        for (size_t i = 0; i < token.size(); ++i) {
+            if (i != colon && !std::isdigit(static_cast<unsigned char>(token[i]))) return false;
+        }
+
+        Note note{{std::stoi(token.substr(0, colon)) - 1, num_strings},
+                  {std::stoi(token.substr(colon + 1))}};
+        if (!note.isValid()) return false;
+        notes.push_back(note);
     }
+
+    return !notes.empty();
 }
 
 } // namespace Formatter
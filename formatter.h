@@ -1,6 +1,7 @@
 #ifndef FORMATTER_H
 #define FORMATTER_H
 
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <string>
@@ -19,8 +20,24 @@ constexpr int NOTE_WIDTH = 4;
 // Format a single note position for a given string
 [[nodiscard]] std::string formatNotePosition(const Note* note, int current_string);
 
-// Print complete tablature to console (adapts to instrument string count)
-void printTablature(const std::vector<std::unique_ptr<Note>>& notes, int num_strings);
+// Tablature rows as printTablature prints them, one string per row;
+// note i starts at column label width + 2 + i * NOTE_WIDTH
+[[nodiscard]] std::vector<std::string> formatTablatureLines(const std::vector<Note>& notes,
+                                                            const InstrumentConfig& instrument);
+
+// Width of the string labels column (labels are padded to it)
+[[nodiscard]] int getLabelWidth(const InstrumentConfig& instrument) noexcept;
+
+// Print complete tablature to console (adapts to instrument string count and labels)
+void printTablature(const std::vector<std::unique_ptr<Note>>& notes, const InstrumentConfig& instrument);
+
+// Print tablature where each column may hold several notes (double-stops,
+// chords); at most one note per string and column
+void printChordTablature(const std::vector<std::vector<Note>>& columns, const InstrumentConfig& instrument);
+
+// Print one finger per note (0 = open string) aligned under the tablature
+// Format: "   2   4   1   3   0"
+void printFingering(const std::vector<std::uint8_t>& fingers, const InstrumentConfig& instrument);
 
 // Print harmonic info with scale notes
 // Format: "C Major (C D E F G A B)"
@@ -29,7 +46,16 @@ void printHarmonicInfo(const std::string& key_name,
                        const std::string& scale_notes);
 
 // Print instrument info
-void printInstrumentInfo(InstrumentType type);
+// Format: "[Electric Guitar - 6 strings, Standard Tuning (E2-A2-D3-G3-B3-E4)]"
+void printInstrumentInfo(const InstrumentConfig& instrument);
+
+// Compact one-line notation: "string:fret" pairs with 1-based strings
+// Format: "3:7 2:5 2:7 1:4"
+[[nodiscard]] std::string formatCompact(const std::vector<Note>& notes);
+
+// Parse compact notation (separators: spaces or commas)
+// Returns false on malformed input or positions outside the instrument
+[[nodiscard]] bool parseCompact(const std::string& text, int num_strings, std::vector<Note>& notes);
 
 } // namespace Formatter
 
@@ -1,20 +1,239 @@
 #include "fretboard.h"
 #include <algorithm>
+#include <cctype>
 #include <cmath>
+#include <sstream>
 
 namespace Guitar {
 
+// ============================================================================
+// InstrumentConfig Implementation
+// ============================================================================
+
+void InstrumentConfig::rebuildPitchTable() noexcept {
+    pitch_table.fill(0);
+    for (int s = 0; s < num_strings; ++s) {
+        for (int f = MIN_FRET; f <= MAX_SUPPORTED_FRET; ++f) {
+            const int pitch = std::min(127, open_midi[s] + capo + f);
+            pitch_table[s * PITCH_TABLE_STRIDE + f] = static_cast<std::uint8_t>(pitch);
+        }
+    }
+}
+
+std::optional<InstrumentConfig> makeInstrument(InstrumentType type,
+                                               const std::string& name,
+                                               const std::string& tuning_name,
+                                               const std::vector<int>& low_to_high_midi,
+                                               int num_frets,
+                                               int capo) {
+    const int num_strings = static_cast<int>(low_to_high_midi.size());
+    if (num_strings < 3 || num_strings > MAX_STRINGS) return std::nullopt;
+    if (num_frets < POSITION_MIN_FRETS || num_frets > MAX_SUPPORTED_FRET) return std::nullopt;
+    if (capo < 0 || num_frets - capo < POSITION_MIN_FRETS) return std::nullopt;
+
+    InstrumentConfig config{};
+    config.type = type;
+    config.num_strings = num_strings;
+    config.name = name;
+    config.tuning_name = tuning_name;
+    config.num_frets = num_frets;
+    config.capo = capo;
+    config.open_midi.fill(0);
+
+    // Internal order is highest string first (index 0 = 1st string)
+    for (int s = 0; s < num_strings; ++s) {
+        const int midi = low_to_high_midi[num_strings - 1 - s];
+        if (midi < 0 || midi + num_frets > 127) return std::nullopt;
+        config.open_midi[s] = midi;
+        config.labels[s] = Music::pitchClassToName(
+            static_cast<Music::PitchClass>(midi % Music::SEMITONES_IN_OCTAVE));
+    }
+
+    // Tab convention: the 1st string is lowercase when its name repeats below ("e")
+    for (int s = 1; s < num_strings; ++s) {
+        if (config.labels[s] == config.labels[0]) {
+            for (char& c : config.labels[0]) {
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+            break;
+        }
+    }
+
+    config.rebuildPitchTable();
+    return config;
+}
+
+InstrumentConfig getInstrumentConfig(InstrumentType type) {
+    static const InstrumentConfig guitar = *findInstrumentPreset("guitar");
+    static const InstrumentConfig bass = *findInstrumentPreset("bass");
+    return (type == InstrumentType::Bass) ? bass : guitar;
+}
+
+std::optional<InstrumentConfig> findInstrumentPreset(const std::string& preset) {
+    using Type = InstrumentType;
+    if (preset == "guitar")  return makeInstrument(Type::Guitar, "Electric Guitar", "Standard", {40, 45, 50, 55, 59, 64});
+    if (preset == "guitar7") return makeInstrument(Type::Guitar, "7-String Guitar", "Standard", {35, 40, 45, 50, 55, 59, 64}, 24);
+    if (preset == "guitar8") return makeInstrument(Type::Guitar, "8-String Guitar", "Standard", {30, 35, 40, 45, 50, 55, 59, 64}, 24);
+    if (preset == "drop-d")  return makeInstrument(Type::Guitar, "Electric Guitar", "Drop D", {38, 45, 50, 55, 59, 64});
+    if (preset == "open-g")  return makeInstrument(Type::Guitar, "Electric Guitar", "Open G", {38, 43, 50, 55, 59, 62});
+    if (preset == "open-d")  return makeInstrument(Type::Guitar, "Electric Guitar", "Open D", {38, 45, 50, 54, 57, 62});
+    if (preset == "dadgad")  return makeInstrument(Type::Guitar, "Electric Guitar", "DADGAD", {38, 45, 50, 55, 57, 62});
+    if (preset == "bass")    return makeInstrument(Type::Bass, "Bass Guitar", "Standard", {28, 33, 38, 43});
+    if (preset == "bass5")   return makeInstrument(Type::Bass, "5-String Bass", "Standard", {23, 28, 33, 38, 43}, 24);
+    if (preset == "bass6")   return makeInstrument(Type::Bass, "6-String Bass", "Standard", {23, 28, 33, 38, 43, 48}, 24);
+    return std::nullopt;
+}
+
+std::optional<std::vector<int>> parseTuning(const std::string& text) {
+    std::string normalized = text;
+    for (char& c : normalized) {
+        if (c == ',' || c == '-') c = ' ';
+    }
+
+    std::vector<int> pitches;
+    std::istringstream iss(normalized);
+    std::string token;
+    while (iss >> token) {
+        const int midi = Music::parseMidiNoteName(token);
+        if (midi < 0) return std::nullopt;
+        pitches.push_back(midi);
+    }
+
+    if (pitches.empty()) return std::nullopt;
+    return pitches;
+}
+
+std::string describeTuning(const InstrumentConfig& instrument) {
+    std::string description;
+    for (int s = instrument.num_strings - 1; s >= 0; --s) {
+        description += Music::midiToNoteName(instrument.open_midi[s]);
+        if (s > 0) description += "-";
+    }
+    return description;
+}
+
+namespace {
+
+template<size_t N>
+bool matchesStandard(const InstrumentConfig& instrument, const std::array<int, N>& open_midi) noexcept {
+    if (instrument.num_strings != static_cast<int>(N)) return false;
+    if (instrument.capo != 0 || instrument.num_frets != MAX_FRET) return false;
+    return std::equal(open_midi.begin(), open_midi.end(), instrument.open_midi.begin());
+}
+
+} // namespace
+
+bool isStandardGuitar(const InstrumentConfig& instrument) noexcept {
+    return matchesStandard(instrument, GUITAR_OPEN_STRING_MIDI);
+}
+
+bool isStandardBass(const InstrumentConfig& instrument) noexcept {
+    return matchesStandard(instrument, BASS_OPEN_STRING_MIDI);
+}
+
+// ============================================================================
+// FretboardBitboard Implementation
+// ============================================================================
+
+FretboardBitboard::FretboardBitboard(const InstrumentConfig& instrument, std::uint16_t scale_mask)
+    : scale_{}
+    , pitch_at_least_{} {
+    const int max_fret = instrument.getMaxFret();
+    const std::uint32_t neck = fretRangeRow(MIN_FRET, max_fret);
+
+    for (int s = 0; s < instrument.num_strings; ++s) {
+        const int base = instrument.getPitch(s, MIN_FRET);
+
+        // Scale row: the 12-bit pattern rotated to this string's open pitch class
+        for (int f = MIN_FRET; f <= max_fret; ++f) {
+            if ((scale_mask >> ((base + f) % Music::SEMITONES_IN_OCTAVE)) & 1u) {
+                scale_.set(s, f);
+            }
+        }
+
+        // Pitch p is reached at fret (p - base): keep frets from there up
+        for (int p = 0; p <= NUM_MIDI_PITCHES; ++p) {
+            const int first_fret = p - base;
+            pitch_at_least_[p].rows[s] = (first_fret > max_fret) ? 0u
+                                         : neck & fretRangeRow(std::max(MIN_FRET, first_fret), max_fret);
+        }
+    }
+}
+
+FretMask FretboardBitboard::pitchBandMask(int lo, int hi) const noexcept {
+    FretMask band;
+    for (int s = 0; s < MAX_STRINGS; ++s) {
+        band.rows[s] = pitchBandRow(s, lo, hi);
+    }
+    return band;
+}
+
+// ============================================================================
+// FretboardPitchIndex Implementation
+// ============================================================================
+
+FretboardPitchIndex::FretboardPitchIndex(const InstrumentConfig& instrument) {
+    // Counting sort by pitch; filling in (string, fret) order keeps each
+    // pitch list sorted for the tie-break in findNearest
+    std::array<std::uint16_t, NUM_MIDI_PITCHES> counts{};
+    for (int s = 0; s < instrument.num_strings; ++s) {
+        for (int f = MIN_FRET; f <= instrument.getMaxFret(); ++f) {
+            ++counts[instrument.getPitch(s, f)];
+        }
+    }
+
+    for (int p = 0; p < NUM_MIDI_PITCHES; ++p) {
+        first_[p + 1] = static_cast<std::uint16_t>(first_[p] + counts[p]);
+    }
+    positions_.resize(first_[NUM_MIDI_PITCHES]);
+
+    std::array<std::uint16_t, NUM_MIDI_PITCHES> next{};
+    std::copy(first_.begin(), first_.end() - 1, next.begin());
+    for (int s = 0; s < instrument.num_strings; ++s) {
+        for (int f = MIN_FRET; f <= instrument.getMaxFret(); ++f) {
+            positions_[next[instrument.getPitch(s, f)]++] =
+                FretPosition{static_cast<std::uint8_t>(s), static_cast<std::uint8_t>(f)};
+        }
+    }
+}
+
+std::span<const FretPosition> FretboardPitchIndex::getPositions(int pitch) const noexcept {
+    return getPositionsInRange(pitch, pitch);
+}
+
+std::span<const FretPosition> FretboardPitchIndex::getPositionsInRange(int lo, int hi) const noexcept {
+    lo = std::clamp(lo, 0, NUM_MIDI_PITCHES);
+    hi = std::clamp(hi + 1, lo, NUM_MIDI_PITCHES);
+    return {positions_.data() + first_[lo], positions_.data() + first_[hi]};
+}
+
+std::optional<FretPosition> FretboardPitchIndex::findNearest(int target, int lo, int hi,
+                                                             const FretMask& allowed) const {
+    return findNearestIf(target, lo, hi, [&allowed](int string_idx, int fret) {
+        return allowed.test(string_idx, fret);
+    });
+}
+
 // ============================================================================
 // FretboardValidator Implementation
 // ============================================================================
 
 FretboardValidator::FretboardValidator(const Music::ScaleManager& scale_mgr, InstrumentType instrument)
+    : FretboardValidator(scale_mgr, getInstrumentConfig(instrument)) {}
+
+FretboardValidator::FretboardValidator(const Music::ScaleManager& scale_mgr, const InstrumentConfig& instrument)
     : scale_mgr_{scale_mgr}
-    , instrument_{getInstrumentConfig(instrument)} {}
+    , instrument_{instrument}
+    , bitboard_{instrument, scale_mgr.getPitchClassMask()}
+    , pitch_index_{instrument} {}
+
+std::uint16_t FretboardValidator::getScaleMask() const noexcept {
+    return scale_mgr_.getPitchClassMask();
+}
 
 bool FretboardValidator::isNoteInScale(const Note& note) const {
-    if (!note.isValid()) return false;
-    return scale_mgr_.isMidiPitchValid(note.getMidiPitch());
+    if (!instrument_.containsPosition(note.string_idx.value, note.fret.value)) return false;
+    return scale_mgr_.isMidiPitchValid(note.getMidiPitch(instrument_));
 }
 
 bool FretboardValidator::isAnatomicallyPossible(const Note& from, const Note& to,
@@ -45,10 +264,10 @@ bool FretboardValidator::validateSlidingWindow(const Note& note1, const Note& no
 
 std::vector<Note> FretboardValidator::getAllValidNotes() const {
     std::vector<Note> valid_notes;
-    valid_notes.reserve(instrument_.num_strings * (MAX_FRET + 1) / 2);
+    valid_notes.reserve(instrument_.num_strings * (instrument_.getMaxFret() + 1) / 2);
 
     for (int s = 0; s < instrument_.num_strings; ++s) {
-        for (int f = MIN_FRET; f <= MAX_FRET; ++f) {
+        for (int f = MIN_FRET; f <= instrument_.getMaxFret(); ++f) {
             Note note{{s, instrument_.num_strings}, {f}};
             if (isNoteInScale(note)) {
                 valid_notes.push_back(note);
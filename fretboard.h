@@ -1,9 +1,13 @@
 #ifndef FRETBOARD_H
 #define FRETBOARD_H
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
+#include <optional>
+#include <span>
 #include <string>
+#include <vector>
 #include "music_theory.h"
 
 namespace Guitar {
@@ -13,8 +17,8 @@ namespace Guitar {
 // ============================================================================
 
 enum class InstrumentType {
-    Guitar,  // 6 strings, standard tuning
-    Bass     // 4 strings, standard tuning
+    Guitar,  // Guitar family (6, 7, 8 strings, any tuning)
+    Bass     // Bass family (4, 5, 6 strings, any tuning)
 };
 
 // ============================================================================
@@ -24,7 +28,13 @@ enum class InstrumentType {
 constexpr int GUITAR_NUM_STRINGS = 6;
 constexpr int BASS_NUM_STRINGS = 4;
 constexpr int MIN_FRET = 0;
-constexpr int MAX_FRET = 22;
+constexpr int MAX_FRET = 22;             // Default neck (standard presets)
+
+// Limits for data-driven instruments
+constexpr int MAX_STRINGS = 12;
+constexpr int MAX_SUPPORTED_FRET = 31;   // Frets 0-31 fit one 32-bit row
+constexpr int PITCH_TABLE_STRIDE = MAX_SUPPORTED_FRET + 1;
+constexpr int POSITION_MIN_FRETS = 12;   // Playable frets an instrument must expose
 
 // MIDI values for open strings
 // Guitar: E2=40, A2=45, D3=50, G3=55, B3=59, E4=64
@@ -54,6 +64,107 @@ constexpr std::array<const char*, BASS_NUM_STRINGS> BASS_STRING_LABELS = {
     "G", "D", "A", "E"
 };
 
+// ============================================================================
+// Instrument Configuration - Data-driven descriptor
+// ============================================================================
+
+struct InstrumentConfig {
+    InstrumentType type;
+    int num_strings;
+    std::string name;                              // e.g. "Electric Guitar"
+    std::string tuning_name;                       // e.g. "Standard", "Drop D"
+    std::array<int, MAX_STRINGS> open_midi;        // Open pitch per string (0 = highest)
+    std::array<std::string, MAX_STRINGS> labels;   // Tablature labels
+    int num_frets;                                 // Frets on the neck
+    int capo;                                      // Capo fret (0 = none)
+
+    // Sounding pitch for (string, fret), fret relative to the capo
+    std::array<std::uint8_t, MAX_STRINGS * PITCH_TABLE_STRIDE> pitch_table;
+
+    // Highest playable fret relative to the capo
+    [[nodiscard]] int getMaxFret() const noexcept { return num_frets - capo; }
+
+    // Single indexed load (table precomputed by rebuildPitchTable)
+    [[nodiscard]] int getPitch(int string_idx, int fret) const noexcept {
+        return pitch_table[string_idx * PITCH_TABLE_STRIDE + fret];
+    }
+
+    [[nodiscard]] bool containsPosition(int string_idx, int fret) const noexcept {
+        return string_idx >= 0 && string_idx < num_strings && fret >= MIN_FRET && fret <= getMaxFret();
+    }
+
+    void rebuildPitchTable() noexcept;
+};
+
+// Standard presets (6-string guitar or 4-string bass)
+[[nodiscard]] InstrumentConfig getInstrumentConfig(InstrumentType type);
+
+// Build an instrument from open pitches listed from LOWEST to HIGHEST string
+// (the usual way tunings are written: "E A D G B E")
+// Returns std::nullopt if string count, frets or capo are out of range
+[[nodiscard]] std::optional<InstrumentConfig> makeInstrument(InstrumentType type,
+                                                             const std::string& name,
+                                                             const std::string& tuning_name,
+                                                             const std::vector<int>& low_to_high_midi,
+                                                             int num_frets = MAX_FRET,
+                                                             int capo = 0);
+
+// Named presets: guitar, guitar7, guitar8, bass, bass5, bass6,
+// drop-d, open-g, open-d, dadgad
+[[nodiscard]] std::optional<InstrumentConfig> findInstrumentPreset(const std::string& preset);
+
+// Parse a tuning such as "D2 A2 D3 G3 B3 E4" (lowest string first)
+[[nodiscard]] std::optional<std::vector<int>> parseTuning(const std::string& text);
+
+// Tuning as note names with octave, lowest string first (e.g. "E2-A2-D3-G3-B3-E4")
+[[nodiscard]] std::string describeTuning(const InstrumentConfig& instrument);
+
+// ============================================================================
+// Compile-time Instrument Layouts - Let the generator core fold pitches
+// ============================================================================
+
+// Standard 6-string guitar: string count, open pitches and neck are constants
+struct GuitarLayout {
+    static constexpr int num_strings = GUITAR_NUM_STRINGS;
+    static constexpr int max_fret = MAX_FRET;
+
+    explicit constexpr GuitarLayout(const InstrumentConfig& /* instrument */) noexcept {}
+
+    [[nodiscard]] static constexpr int pitch(int string_idx, int fret) noexcept {
+        return GUITAR_OPEN_STRING_MIDI[string_idx] + fret;
+    }
+};
+
+// Standard 4-string bass
+struct BassLayout {
+    static constexpr int num_strings = BASS_NUM_STRINGS;
+    static constexpr int max_fret = MAX_FRET;
+
+    explicit constexpr BassLayout(const InstrumentConfig& /* instrument */) noexcept {}
+
+    [[nodiscard]] static constexpr int pitch(int string_idx, int fret) noexcept {
+        return BASS_OPEN_STRING_MIDI[string_idx] + fret;
+    }
+};
+
+// Any other tuning, string count, neck or capo (reads the precomputed table)
+struct DynamicLayout {
+    int num_strings;
+    int max_fret;
+    const InstrumentConfig* instrument;
+
+    explicit DynamicLayout(const InstrumentConfig& config) noexcept
+        : num_strings{config.num_strings}, max_fret{config.getMaxFret()}, instrument{&config} {}
+
+    [[nodiscard]] int pitch(int string_idx, int fret) const noexcept {
+        return instrument->getPitch(string_idx, fret);
+    }
+};
+
+// True when the descriptor is exactly the standard preset a static layout encodes
+[[nodiscard]] bool isStandardGuitar(const InstrumentConfig& instrument) noexcept;
+[[nodiscard]] bool isStandardBass(const InstrumentConfig& instrument) noexcept;
+
 // ============================================================================
 // Data Structures
 // ============================================================================
@@ -62,7 +173,7 @@ struct Fret {
     int value;
 
     [[nodiscard]] constexpr bool isValid() const noexcept {
-        return value >= MIN_FRET && value <= MAX_FRET;
+        return value >= MIN_FRET && value <= MAX_SUPPORTED_FRET;
     }
 };
 
@@ -83,46 +194,125 @@ struct Note {
         return string_idx.isValid() && fret.isValid();
     }
 
-    [[nodiscard]] int getMidiPitch() const noexcept {
-        if (string_idx.num_strings == GUITAR_NUM_STRINGS) {
-            return GUITAR_OPEN_STRING_MIDI[string_idx.value] + fret.value;
-        } else {
-            return BASS_OPEN_STRING_MIDI[string_idx.value] + fret.value;
-        }
+    [[nodiscard]] int getMidiPitch(const InstrumentConfig& instrument) const noexcept {
+        return instrument.getPitch(string_idx.value, fret.value);
     }
 
-    [[nodiscard]] Music::PitchClass getPitchClass() const noexcept {
-        return static_cast<Music::PitchClass>(getMidiPitch() % Music::SEMITONES_IN_OCTAVE);
+    [[nodiscard]] Music::PitchClass getPitchClass(const InstrumentConfig& instrument) const noexcept {
+        return static_cast<Music::PitchClass>(getMidiPitch(instrument) % Music::SEMITONES_IN_OCTAVE);
     }
 };
 
 // ============================================================================
-// Instrument Configuration
+// Fretboard Bitboard - One bit per (string, fret)
 // ============================================================================
 
-struct InstrumentConfig {
-    InstrumentType type;
-    int num_strings;
-    std::string name;
+constexpr int NUM_MIDI_PITCHES = 128;
+
+// One 32-bit row per string; bit f set = fret f belongs to the set
+struct FretMask {
+    std::array<std::uint32_t, MAX_STRINGS> rows{};
 
-    [[nodiscard]] const std::array<int, 6>& getOpenStringMidi() const {
-        static const std::array<int, 6> guitar_midi = GUITAR_OPEN_STRING_MIDI;
-        static const std::array<int, 6> bass_midi = {43, 38, 33, 28, 0, 0};
-        return (type == InstrumentType::Guitar) ? guitar_midi : bass_midi;
+    [[nodiscard]] bool test(int string_idx, int fret) const noexcept {
+        return (rows[string_idx] >> fret) & 1u;
     }
 
-    [[nodiscard]] const std::array<const char*, 6>& getStringLabels() const {
-        static const std::array<const char*, 6> guitar_labels = GUITAR_STRING_LABELS;
-        static const std::array<const char*, 6> bass_labels = {"G", "D", "A", "E", "", ""};
-        return (type == InstrumentType::Guitar) ? guitar_labels : bass_labels;
+    void set(int string_idx, int fret) noexcept { rows[string_idx] |= (1u << fret); }
+    void reset(int string_idx, int fret) noexcept { rows[string_idx] &= ~(1u << fret); }
+};
+
+// Frets in [min_fret, max_fret] as a row pattern (shared by every string)
+[[nodiscard]] constexpr std::uint32_t fretRangeRow(int min_fret, int max_fret) noexcept {
+    if (min_fret > max_fret) return 0;
+    const std::uint32_t upto_max = (max_fret >= 31) ? 0xFFFFFFFFu : ((1u << (max_fret + 1)) - 1);
+    const std::uint32_t below_min = (min_fret <= 0) ? 0u : ((1u << min_fret) - 1);
+    return upto_max & ~below_min;
+}
+
+// Precomputed masks for one (instrument, key, scale):
+//   - scale mask: every in-scale position on the neck
+//   - pitch-at-least masks: rows of positions sounding >= p, so the band
+//     for any window [lo, hi] is atLeast(lo) & ~atLeast(hi + 1)
+class FretboardBitboard {
+public:
+    FretboardBitboard(const InstrumentConfig& instrument, std::uint16_t scale_mask);
+
+    [[nodiscard]] const FretMask& getScaleMask() const noexcept { return scale_; }
+
+    // Row of positions on `string_idx` sounding within [lo, hi] (bounds clamped)
+    [[nodiscard]] std::uint32_t pitchBandRow(int string_idx, int lo, int hi) const noexcept {
+        lo = std::clamp(lo, 0, NUM_MIDI_PITCHES);
+        hi = std::clamp(hi + 1, 0, NUM_MIDI_PITCHES);
+        return pitch_at_least_[lo].rows[string_idx] & ~pitch_at_least_[hi].rows[string_idx];
     }
+
+    [[nodiscard]] FretMask pitchBandMask(int lo, int hi) const noexcept;
+
+private:
+    FretMask scale_;
+    std::array<FretMask, NUM_MIDI_PITCHES + 1> pitch_at_least_;  // [128] is empty
 };
 
-[[nodiscard]] constexpr InstrumentConfig getInstrumentConfig(InstrumentType type) {
-    if (type == InstrumentType::Bass) {
-        return {InstrumentType::Bass, BASS_NUM_STRINGS, "Bass"};
+// ============================================================================
+// Fretboard Pitch Index - Every position ordered by sounding pitch
+// ============================================================================
+
+struct FretPosition {
+    std::uint8_t string_idx;
+    std::uint8_t fret;
+};
+
+// Positions sorted by (pitch, string, fret) plus one offset per pitch, so a
+// single pitch or a whole pitch range is one contiguous span
+class FretboardPitchIndex {
+public:
+    explicit FretboardPitchIndex(const InstrumentConfig& instrument);
+
+    [[nodiscard]] std::span<const FretPosition> getPositions(int pitch) const noexcept;
+    [[nodiscard]] std::span<const FretPosition> getPositionsInRange(int lo, int hi) const noexcept;
+
+    // Position nearest in pitch to `target` among the pitches in [lo, hi]
+    // accepted by accept(string, fret). Equal distances resolve to the first
+    // position in (string, fret) order, as a full neck scan would.
+    template<typename Accept>
+    [[nodiscard]] std::optional<FretPosition> findNearestIf(int target, int lo, int hi, Accept&& accept) const;
+
+    // Same, restricted to the positions set in `allowed`
+    [[nodiscard]] std::optional<FretPosition> findNearest(int target, int lo, int hi,
+                                                          const FretMask& allowed) const;
+
+private:
+    std::vector<FretPosition> positions_;
+    std::array<std::uint16_t, NUM_MIDI_PITCHES + 1> first_{};  // positions_ offset per pitch
+};
+
+template<typename Accept>
+std::optional<FretPosition> FretboardPitchIndex::findNearestIf(int target, int lo, int hi, Accept&& accept) const {
+    lo = std::max(lo, 0);
+    hi = std::min(hi, NUM_MIDI_PITCHES - 1);
+    if (lo > hi) return std::nullopt;
+    target = std::clamp(target, lo, hi);
+
+    // Walk outward one semitone at a time; each pitch list is already in
+    // (string, fret) order, so its first accepted position is its best
+    for (int distance = 0; target - distance >= lo || target + distance <= hi; ++distance) {
+        std::optional<FretPosition> best;
+        const int pitches[2] = {target - distance, target + distance};
+        for (int side = 0; side < (distance == 0 ? 1 : 2); ++side) {
+            const int pitch = pitches[side];
+            if (pitch < lo || pitch > hi) continue;
+            for (const auto& position : getPositions(pitch)) {
+                if (!accept(position.string_idx, position.fret)) continue;
+                if (!best || position.string_idx < best->string_idx ||
+                    (position.string_idx == best->string_idx && position.fret < best->fret)) {
+                    best = position;
+                }
+                break;
+            }
+        }
+        if (best) return best;
     }
-    return {InstrumentType::Guitar, GUITAR_NUM_STRINGS, "Guitar"};
+    return std::nullopt;
 }
 
 // ============================================================================
@@ -132,13 +322,26 @@ struct InstrumentConfig {
 class FretboardValidator {
 public:
     explicit FretboardValidator(const Music::ScaleManager& scale_mgr, InstrumentType instrument);
+    FretboardValidator(const Music::ScaleManager& scale_mgr, const InstrumentConfig& instrument);
 
     // Get instrument configuration
     [[nodiscard]] const InstrumentConfig& getInstrument() const noexcept { return instrument_; }
 
+    // Key and scale the validator was built for
+    [[nodiscard]] const Music::ScaleManager& getScaleManager() const noexcept { return scale_mgr_; }
+
     // Check if a note is valid for current scale
     [[nodiscard]] bool isNoteInScale(const Note& note) const;
 
+    // Current scale as a 12-bit pitch-class mask (bit 0 = C)
+    [[nodiscard]] std::uint16_t getScaleMask() const noexcept;
+
+    // Bitboard of in-scale positions and pitch bands (built once per validator)
+    [[nodiscard]] const FretboardBitboard& getBitboard() const noexcept { return bitboard_; }
+
+    // Every position of the instrument by pitch (nearest-pitch / range queries)
+    [[nodiscard]] const FretboardPitchIndex& getPitchIndex() const noexcept { return pitch_index_; }
+
     // Check if two notes are anatomically possible to play consecutively
     [[nodiscard]] bool isAnatomicallyPossible(const Note& from, const Note& to,
                                                int max_fret_delta = 3) const;
@@ -153,6 +356,8 @@ public:
 private:
     const Music::ScaleManager& scale_mgr_;
     InstrumentConfig instrument_;
+    FretboardBitboard bitboard_;
+    FretboardPitchIndex pitch_index_;
 };
 
 } // namespace Guitar
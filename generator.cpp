@@ -1,6 +1,10 @@
 #include "generator.h"
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <fstream>
 #include <limits>
+#include <sstream>
 
 namespace Guitar {
 
@@ -8,25 +12,312 @@ namespace Guitar {
 // PositionBox Implementation
 // ============================================================================
 
-void PositionBox::initialize(int first_fret) {
+void PositionBox::initialize(int first_fret, int neck_max_fret, int radius) {
     anchor_fret = first_fret;
-    min_fret = std::max(MIN_FRET, anchor_fret - POSITION_BOX_RADIUS);
-    max_fret = std::min(MAX_FRET, anchor_fret + POSITION_BOX_RADIUS);
+    min_fret = std::max(MIN_FRET, anchor_fret - radius);
+    max_fret = std::min(neck_max_fret, anchor_fret + radius);
 }
 
 // ============================================================================
-// NoteGenerator Implementation
+// GeneratorProfile Implementation
 // ============================================================================
 
-NoteGenerator::NoteGenerator(const FretboardValidator& validator)
+namespace {
+
+struct ProfileKey {
+    const char* key;
+    int GeneratorProfile::* field;
+};
+
+constexpr std::array<ProfileKey, 9> PROFILE_KEYS = {{
+    {"box_radius",        &GeneratorProfile::position_box_radius},
+    {"local_range",       &GeneratorProfile::max_local_range},
+    {"global_range",      &GeneratorProfile::max_global_range},
+    {"local_window",      &GeneratorProfile::local_window_size},
+    {"weight_close",      &GeneratorProfile::weight_close},
+    {"weight_medium",     &GeneratorProfile::weight_medium},
+    {"weight_far",        &GeneratorProfile::weight_far},
+    {"max_same_string",   &GeneratorProfile::max_consecutive_same_string},
+    {"same_string_bonus", &GeneratorProfile::same_string_bonus},
+}};
+
+std::string trim(const std::string& text) {
+    const auto first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) return "";
+    const auto last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+} // namespace
+
+std::optional<GeneratorProfile> findGeneratorProfile(const std::string& name) {
+    if (name == "standard") return STANDARD_PROFILE;
+    if (name == "beginner") return BEGINNER_PROFILE;
+    if (name == "advanced") return ADVANCED_PROFILE;
+    return std::nullopt;
+}
+
+std::string describeProfile(const GeneratorProfile& profile) {
+    if (profile == STANDARD_PROFILE) return "standard";
+    if (profile == BEGINNER_PROFILE) return "beginner";
+    if (profile == ADVANCED_PROFILE) return "advanced";
+    return "custom";
+}
+
+bool isValidProfile(const GeneratorProfile& profile) noexcept {
+    auto within = [](int value, int lo, int hi) { return value >= lo && value <= hi; };
+    return within(profile.position_box_radius, 1, MAX_PROFILE_BOX_RADIUS) &&
+           within(profile.max_local_range, 1, MAX_PROFILE_RANGE) &&
+           within(profile.max_global_range, 1, MAX_PROFILE_RANGE) &&
+           within(profile.local_window_size, 1, MAX_PROFILE_WINDOW_SIZE) &&
+           within(profile.weight_close, 0, MAX_PROFILE_WEIGHT) &&
+           within(profile.weight_medium, 0, MAX_PROFILE_WEIGHT) &&
+           within(profile.weight_far, 0, MAX_PROFILE_WEIGHT) &&
+           within(profile.max_consecutive_same_string, 1, NUM_NOTES) &&
+           within(profile.same_string_bonus, 0, MAX_PROFILE_BONUS);
+}
+
+std::vector<std::string> getProfileKeys() {
+    std::vector<std::string> keys;
+    for (const auto& entry : PROFILE_KEYS) keys.emplace_back(entry.key);
+    return keys;
+}
+
+bool setProfileValue(GeneratorProfile& profile, const std::string& key, const std::string& value) {
+    for (const auto& entry : PROFILE_KEYS) {
+        if (key != entry.key) continue;
+        try {
+            std::size_t used = 0;
+            const int parsed = std::stoi(value, &used);
+            if (used != value.size()) return false;
+            profile.*entry.field = parsed;
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+    return false;
+}
+
+std::optional<GeneratorProfile> loadGeneratorProfile(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) return std::nullopt;
+
+    GeneratorProfile profile = STANDARD_PROFILE;
+    std::string line;
+    while (std::getline(in, line)) {
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+
+        const auto equals = line.find('=');
+        if (equals == std::string::npos) return std::nullopt;
+        const std::string key = trim(line.substr(0, equals));
+        const std::string value = trim(line.substr(equals + 1));
+
+        if (key == "profile") {
+            auto preset = findGeneratorProfile(value);
+            if (!preset) return std::nullopt;
+            profile = *preset;
+        } else if (!setProfileValue(profile, key, value)) {
+            return std::nullopt;
+        }
+    }
+
+    if (!isValidProfile(profile)) return std::nullopt;
+    return profile;
+}
+
+// ============================================================================
+// WeightTable Implementation
+// ============================================================================
+
+WeightTable& WeightTable::getInstance() {
+    static WeightTable instance;
+    return instance;
+}
+
+WeightTable::WeightTable(const GeneratorProfile& base) : base_{base} {}
+
+void WeightTable::set(const std::string& scale, const ScaleWeights& weights) {
+    weights_[scale] = weights;
+}
+
+void WeightTable::clear() noexcept {
+    base_ = STANDARD_PROFILE;
+    weights_.clear();
+}
+
+GeneratorProfile WeightTable::apply(const GeneratorProfile& profile, const std::string& scale) const {
+    if (weights_.empty() || profile != base_) return profile;
+    const auto it = weights_.find(scale);
+    if (it == weights_.end()) return profile;
+
+    GeneratorProfile fitted = profile;
+    fitted.weight_close = it->second.weight_close;
+    fitted.weight_medium = it->second.weight_medium;
+    fitted.weight_far = it->second.weight_far;
+    fitted.same_string_bonus = it->second.same_string_bonus;
+    return fitted;
+}
+
+bool WeightTable::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    GeneratorProfile base = STANDARD_PROFILE;
+    std::map<std::string, ScaleWeights> weights;
+    std::string line;
+    while (std::getline(in, line)) {
+        // Whole-line comments only: scale names may contain '#' ("Arabian #1")
+        line = trim(line);
+        if (line.empty() || line.front() == '#') continue;
+
+        const auto equals = line.rfind('=');
+        if (equals == std::string::npos) return false;
+        const std::string key = trim(line.substr(0, equals));
+        const std::string value = trim(line.substr(equals + 1));
+
+        if (key.rfind("scale ", 0) == 0) {
+            ScaleWeights entry{};
+            std::istringstream fields(value);
+            std::string extra;
+            if (!(fields >> entry.weight_close >> entry.weight_medium >> entry.weight_far >>
+                  entry.same_string_bonus) || (fields >> extra)) {
+                return false;
+            }
+            GeneratorProfile check = base;
+            check.weight_close = entry.weight_close;
+            check.weight_medium = entry.weight_medium;
+            check.weight_far = entry.weight_far;
+            check.same_string_bonus = entry.same_string_bonus;
+            if (!isValidProfile(check)) return false;
+            weights[trim(key.substr(6))] = entry;
+        } else if (!setProfileValue(base, key, value)) {
+            return false;
+        }
+    }
+
+    if (!isValidProfile(base)) return false;
+    base_ = base;
+    weights_ = std::move(weights);
+    return true;
+}
+
+void WeightTable::write(std::ostream& out) const {
+    out << "# Base profile (" << describeProfile(base_) << ")\n";
+    for (const auto& entry : PROFILE_KEYS) {
+        out << entry.key << " = " << base_.*entry.field << "\n";
+    }
+    out << "\n# scale <name> = <weight_close> <weight_medium> <weight_far> <same_string_bonus>\n";
+    for (const auto& [scale, weights] : weights_) {
+        out << "scale " << scale << " = " << weights.weight_close << " " << weights.weight_medium << " "
+            << weights.weight_far << " " << weights.same_string_bonus << "\n";
+    }
+}
+
+// ============================================================================
+// LayoutNoteGenerator Implementation
+// ============================================================================
+
+namespace {
+
+const TransitionModel* activeModel(const FretboardValidator& validator) {
+    const TransitionModel& model = TransitionModel::getInstance();
+    return model.appliesTo(validator.getInstrument().num_strings) ? &model : nullptr;
+}
+
+} // namespace
+
+template<typename Layout, typename Profile>
+LayoutNoteGenerator<Layout, Profile>::LayoutNoteGenerator(const FretboardValidator& validator,
+                                                          const GeneratorProfile& profile)
     : validator_{validator}
+    , layout_{validator.getInstrument()}
+    , profile_{profile}
+    , scale_mask_{validator.getScaleMask()}
+    , bitboard_{validator.getBitboard()}
+    , pitch_index_{validator.getPitchIndex()}
+    , model_{activeModel(validator)}
+    , context_{}
+    , rules_{RuleSet::getInstance().compile(validator.getInstrument(),
+                                            validator.getScaleManager().getCurrentKeyIndex())}
     , rng_{}
     , valid_notes_cache_{validator.getAllValidNotes()}
     , position_box_{}
     , global_min_pitch_{std::numeric_limits<int>::max()}
-    , global_max_pitch_{std::numeric_limits<int>::min()} {}
+    , global_max_pitch_{std::numeric_limits<int>::min()}
+    , stats_{} {}
+
+template<typename Layout, typename Profile>
+LayoutNoteGenerator<Layout, Profile>::LayoutNoteGenerator(const FretboardValidator& validator, std::uint32_t seed)
+    : LayoutNoteGenerator(validator, STANDARD_PROFILE, seed) {}
 
-std::vector<std::unique_ptr<Note>> NoteGenerator::generateTablature() {
+template<typename Layout, typename Profile>
+LayoutNoteGenerator<Layout, Profile>::LayoutNoteGenerator(const FretboardValidator& validator,
+                                                          const GeneratorProfile& profile,
+                                                          std::uint32_t seed)
+    : validator_{validator}
+    , layout_{validator.getInstrument()}
+    , profile_{profile}
+    , scale_mask_{validator.getScaleMask()}
+    , bitboard_{validator.getBitboard()}
+    , pitch_index_{validator.getPitchIndex()}
+    , model_{activeModel(validator)}
+    , context_{}
+    , rules_{RuleSet::getInstance().compile(validator.getInstrument(),
+                                            validator.getScaleManager().getCurrentKeyIndex())}
+    , rng_{seed}
+    , valid_notes_cache_{validator.getAllValidNotes()}
+    , position_box_{}
+    , global_min_pitch_{std::numeric_limits<int>::max()}
+    , global_max_pitch_{std::numeric_limits<int>::min()}
+    , stats_{} {}
+
+template<typename Layout, typename Profile>
+std::vector<std::unique_ptr<Note>> LayoutNoteGenerator<Layout, Profile>::generateTablature() {
+    ++stats_.exercises;
+
+    // The step masks already keep every note legal; what they cannot see
+    // (start/end notes the box misses, whole-exercise counts) is settled
+    // by generating again. So is a step the rules left without candidates:
+    // the fallbacks would break the string-run and repeat rules. Each
+    // attempt counts its own fallbacks; only the kept one's stay counted.
+    const GeneratorStats before = stats_;
+    std::vector<std::unique_ptr<Note>> best;
+    GeneratorStats best_stats{};
+    int best_broken = 0;
+    long long best_fallbacks = 0;
+    for (int attempt = 1; attempt <= MAX_RULE_ATTEMPTS; ++attempt) {
+        stats_ = before;
+        auto notes = generateAttempt();
+        if (!rules_.active) return notes;
+        const long long step_fallbacks = stats_.nearest_fallbacks + stats_.ultimate_fallbacks -
+                                         before.nearest_fallbacks - before.ultimate_fallbacks;
+        const long long fallbacks = step_fallbacks + stats_.first_note_fallbacks - before.first_note_fallbacks;
+        const int violations = rules_.violations(notes, validator_.getInstrument());
+        if (violations == 0 && step_fallbacks == 0) {
+            stats_.rule_retries += attempt - 1;
+            return notes;
+        }
+        // Otherwise the closest so far: fewest broken rules, then fewest
+        // fallbacks. A step fallback breaks the generator's own string-run
+        // or repeat rule, so it counts as a broken rule too.
+        const int broken = violations + static_cast<int>(step_fallbacks);
+        if (best.empty() || broken < best_broken || (broken == best_broken && fallbacks < best_fallbacks)) {
+            best = std::move(notes);
+            best_stats = stats_;
+            best_broken = broken;
+            best_fallbacks = fallbacks;
+        }
+    }
+    stats_ = best_stats;
+    stats_.rule_retries += MAX_RULE_ATTEMPTS - 1;
+    ++stats_.rule_failures;
+    return best;
+}
+
+template<typename Layout, typename Profile>
+std::vector<std::unique_ptr<Note>> LayoutNoteGenerator<Layout, Profile>::generateAttempt() {
     std::vector<std::unique_ptr<Note>> notes;
     notes.reserve(NUM_NOTES);
 
@@ -36,7 +327,7 @@ std::vector<std::unique_ptr<Note>> NoteGenerator::generateTablature() {
 
     // Generate first note and initialize Position Box
     auto first_note = generateFirstNote();
-    position_box_.initialize(first_note->fret.value);
+    position_box_.initialize(first_note->fret.value, layout_.max_fret, profile_.rules.position_box_radius);
     
     // Update global pitch range with first note
     int first_pitch = getNotePitch(*first_note);
@@ -51,8 +342,8 @@ std::vector<std::unique_ptr<Note>> NoteGenerator::generateTablature() {
     for (int i = 1; i < NUM_NOTES; ++i) {
         const Note& previous = *notes[i - 1];
 
-        // Force string change after 3 consecutive notes on same string
-        const bool must_change_string = (consecutive_same_string >= MAX_CONSECUTIVE_SAME_STRING);
+        // Force string change after N consecutive notes on same string (3 by default)
+        const bool must_change_string = (consecutive_same_string >= profile_.rules.max_consecutive_same_string);
 
         auto next_note = generateNextNote(previous, consecutive_same_string, must_change_string, notes);
 
@@ -74,36 +365,55 @@ std::vector<std::unique_ptr<Note>> NoteGenerator::generateTablature() {
     return notes;
 }
 
-std::unique_ptr<Note> NoteGenerator::generateFirstNote() {
+template<typename Layout, typename Profile>
+std::unique_ptr<Note> LayoutNoteGenerator<Layout, Profile>::generateFirstNote() {
     auto note = std::make_unique<Note>();
 
     // Prefer middle strings and frets for ergonomic starting position
-    note->string_idx.value = rng_.generateInt(1, validator_.getInstrument().num_strings - 2);
+    note->string_idx.value = rng_.generateInt(1, layout_.num_strings - 2);
     note->fret.value = rng_.generateInt(5, 12);
-    note->string_idx.num_strings = validator_.getInstrument().num_strings;
+    note->string_idx.num_strings = layout_.num_strings;
 
-    // Ensure note is in scale
+    // Ensure note is in scale (and allowed as a first note by the rules)
+    auto acceptable = [&] {
+        return isPitchInScale(getNotePitch(*note)) && rules_.first.test(note->string_idx.value, note->fret.value);
+    };
     int attempts = 0;
-    while (!validator_.isNoteInScale(*note) && attempts < 50) {
-        note->string_idx.value = rng_.generateInt(1, validator_.getInstrument().num_strings - 2);
+    while (!acceptable() && attempts < 50) {
+        note->string_idx.value = rng_.generateInt(1, layout_.num_strings - 2);
         note->fret.value = rng_.generateInt(5, 12);
         attempts++;
     }
 
-    // Fallback: find any valid note
-    if (!validator_.isNoteInScale(*note) && !valid_notes_cache_.empty()) {
-        *note = valid_notes_cache_[rng_.generateInt(0, static_cast<int>(valid_notes_cache_.size()) - 1)];
+    // Fallback: find any valid note (among the ones the rules allow first, if any)
+    if (!acceptable() && !valid_notes_cache_.empty()) {
+        ++stats_.first_note_fallbacks;
+        std::vector<const Note*> allowed;
+        if (rules_.active) {
+            for (const auto& valid : valid_notes_cache_) {
+                if (rules_.first.test(valid.string_idx.value, valid.fret.value)) allowed.push_back(&valid);
+            }
+        }
+        *note = allowed.empty()
+            ? valid_notes_cache_[rng_.generateInt(0, static_cast<int>(valid_notes_cache_.size()) - 1)]
+            : *allowed[rng_.generateInt(0, static_cast<int>(allowed.size()) - 1)];
     }
 
     return note;
 }
 
-std::unique_ptr<Note> NoteGenerator::generateNextNote(
+template<typename Layout, typename Profile>
+std::unique_ptr<Note> LayoutNoteGenerator<Layout, Profile>::generateNextNote(
     const Note& previous,
-    int /* consecutive_same_string */,
+    int consecutive_same_string,
     bool must_change_string,
     const std::vector<std::unique_ptr<Note>>& previous_notes
 ) {
+    if (model_) {
+        const Note* before = previous_notes.size() >= 2 ? previous_notes[previous_notes.size() - 2].get() : nullptr;
+        model_->findContext(previous, before, consecutive_same_string, context_);
+    }
+
     // Build list of valid candidates with weights (includes pitch validation)
     auto candidates = buildCandidates(previous, must_change_string, position_box_, previous_notes);
 
@@ -112,19 +422,21 @@ std::unique_ptr<Note> NoteGenerator::generateNextNote(
         // Try to find the closest valid note by pitch
         auto fallback_note = findClosestPitchNote(previous, previous_notes);
         if (fallback_note) {
+            ++stats_.nearest_fallbacks;
             return fallback_note;
         }
         
         // Ultimate fallback: adjacent string, same fret
+        ++stats_.ultimate_fallbacks;
         auto note = std::make_unique<Note>();
-        note->string_idx.value = (previous.string_idx.value < validator_.getInstrument().num_strings / 2) ?
+        note->string_idx.value = (previous.string_idx.value < layout_.num_strings / 2) ?
                                  previous.string_idx.value + 1 : previous.string_idx.value - 1;
         note->fret.value = previous.fret.value;
-        note->string_idx.num_strings = validator_.getInstrument().num_strings;
+        note->string_idx.num_strings = layout_.num_strings;
 
         if (note->string_idx.value < 0) note->string_idx.value = 0;
-        if (note->string_idx.value >= validator_.getInstrument().num_strings)
-            note->string_idx.value = validator_.getInstrument().num_strings - 1;
+        if (note->string_idx.value >= layout_.num_strings)
+            note->string_idx.value = layout_.num_strings - 1;
 
         return note;
     }
@@ -145,171 +457,237 @@ std::unique_ptr<Note> NoteGenerator::generateNextNote(
     return note;
 }
 
-std::vector<NoteCandidate> NoteGenerator::buildCandidates(
+template<typename Layout, typename Profile>
+std::vector<NoteCandidate> LayoutNoteGenerator<Layout, Profile>::buildCandidates(
     const Note& previous,
     bool must_change_string,
     const PositionBox& box,
     const std::vector<std::unique_ptr<Note>>& previous_notes
 ) {
     std::vector<NoteCandidate> candidates;
-    const int num_strings = validator_.getInstrument().num_strings;
-
-    // Determine which strings to consider
-    std::vector<int> strings_to_check;
-
-    if (must_change_string) {
-        // Must change string - but can skip to ANY string (free string skipping)
-        for (int s = 0; s < num_strings; ++s) {
-            if (s != previous.string_idx.value) {
-                strings_to_check.push_back(s);
-            }
-        }
-    } else {
-        // Can stay on same string or jump to any other string
-        for (int s = 0; s < num_strings; ++s) {
-            strings_to_check.push_back(s);
+    const int num_strings = layout_.num_strings;
+    candidates.reserve(static_cast<size_t>(num_strings) * (box.max_fret - box.min_fret + 1));
+
+    // Every rule is a pitch or fret window, so the candidate set is an AND of
+    // precomputed masks: scale & Position Box & local band & global band
+    const PitchBand band = getAllowedPitchBand(previous_notes);
+    const std::uint32_t box_row = fretRangeRow(box.min_fret, box.max_fret);
+    const FretMask& scale = bitboard_.getScaleMask();
+    const FretMask& step = stepRules(previous_notes);
+
+    // Free string skipping: every string is eligible; when a change is forced
+    // only the previous string is excluded. The bound is a constant for
+    // static layouts, so this loop unrolls.
+    for (int str = 0; str < num_strings; ++str) {
+        std::uint32_t row = scale.rows[str] & box_row & step.rows[str] &
+                            bitboard_.pitchBandRow(str, band.local_lo, band.local_hi) &
+                            bitboard_.pitchBandRow(str, band.global_lo, band.global_hi);
+
+        if (str == previous.string_idx.value) {
+            // Same note as previous is never allowed; the whole string is
+            // off-limits after max_consecutive_same_string notes
+            row = must_change_string ? 0u : row & ~(1u << previous.fret.value);
         }
-    }
-
-    // For each string, find valid fret candidates within Position Box
-    for (int str : strings_to_check) {
-        // Check all frets within the Position Box
-        for (int fret = box.min_fret; fret <= box.max_fret; ++fret) {
-            // Skip if same note as previous (must be different)
-            if (str == previous.string_idx.value && fret == previous.fret.value) continue;
 
-            Note candidate_note{{str, num_strings}, {fret}};
-
-            // Check if note is in scale
-            if (!validator_.isNoteInScale(candidate_note)) continue;
-
-            // PITCH CONTROL VALIDATION
-            int candidate_pitch = getNotePitch(candidate_note);
-
-            // Rule 1: Local range (last 4 notes + candidate must fit in 1 octave)
-            if (!isValidForLocalRange(candidate_note, previous_notes)) continue;
-
-            // Rule 2: Global range (entire exercise must fit in 2 octaves)
-            if (!isValidForGlobalRange(candidate_pitch)) continue;
+        // Ascending fret order (ctz) keeps the candidate order of the scan
+        while (row != 0) {
+            const int fret = std::countr_zero(row);
+            row &= row - 1;
 
             // Calculate fret distance from previous note for weighting
             int fret_distance = std::abs(fret - previous.fret.value);
 
-            // Calculate weight based on distance
-            int weight = calculateWeight(fret_distance);
-
-            // Bonus for staying on same string (promotes fluency when possible)
-            if (str == previous.string_idx.value) {
-                weight = static_cast<int>(weight * 1.2);  // 20% bonus
+            // Calculate weight based on distance (+20% on the same string by
+            // default), or the learned probability of this move. The model
+            // keeps the profile's reach: a jump beyond it stays at 0.
+            int weight = 0;
+            if (!model_) {
+                weight = calculateWeight(fret_distance, str == previous.string_idx.value);
+            } else if (classifyFretDistance(fret_distance, profile_.rules.position_box_radius) !=
+                       DistanceClass::OutOfBox) {
+                weight = TransitionModel::weight(context_, str - previous.string_idx.value, fret - previous.fret.value);
             }
+            weight = rules_.adjustWeight(weight, str, fret);
 
-            candidates.push_back({candidate_note, weight, fret_distance});
+            candidates.push_back({{{str, num_strings}, {fret}}, weight, fret_distance});
         }
     }
 
     return candidates;
 }
 
-int NoteGenerator::calculateWeight(int fret_distance) const {
-    // Weight system based on comfort level
-    switch (fret_distance) {
-        case 0:
-            // Same fret, different string (very comfortable)
-            return WEIGHT_CLOSE;
-        case 1:
-            // 1 fret distance (very comfortable)
-            return WEIGHT_CLOSE;
-        case 2:
-            // 2 frets distance (comfortable)
-            return WEIGHT_CLOSE;
-        case 3:
-            // 3 frets distance (moderate)
-            return WEIGHT_MEDIUM;
-        case 4:
-            // 4 frets distance (stretch - use sparingly)
-            return WEIGHT_FAR;
-        default:
-            // Should not reach here within Position Box
-            return 0;
-    }
+template<typename Layout, typename Profile>
+int LayoutNoteGenerator<Layout, Profile>::calculateWeight(int fret_distance, bool same_string) const {
+    // Comfort buckets (0-2 / 3 / 4 frets) weighted by the profile
+    return profile_.rules.weightFor(fret_distance, same_string);
 }
 
-bool NoteGenerator::isValidForLocalRange(
-    const Note& candidate,
-    const std::vector<std::unique_ptr<Note>>& previous_notes
+template<typename Layout, typename Profile>
+bool LayoutNoteGenerator<Layout, Profile>::getLocalWindowRange(
+    const std::vector<std::unique_ptr<Note>>& previous_notes,
+    int& min_pitch,
+    int& max_pitch
 ) const {
-    if (previous_notes.empty()) return true;
+    if (previous_notes.empty()) return false;
 
-    // Get the last LOCAL_WINDOW_SIZE notes (or fewer if not enough)
-    size_t start_idx = previous_notes.size() > LOCAL_WINDOW_SIZE
-                       ? previous_notes.size() - LOCAL_WINDOW_SIZE
+    // Get the last local_window_size notes (or fewer if not enough)
+    const size_t window_size = static_cast<size_t>(profile_.rules.local_window_size);
+    size_t start_idx = previous_notes.size() > window_size
+                       ? previous_notes.size() - window_size
                        : 0;
 
-    int candidate_pitch = getNotePitch(candidate);
-    int min_pitch = candidate_pitch;
-    int max_pitch = candidate_pitch;
-
-    // Check against the last N notes
+    min_pitch = std::numeric_limits<int>::max();
+    max_pitch = std::numeric_limits<int>::min();
     for (size_t i = start_idx; i < previous_notes.size(); ++i) {
         int pitch = getNotePitch(*previous_notes[i]);
         if (pitch < min_pitch) min_pitch = pitch;
         if (pitch > max_pitch) max_pitch = pitch;
     }
+    return true;
+}
 
-    // Local range must not exceed 1 octave (12 semitones)
-    return (max_pitch - min_pitch) <= MAX_LOCAL_RANGE;
+template<typename Layout, typename Profile>
+int LayoutNoteGenerator<Layout, Profile>::getNotePitch(const Note& note) const {
+    return layout_.pitch(note.string_idx.value, note.fret.value);
 }
 
-bool NoteGenerator::isValidForGlobalRange(int candidate_pitch) const {
-    // Calculate what the new global range would be
-    int new_min = candidate_pitch < global_min_pitch_ ? candidate_pitch : global_min_pitch_;
-    int new_max = candidate_pitch > global_max_pitch_ ? candidate_pitch : global_max_pitch_;
+template<typename Layout, typename Profile>
+bool LayoutNoteGenerator<Layout, Profile>::isPitchInScale(int midi_pitch) const {
+    return (scale_mask_ >> (midi_pitch % Music::SEMITONES_IN_OCTAVE)) & 1u;
+}
 
-    // Global range must not exceed 2 octaves (24 semitones)
-    return (new_max - new_min) <= MAX_GLOBAL_RANGE;
+template<typename Layout, typename Profile>
+const FretMask& LayoutNoteGenerator<Layout, Profile>::stepRules(
+    const std::vector<std::unique_ptr<Note>>& previous_notes
+) const {
+    return previous_notes.size() + 1 == static_cast<std::size_t>(NUM_NOTES) ? rules_.last : rules_.allowed;
 }
 
-int NoteGenerator::getNotePitch(const Note& note) const {
-    return validator_.getInstrument().getOpenStringMidi()[note.string_idx.value] + note.fret.value;
+template<typename Layout, typename Profile>
+PitchBand LayoutNoteGenerator<Layout, Profile>::getAllowedPitchBand(
+    const std::vector<std::unique_ptr<Note>>& previous_notes
+) const {
+    PitchBand band{0, NUM_MIDI_PITCHES, 0, NUM_MIDI_PITCHES};
+
+    // Rule 1: Local range (last 4 notes + candidate must fit in 1 octave by default).
+    // An over-wide window yields lo > hi, i.e. an empty band.
+    int window_min = 0;
+    int window_max = 0;
+    if (getLocalWindowRange(previous_notes, window_min, window_max)) {
+        band.local_lo = window_max - profile_.rules.max_local_range;
+        band.local_hi = window_min + profile_.rules.max_local_range;
+    }
+
+    // Rule 2: Global range (entire exercise must fit in 2 octaves by default)
+    if (global_min_pitch_ <= global_max_pitch_) {
+        band.global_lo = global_max_pitch_ - profile_.rules.max_global_range;
+        band.global_hi = global_min_pitch_ + profile_.rules.max_global_range;
+    }
+
+    // "max-leap" rule: within that many semitones of the previous note
+    if (rules_.max_leap < NO_LEAP_LIMIT && !previous_notes.empty()) {
+        const int previous = getNotePitch(*previous_notes.back());
+        band.local_lo = std::max(band.local_lo, previous - rules_.max_leap);
+        band.local_hi = std::min(band.local_hi, previous + rules_.max_leap);
+    }
+
+    return band;
 }
 
-std::unique_ptr<Note> NoteGenerator::findClosestPitchNote(
+template<typename Layout, typename Profile>
+std::unique_ptr<Note> LayoutNoteGenerator<Layout, Profile>::findClosestPitchNote(
     const Note& previous,
     const std::vector<std::unique_ptr<Note>>& previous_notes
 ) {
-    const int num_strings = validator_.getInstrument().num_strings;
-    int previous_pitch = getNotePitch(previous);
-    
-    Note* best_note = nullptr;
-    int best_distance = std::numeric_limits<int>::max();
+    // Same rules as buildCandidates minus the string-run and repeat rules:
+    // scale & Position Box & step rules as a mask, both pitch bands as one window
+    const PitchBand band = getAllowedPitchBand(previous_notes);
+    const std::uint32_t box_row = fretRangeRow(position_box_.min_fret, position_box_.max_fret);
+    const FretMask& step = stepRules(previous_notes);
+    FretMask allowed = bitboard_.getScaleMask();
+    for (int str = 0; str < layout_.num_strings; ++str) {
+        allowed.rows[str] &= box_row & step.rows[str];
+    }
 
-    // Search through valid notes cache for closest pitch that passes validations
-    for (const auto& cached : valid_notes_cache_) {
-        // Must be in position box
-        if (!position_box_.contains(cached.fret.value)) continue;
+    // Closest pitch wins; ties keep the first position in (string, fret)
+    // order. The previous note itself only if nothing else is left: the
+    // step after a repeat would find no candidates again and repeat too.
+    const int lo = std::max(band.local_lo, band.global_lo);
+    const int hi = std::min(band.local_hi, band.global_hi);
+    FretMask moved = allowed;
+    moved.reset(previous.string_idx.value, previous.fret.value);
+    auto nearest = pitch_index_.findNearest(getNotePitch(previous), lo, hi, moved);
+    if (!nearest) nearest = pitch_index_.findNearest(getNotePitch(previous), lo, hi, allowed);
+    if (nearest) {
+        return std::make_unique<Note>(Note{{nearest->string_idx, layout_.num_strings}, {nearest->fret}});
+    }
 
-        int pitch = getNotePitch(cached);
-        int distance = std::abs(pitch - previous_pitch);
+    return nullptr;
+}
 
-        // Check local range
-        if (!isValidForLocalRange(cached, previous_notes)) continue;
+template class LayoutNoteGenerator<GuitarLayout, StandardProfile>;
+template class LayoutNoteGenerator<BassLayout, StandardProfile>;
+template class LayoutNoteGenerator<DynamicLayout, StandardProfile>;
+template class LayoutNoteGenerator<GuitarLayout, BeginnerProfile>;
+template class LayoutNoteGenerator<BassLayout, BeginnerProfile>;
+template class LayoutNoteGenerator<DynamicLayout, BeginnerProfile>;
+template class LayoutNoteGenerator<GuitarLayout, AdvancedProfile>;
+template class LayoutNoteGenerator<BassLayout, AdvancedProfile>;
+template class LayoutNoteGenerator<DynamicLayout, AdvancedProfile>;
+template class LayoutNoteGenerator<GuitarLayout, DynamicProfile>;
+template class LayoutNoteGenerator<BassLayout, DynamicProfile>;
+template class LayoutNoteGenerator<DynamicLayout, DynamicProfile>;
+
+// ============================================================================
+// Layout + Profile Dispatch
+// ============================================================================
 
-        // Check global range
-        if (!isValidForGlobalRange(pitch)) continue;
+namespace {
 
-        if (distance < best_distance) {
-            best_distance = distance;
-            best_note = const_cast<Note*>(&cached);
-        }
+template<typename Profile, typename... Args>
+std::unique_ptr<NoteGenerator> makeForLayout(const FretboardValidator& validator, const Args&... args) {
+    const auto& instrument = validator.getInstrument();
+    if (isStandardGuitar(instrument)) {
+        return std::make_unique<LayoutNoteGenerator<GuitarLayout, Profile>>(validator, args...);
     }
-
-    if (best_note) {
-        auto note = std::make_unique<Note>(*best_note);
-        note->string_idx.num_strings = num_strings;
-        return note;
+    if (isStandardBass(instrument)) {
+        return std::make_unique<LayoutNoteGenerator<BassLayout, Profile>>(validator, args...);
     }
+    return std::make_unique<LayoutNoteGenerator<DynamicLayout, Profile>>(validator, args...);
+}
 
-    return nullptr;
+template<typename... Args>
+std::unique_ptr<NoteGenerator> makeForProfile(const FretboardValidator& validator,
+                                              const GeneratorProfile& requested, const Args&... args) {
+    const WeightTable& table = WeightTable::getInstance();
+    const GeneratorProfile profile = table.empty()
+        ? requested
+        : table.apply(requested, validator.getScaleManager().getCurrentScaleName());
+    if (profile == STANDARD_PROFILE) return makeForLayout<StandardProfile>(validator, profile, args...);
+    if (profile == BEGINNER_PROFILE) return makeForLayout<BeginnerProfile>(validator, profile, args...);
+    if (profile == ADVANCED_PROFILE) return makeForLayout<AdvancedProfile>(validator, profile, args...);
+    return makeForLayout<DynamicProfile>(validator, profile, args...);
+}
+
+} // namespace
+
+std::unique_ptr<NoteGenerator> makeNoteGenerator(const FretboardValidator& validator) {
+    return makeForProfile(validator, STANDARD_PROFILE);
+}
+
+std::unique_ptr<NoteGenerator> makeNoteGenerator(const FretboardValidator& validator, std::uint32_t seed) {
+    return makeForProfile(validator, STANDARD_PROFILE, seed);
+}
+
+std::unique_ptr<NoteGenerator> makeNoteGenerator(const FretboardValidator& validator,
+                                                 const GeneratorProfile& profile) {
+    return makeForProfile(validator, profile);
+}
+
+std::unique_ptr<NoteGenerator> makeNoteGenerator(const FretboardValidator& validator,
+                                                 const GeneratorProfile& profile,
+                                                 std::uint32_t seed) {
+    return makeForProfile(validator, profile, seed);
 }
 
 // ============================================================================
@@ -317,12 +695,17 @@ std::unique_ptr<Note> NoteGenerator::findClosestPitchNote(
 // ============================================================================
 
 TablatureGenerator::TablatureGenerator(InstrumentType instrument)
+    : TablatureGenerator(getInstrumentConfig(instrument)) {}
+
+TablatureGenerator::TablatureGenerator(const InstrumentConfig& instrument)
     : instrument_{instrument}
+    , profile_{STANDARD_PROFILE}
     , scale_mgr_{}
     , validator_{std::make_unique<FretboardValidator>(scale_mgr_, instrument)}
-    , note_gen_{std::make_unique<NoteGenerator>(*validator_)}
+    , note_gen_{makeNoteGenerator(*validator_)}
     , notes_{}
-    , use_random_settings_{true} {}
+    , use_random_settings_{true}
+    , seed_{} {}
 
 void TablatureGenerator::generate() {
     if (use_random_settings_) {
@@ -330,14 +713,14 @@ void TablatureGenerator::generate() {
     }
     // Rebuild validator with current scale
     validator_ = std::make_unique<FretboardValidator>(scale_mgr_, instrument_);
-    note_gen_ = std::make_unique<NoteGenerator>(*validator_);
+    note_gen_ = seed_ ? makeNoteGenerator(*validator_, profile_, (*seed_)++) : makeNoteGenerator(*validator_, profile_);
     notes_ = note_gen_->generateTablature();
 }
 
 void TablatureGenerator::regenerate() {
     // Regenerate with same key/scale (don't call selectRandomKeyAndScale)
     validator_ = std::make_unique<FretboardValidator>(scale_mgr_, instrument_);
-    note_gen_ = std::make_unique<NoteGenerator>(*validator_);
+    note_gen_ = seed_ ? makeNoteGenerator(*validator_, profile_, (*seed_)++) : makeNoteGenerator(*validator_, profile_);
     notes_ = note_gen_->generateTablature();
 }
 
@@ -346,6 +729,14 @@ void TablatureGenerator::setKeyAndScale(Music::KeyIndex key, const std::string&
     use_random_settings_ = false;
 }
 
+void TablatureGenerator::setProfile(const GeneratorProfile& profile) {
+    profile_ = profile;
+}
+
+void TablatureGenerator::setSeed(std::uint32_t seed) {
+    seed_ = seed;
+}
+
 const std::vector<std::unique_ptr<Note>>& TablatureGenerator::getNotes() const noexcept {
     return notes_;
 }
@@ -355,9 +746,21 @@ const Music::ScaleManager& TablatureGenerator::getScaleManager() const noexcept
 }
 
 InstrumentType TablatureGenerator::getInstrumentType() const noexcept {
+    return instrument_.type;
+}
+
+const InstrumentConfig& TablatureGenerator::getInstrument() const noexcept {
     return instrument_;
 }
 
+const GeneratorProfile& TablatureGenerator::getProfile() const noexcept {
+    return profile_;
+}
+
+const GeneratorStats& TablatureGenerator::getStats() const noexcept {
+    return note_gen_->getStats();
+}
+
 Music::KeyIndex TablatureGenerator::getCurrentKeyIndex() const noexcept {
     return scale_mgr_.getCurrentKeyIndex();
 }
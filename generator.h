@@ -2,10 +2,16 @@
 #define GENERATOR_H
 
 #include <vector>
+#include <map>
 #include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
 #include "fretboard.h"
 #include "music_theory.h"
 #include "random_engine.h"
+#include "rule_set.h"
+#include "transition_model.h"
 
 namespace Guitar {
 
@@ -26,6 +32,196 @@ constexpr int LOCAL_WINDOW_SIZE = 4;  // Check last 4 notes + candidate
 constexpr int WEIGHT_CLOSE = 60;       // 0-2 frets: comfortable
 constexpr int WEIGHT_MEDIUM = 30;      // 3 frets: moderate
 constexpr int WEIGHT_FAR = 10;         // 4 frets: stretch
+constexpr int SAME_STRING_BONUS = 120; // Percent applied to same-string weights
+
+// ============================================================================
+// Distance Classes - Comfort buckets behind the weight system
+// ============================================================================
+
+enum class DistanceClass {
+    Close,      // 0-2 frets
+    Medium,     // 3 frets
+    Far,        // 4 frets up to the Position Box radius
+    OutOfBox    // Beyond the Position Box reach
+};
+
+constexpr int MIN_FAR_DISTANCE = 4;
+
+// Wider boxes (radius 5-6) reach further: their extra frets are Far moves
+[[nodiscard]] constexpr int farReach(int box_radius) noexcept {
+    return box_radius > MIN_FAR_DISTANCE ? box_radius : MIN_FAR_DISTANCE;
+}
+
+[[nodiscard]] constexpr DistanceClass classifyFretDistance(int fret_distance,
+                                                           int box_radius = POSITION_BOX_RADIUS) noexcept {
+    if (fret_distance < 0) fret_distance = -fret_distance;
+    if (fret_distance <= 2) return DistanceClass::Close;
+    if (fret_distance == 3) return DistanceClass::Medium;
+    if (fret_distance <= farReach(box_radius)) return DistanceClass::Far;
+    return DistanceClass::OutOfBox;
+}
+
+// ============================================================================
+// Generator Profile - Every rule that shapes an exercise, tunable at runtime
+// ============================================================================
+
+// Limits for custom profiles (box and window sizes bound the batch kernels,
+// weights keep the batch draw inside 16-bit range reduction)
+constexpr int MAX_PROFILE_BOX_RADIUS = 6;
+constexpr int MAX_PROFILE_WINDOW_SIZE = 8;
+constexpr int MAX_PROFILE_RANGE = 48;
+constexpr int MAX_PROFILE_WEIGHT = 100;
+constexpr int MAX_PROFILE_BONUS = 300;
+
+struct GeneratorProfile {
+    int position_box_radius = POSITION_BOX_RADIUS;
+    int max_local_range = MAX_LOCAL_RANGE;
+    int max_global_range = MAX_GLOBAL_RANGE;
+    int local_window_size = LOCAL_WINDOW_SIZE;
+    int weight_close = WEIGHT_CLOSE;
+    int weight_medium = WEIGHT_MEDIUM;
+    int weight_far = WEIGHT_FAR;
+    int max_consecutive_same_string = MAX_CONSECUTIVE_SAME_STRING;
+    int same_string_bonus = SAME_STRING_BONUS;
+
+    // Weight of a move by `fret_distance` (Far spans up to the box radius)
+    [[nodiscard]] constexpr int weightFor(int fret_distance, bool same_string) const noexcept {
+        int weight = 0;
+        switch (classifyFretDistance(fret_distance, position_box_radius)) {
+            case DistanceClass::Close:  weight = weight_close; break;
+            case DistanceClass::Medium: weight = weight_medium; break;
+            case DistanceClass::Far:    weight = weight_far; break;
+            default:                    weight = 0; break;
+        }
+        // Bonus for staying on same string (promotes fluency when possible)
+        return same_string ? weight * same_string_bonus / 100 : weight;
+    }
+
+    friend constexpr bool operator==(const GeneratorProfile&, const GeneratorProfile&) = default;
+};
+
+// Built-in profiles
+inline constexpr GeneratorProfile STANDARD_PROFILE{};
+
+inline constexpr GeneratorProfile BEGINNER_PROFILE{
+    .position_box_radius = 3,
+    .max_local_range = 7,      // A fifth per window
+    .max_global_range = 12,    // One octave overall
+    .local_window_size = LOCAL_WINDOW_SIZE,
+    .weight_close = 70,
+    .weight_medium = 25,
+    .weight_far = 5,
+    .max_consecutive_same_string = 4,
+    .same_string_bonus = 150,
+};
+
+inline constexpr GeneratorProfile ADVANCED_PROFILE{
+    .position_box_radius = 5,
+    .max_local_range = 19,     // Octave + fifth per window
+    .max_global_range = 31,
+    .local_window_size = LOCAL_WINDOW_SIZE,
+    .weight_close = 40,
+    .weight_medium = 35,
+    .weight_far = 25,
+    .max_consecutive_same_string = 2,
+    .same_string_bonus = 100,
+};
+
+// Built-in profile by name ("standard", "beginner", "advanced")
+[[nodiscard]] std::optional<GeneratorProfile> findGeneratorProfile(const std::string& name);
+
+// Name of the built-in profile with exactly these rules, or "custom"
+[[nodiscard]] std::string describeProfile(const GeneratorProfile& profile);
+
+[[nodiscard]] bool isValidProfile(const GeneratorProfile& profile) noexcept;
+
+// Config keys, in declaration order: box_radius, local_range, global_range,
+// local_window, weight_close, weight_medium, weight_far, max_same_string,
+// same_string_bonus (percent)
+[[nodiscard]] std::vector<std::string> getProfileKeys();
+
+// Set one rule by its config key. False on an unknown key or a non-numeric value.
+[[nodiscard]] bool setProfileValue(GeneratorProfile& profile, const std::string& key, const std::string& value);
+
+// Config file: "key = value" lines, '#' comments; "profile = <built-in>"
+// starts from a preset. std::nullopt on unreadable files, bad lines or
+// out-of-range rules.
+[[nodiscard]] std::optional<GeneratorProfile> loadGeneratorProfile(const std::string& path);
+
+// ============================================================================
+// Weight Table - Per-scale weights fitted by the `calibrate` command
+// ============================================================================
+
+constexpr const char* DEFAULT_WEIGHT_TABLE = "crazyfingers.weights";  // Loaded at startup if present
+
+struct ScaleWeights {
+    int weight_close;
+    int weight_medium;
+    int weight_far;
+    int same_string_bonus;
+
+    friend constexpr bool operator==(const ScaleWeights&, const ScaleWeights&) = default;
+};
+
+// Weights per scale name for one base profile. They only replace the
+// weights of that exact profile: any other rule set (another preset, a
+// flag override, a difficulty level) keeps its own weights, since the
+// fit depends on every rule.
+class WeightTable {
+public:
+    // Table used by makeNoteGenerator (load it before generating)
+    static WeightTable& getInstance();
+
+    explicit WeightTable(const GeneratorProfile& base = STANDARD_PROFILE);
+
+    void set(const std::string& scale, const ScaleWeights& weights);
+    void clear() noexcept;
+
+    [[nodiscard]] bool empty() const noexcept { return weights_.empty(); }
+    [[nodiscard]] std::size_t size() const noexcept { return weights_.size(); }
+    [[nodiscard]] const GeneratorProfile& getBaseProfile() const noexcept { return base_; }
+
+    // `profile` with the scale's weights if it equals the base profile
+    [[nodiscard]] GeneratorProfile apply(const GeneratorProfile& profile, const std::string& scale) const;
+
+    // File: the base profile as "key = value" lines, then one
+    // "scale <name> = <close> <medium> <far> <bonus>" line per scale;
+    // lines starting with '#' are comments. False on unreadable files, bad lines or out-of-range
+    // weights (the table is left unchanged).
+    [[nodiscard]] bool load(const std::string& path);
+    void write(std::ostream& out) const;
+
+private:
+    GeneratorProfile base_;
+    std::map<std::string, ScaleWeights> weights_;
+};
+
+// ============================================================================
+// Compile-time Profiles - Let the generator core fold the rules
+// ============================================================================
+
+// Built-in rules as constants (the constructor argument is ignored;
+// makeNoteGenerator only picks these when the rules match)
+struct StandardProfile {
+    static constexpr GeneratorProfile rules = STANDARD_PROFILE;
+    explicit constexpr StandardProfile(const GeneratorProfile& /* profile */) noexcept {}
+};
+
+struct BeginnerProfile {
+    static constexpr GeneratorProfile rules = BEGINNER_PROFILE;
+    explicit constexpr BeginnerProfile(const GeneratorProfile& /* profile */) noexcept {}
+};
+
+struct AdvancedProfile {
+    static constexpr GeneratorProfile rules = ADVANCED_PROFILE;
+    explicit constexpr AdvancedProfile(const GeneratorProfile& /* profile */) noexcept {}
+};
+
+// Any other rule set (read from memory on every use)
+struct DynamicProfile {
+    GeneratorProfile rules;
+    explicit DynamicProfile(const GeneratorProfile& profile) noexcept : rules{profile} {}
+};
 
 // ============================================================================
 // Note Candidate with Weight
@@ -37,20 +233,44 @@ struct NoteCandidate {
     int fret_distance;  // Absolute distance from previous note
 };
 
+// ============================================================================
+// Pitch Band - Pitch windows every next note must fall into
+// ============================================================================
+
+struct PitchBand {
+    int local_lo;   // From the LOCAL_WINDOW_SIZE window (MAX_LOCAL_RANGE)
+    int local_hi;
+    int global_lo;  // From the whole exercise so far (MAX_GLOBAL_RANGE)
+    int global_hi;
+};
+
 // ============================================================================
 // Position Box - Anchors the hand position for entire exercise
 // ============================================================================
 
 struct PositionBox {
     int anchor_fret;   // First note's fret - anchors the position
-    int min_fret;      // Lower bound: max(0, anchor - 4)
-    int max_fret;      // Upper bound: min(MAX_FRET, anchor + 4)
+    int min_fret;      // Lower bound: max(0, anchor - radius)
+    int max_fret;      // Upper bound: min(neck max fret, anchor + radius)
 
     [[nodiscard]] bool contains(int fret) const {
         return fret >= min_fret && fret <= max_fret;
     }
 
-    void initialize(int first_fret);
+    void initialize(int first_fret, int neck_max_fret = MAX_FRET, int radius = POSITION_BOX_RADIUS);
+};
+
+// ============================================================================
+// Generator Stats - How often the fallback paths ran
+// ============================================================================
+
+struct GeneratorStats {
+    long long exercises = 0;
+    long long first_note_fallbacks = 0;  // 50 random picks missed the scale: any in-scale note
+    long long nearest_fallbacks = 0;     // No candidate: closest pitch inside the box
+    long long ultimate_fallbacks = 0;    // Not even that: adjacent string, same fret (may be out of scale)
+    long long rule_retries = 0;          // Attempts discarded by the RuleSet (the fallbacks above are the kept ones')
+    long long rule_failures = 0;         // MAX_RULE_ATTEMPTS without meeting them: the one closest to them is kept
 };
 
 // ============================================================================
@@ -59,12 +279,34 @@ struct PositionBox {
 
 class NoteGenerator {
 public:
-    NoteGenerator(const FretboardValidator& validator);
+    virtual ~NoteGenerator() = default;
 
     // Generate complete tablature (16 notes)
-    [[nodiscard]] std::vector<std::unique_ptr<Note>> generateTablature();
+    [[nodiscard]] virtual std::vector<std::unique_ptr<Note>> generateTablature() = 0;
+
+    // Totals since construction (the counters only move on the rare paths)
+    [[nodiscard]] virtual const GeneratorStats& getStats() const noexcept = 0;
+};
+
+// Generator core specialized per instrument layout (see fretboard.h) and
+// profile. Static layouts make the string count and open pitches
+// compile-time constants, so the string loop unrolls and pitches fold to
+// immediates; static profiles do the same for the rules.
+template<typename Layout, typename Profile = StandardProfile>
+class LayoutNoteGenerator final : public NoteGenerator {
+public:
+    explicit LayoutNoteGenerator(const FretboardValidator& validator,
+                                 const GeneratorProfile& profile = STANDARD_PROFILE);
+    LayoutNoteGenerator(const FretboardValidator& validator, std::uint32_t seed);  // Reproducible output
+    LayoutNoteGenerator(const FretboardValidator& validator, const GeneratorProfile& profile,
+                        std::uint32_t seed);
+
+    [[nodiscard]] std::vector<std::unique_ptr<Note>> generateTablature() override;
+    [[nodiscard]] const GeneratorStats& getStats() const noexcept override { return stats_; }
 
 private:
+    // One exercise under the step rules (the whole-exercise rules are checked by the caller)
+    [[nodiscard]] std::vector<std::unique_ptr<Note>> generateAttempt();
     [[nodiscard]] std::unique_ptr<Note> generateFirstNote();
     [[nodiscard]] std::unique_ptr<Note> generateNextNote(
         const Note& previous,
@@ -81,14 +323,18 @@ private:
         const std::vector<std::unique_ptr<Note>>& previous_notes
     );
 
-    // Calculate weight based on fret distance
-    [[nodiscard]] int calculateWeight(int fret_distance) const;
+    // Calculate weight based on fret distance and string
+    [[nodiscard]] int calculateWeight(int fret_distance, bool same_string) const;
 
     // Pitch validation helpers
-    [[nodiscard]] bool isValidForLocalRange(const Note& candidate,
-                                             const std::vector<std::unique_ptr<Note>>& previous_notes) const;
-    [[nodiscard]] bool isValidForGlobalRange(int candidate_pitch) const;
+    // Min/max pitch of the last LOCAL_WINDOW_SIZE notes; false if there are none
+    [[nodiscard]] bool getLocalWindowRange(const std::vector<std::unique_ptr<Note>>& previous_notes,
+                                           int& min_pitch, int& max_pitch) const;
+    [[nodiscard]] PitchBand getAllowedPitchBand(const std::vector<std::unique_ptr<Note>>& previous_notes) const;
+    // Positions the rules allow for the note after `previous_notes` (the last one has its own)
+    [[nodiscard]] const FretMask& stepRules(const std::vector<std::unique_ptr<Note>>& previous_notes) const;
     [[nodiscard]] int getNotePitch(const Note& note) const;
+    [[nodiscard]] bool isPitchInScale(int midi_pitch) const;
     
     // Fallback helper
     [[nodiscard]] std::unique_ptr<Note> findClosestPitchNote(
@@ -97,6 +343,14 @@ private:
     );
 
     const FretboardValidator& validator_;
+    Layout layout_;
+    Profile profile_;
+    std::uint16_t scale_mask_;  // 12-bit pitch-class mask of the current scale
+    const FretboardBitboard& bitboard_;  // In-scale positions + pitch bands
+    const FretboardPitchIndex& pitch_index_;  // Nearest-pitch fallback
+    const TransitionModel* model_;  // Learned move weights (nullptr: the profile's distance weights)
+    TransitionContext context_;     // Model context of the note being generated
+    CompiledRules rules_;           // RuleSet::getInstance() for this instrument and key
     RandomEngine rng_;
     std::vector<Note> valid_notes_cache_;
     PositionBox position_box_;  // Global position anchor for entire exercise
@@ -104,8 +358,39 @@ private:
     // Pitch tracking for global range validation
     int global_min_pitch_;
     int global_max_pitch_;
+
+    GeneratorStats stats_;
 };
 
+extern template class LayoutNoteGenerator<GuitarLayout, StandardProfile>;
+extern template class LayoutNoteGenerator<BassLayout, StandardProfile>;
+extern template class LayoutNoteGenerator<DynamicLayout, StandardProfile>;
+extern template class LayoutNoteGenerator<GuitarLayout, BeginnerProfile>;
+extern template class LayoutNoteGenerator<BassLayout, BeginnerProfile>;
+extern template class LayoutNoteGenerator<DynamicLayout, BeginnerProfile>;
+extern template class LayoutNoteGenerator<GuitarLayout, AdvancedProfile>;
+extern template class LayoutNoteGenerator<BassLayout, AdvancedProfile>;
+extern template class LayoutNoteGenerator<DynamicLayout, AdvancedProfile>;
+extern template class LayoutNoteGenerator<GuitarLayout, DynamicProfile>;
+extern template class LayoutNoteGenerator<BassLayout, DynamicProfile>;
+extern template class LayoutNoteGenerator<DynamicLayout, DynamicProfile>;
+
+// Runtime dispatcher: standard guitar/bass get their static layout, every
+// other descriptor runs on DynamicLayout; built-in rules get their static
+// profile, every other rule set runs on DynamicProfile. Weights from
+// WeightTable::getInstance() are applied first; TransitionModel::getInstance(),
+// when trained on the instrument's string count, replaces them with its
+// move probabilities (the rules still filter every candidate), and the
+// rules of RuleSet::getInstance() are compiled for the validator's key.
+[[nodiscard]] std::unique_ptr<NoteGenerator> makeNoteGenerator(const FretboardValidator& validator);
+[[nodiscard]] std::unique_ptr<NoteGenerator> makeNoteGenerator(const FretboardValidator& validator,
+                                                               std::uint32_t seed);
+[[nodiscard]] std::unique_ptr<NoteGenerator> makeNoteGenerator(const FretboardValidator& validator,
+                                                               const GeneratorProfile& profile);
+[[nodiscard]] std::unique_ptr<NoteGenerator> makeNoteGenerator(const FretboardValidator& validator,
+                                                               const GeneratorProfile& profile,
+                                                               std::uint32_t seed);
+
 // ============================================================================
 // Tablature Generator (RAII Coordinator)
 // ============================================================================
@@ -113,6 +398,7 @@ private:
 class TablatureGenerator {
 public:
     explicit TablatureGenerator(InstrumentType instrument);
+    explicit TablatureGenerator(const InstrumentConfig& instrument);
 
     // Generate new tablature (random key/scale)
     void generate();
@@ -123,9 +409,21 @@ public:
     // Set specific key and scale (for advanced mode)
     void setKeyAndScale(Music::KeyIndex key, const std::string& scale_name);
 
+    // Rules for the next generate()/regenerate() (default: STANDARD_PROFILE)
+    void setProfile(const GeneratorProfile& profile);
+
+    // Reproducible output: the next exercise comes from a generator seeded
+    // `seed`, the one after from seed + 1, and so on
+    void setSeed(std::uint32_t seed);
+
     [[nodiscard]] const std::vector<std::unique_ptr<Note>>& getNotes() const noexcept;
     [[nodiscard]] const Music::ScaleManager& getScaleManager() const noexcept;
     [[nodiscard]] InstrumentType getInstrumentType() const noexcept;
+    [[nodiscard]] const InstrumentConfig& getInstrument() const noexcept;
+    [[nodiscard]] const GeneratorProfile& getProfile() const noexcept;
+
+    // Of the last exercise: rule_failures > 0 if it does not meet the RuleSet
+    [[nodiscard]] const GeneratorStats& getStats() const noexcept;
 
     // Get current key index (for re-roll with same settings)
     [[nodiscard]] Music::KeyIndex getCurrentKeyIndex() const noexcept;
@@ -139,12 +437,14 @@ public:
     ~TablatureGenerator() = default;
 
 private:
-    InstrumentType instrument_;
+    InstrumentConfig instrument_;
+    GeneratorProfile profile_;
     Music::ScaleManager scale_mgr_;
     std::unique_ptr<FretboardValidator> validator_;
     std::unique_ptr<NoteGenerator> note_gen_;
     std::vector<std::unique_ptr<Note>> notes_;
     bool use_random_settings_;  // Track if we're using random or fixed settings
+    std::optional<std::uint32_t> seed_;  // Seed of the next exercise (unset: random)
 };
 
 } // namespace Guitar
@@ -1,11 +1,15 @@
 // Crazy Fingers - Guitar/Bass Tablature Generator
 // C++20 implementation with Music Theory Engine
 // Interactive Menu with Advanced Options and Re-Roll Loop
+// Batch/tooling subcommands dispatched through cli.h
 
 #include "generator.h"
 #include "formatter.h"
+#include "fingering.h"
+#include "practice.h"
 #include "easter_egg.h"
 #include "music_theory.h"
+#include "cli.h"
 #include <iostream>
 #include <limits>
 #include <string>
@@ -56,6 +60,7 @@ void printReRollMenu() {
     std::cout << "[1] Generar otra variacion (Misma Tonalidad, Escala e Instrumento)" << std::endl;
     std::cout << "[2] Volver al Menu Principal" << std::endl;
     std::cout << "[3] Salir del Programa" << std::endl;
+    std::cout << "[4] Practicar con metronomo" << std::endl;
     std::cout << "-----------------------------------" << std::endl;
     std::cout << "Seleccione una opcion: ";
 }
@@ -80,11 +85,8 @@ void printSeparator() {
 void displayTablature(const Guitar::TablatureGenerator& generator) {
     using namespace Guitar;
     
-    int num_strings = (generator.getInstrumentType() == InstrumentType::Bass) 
-                      ? BASS_NUM_STRINGS 
-                      : GUITAR_NUM_STRINGS;
-    
-    Formatter::printTablature(generator.getNotes(), num_strings);
+    Formatter::printTablature(generator.getNotes(), generator.getInstrument());
+    Formatter::printFingering(assignFingering(generator.getNotes()), generator.getInstrument());
     
     const auto& scale_mgr = generator.getScaleManager();
     Formatter::printHarmonicInfo(
@@ -96,6 +98,28 @@ void displayTablature(const Guitar::TablatureGenerator& generator) {
     std::cout << EasterEgg::generateAbsurdFact() << std::endl;
 }
 
+// Play the current exercise along the metronome (tempo asked first)
+void practiceTablature(const Guitar::TablatureGenerator& generator) {
+    using namespace Guitar;
+
+    PracticeOptions options;
+    std::cout << "Tempo en BPM (" << MIN_PRACTICE_TEMPO << "-" << MAX_PRACTICE_TEMPO << ", semicorcheas): ";
+    while (!readInteger(options.tempo_bpm) || !isValidPracticeOptions(options)) {
+        std::cout << "Tempo invalido. Intente de nuevo: ";
+    }
+
+    std::vector<Note> notes;
+    for (const auto& note : generator.getNotes()) {
+        notes.push_back(*note);
+    }
+
+    printSeparator();
+    const auto jitter = runPractice(notes, generator.getInstrument(), options);
+    if (jitter) {
+        std::cout << std::endl << formatJitterReport(*jitter) << std::endl;
+    }
+}
+
 // Generate random tablature
 void generateRandom(Guitar::InstrumentType instrument) {
     using namespace Guitar;
@@ -104,7 +128,7 @@ void generateRandom(Guitar::InstrumentType instrument) {
     generator.generate();
     
     printSeparator();
-    Formatter::printInstrumentInfo(instrument);
+    Formatter::printInstrumentInfo(generator.getInstrument());
     std::cout << std::endl;
     displayTablature(generator);
     
@@ -129,6 +153,9 @@ void generateRandom(Guitar::InstrumentType instrument) {
             // Exit program
             std::cout << "\nHasta luego! Keep rocking!" << std::endl;
             std::exit(0);
+        } else if (choice == 4) {
+            // Practice the current exercise
+            practiceTablature(generator);
         } else {
             std::cout << "Opcion invalida. Intente de nuevo." << std::endl;
         }
@@ -179,7 +206,7 @@ void generateAdvanced(Guitar::InstrumentType instrument) {
     generator.generate();
     
     printSeparator();
-    Formatter::printInstrumentInfo(instrument);
+    Formatter::printInstrumentInfo(generator.getInstrument());
     std::cout << std::endl;
     displayTablature(generator);
     
@@ -204,6 +231,9 @@ void generateAdvanced(Guitar::InstrumentType instrument) {
             // Exit program
             std::cout << "\nHasta luego! Keep rocking!" << std::endl;
             std::exit(0);
+        } else if (choice == 4) {
+            // Practice the current exercise
+            practiceTablature(generator);
         } else {
             std::cout << "Opcion invalida. Intente de nuevo." << std::endl;
         }
@@ -214,9 +244,21 @@ void generateAdvanced(Guitar::InstrumentType instrument) {
 // Entry Point
 // ============================================================================
 
-int main() {
+int main(int argc, char* argv[]) {
     using namespace Guitar;
     
+    // Subcommands run non-interactively (see cli.h)
+    if (argc > 1) {
+        return Cli::run(argc, argv);
+    }
+    
+    // Calibrated weights (crazyfingers.weights) when present
+    (void)Cli::loadWeightTable(Cli::Arguments{});
+    // Learned move weights (crazyfingers.model) when present
+    (void)Cli::loadTransitionModel(Cli::Arguments{});
+    // Teacher rules (crazyfingers.rules) when present
+    (void)Cli::loadRules(Cli::Arguments{});
+
     std::cout << "\n*** BIENVENIDO A CRAZY FINGERS ***" << std::endl;
     std::cout << "Generador de Tablaturas con Biomecanica Avanzada\n" << std::endl;
     
@@ -0,0 +1,67 @@
+#include "mapped_file.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Music {
+
+#ifdef _WIN32
+
+std::unique_ptr<MappedFile> MappedFile::open(const std::string& path) {
+    std::unique_ptr<MappedFile> mapped(new MappedFile());
+    mapped->file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (mapped->file_ == INVALID_HANDLE_VALUE) return nullptr;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(mapped->file_, &size)) return nullptr;
+    if (size.QuadPart == 0) return mapped;  // Nothing to map
+
+    mapped->mapping_ = CreateFileMappingA(mapped->file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapped->mapping_) return nullptr;
+    const void* data = MapViewOfFile(mapped->mapping_, FILE_MAP_READ, 0, 0, 0);
+    if (!data) return nullptr;
+
+    mapped->data_ = static_cast<const char*>(data);
+    mapped->size_ = static_cast<std::size_t>(size.QuadPart);
+    return mapped;
+}
+
+MappedFile::~MappedFile() {
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_);
+    if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+}
+
+#else
+
+std::unique_ptr<MappedFile> MappedFile::open(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    std::unique_ptr<MappedFile> mapped(new MappedFile());
+    struct stat info{};
+    bool ok = ::fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+    if (ok && info.st_size > 0) {
+        void* data = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ok = data != MAP_FAILED;
+        if (ok) {
+            mapped->data_ = static_cast<const char*>(data);
+            mapped->size_ = static_cast<std::size_t>(info.st_size);
+        }
+    }
+    ::close(fd);  // The mapping keeps its own reference
+    return ok ? std::move(mapped) : nullptr;
+}
+
+MappedFile::~MappedFile() {
+    if (data_) ::munmap(const_cast<char*>(data_), size_);
+}
+
+#endif
+
+} // namespace Music
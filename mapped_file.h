@@ -0,0 +1,48 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+namespace Music {
+
+// ============================================================================
+// MappedFile - read-only view of a whole file
+// ============================================================================
+
+// open() returns nullptr when the file cannot be opened or mapped; an
+// empty file maps to an empty view
+class MappedFile {
+public:
+    static std::unique_ptr<MappedFile> open(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] std::string_view view() const noexcept { return {data_, size_}; }
+
+private:
+    MappedFile() = default;
+
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#endif
+};
+
+} // namespace Music
+
+#endif // MAPPED_FILE_H
@@ -52,6 +52,35 @@ int parseKeyName(const std::string& name) {
     return -1;  // Invalid key name
 }
 
+std::string midiToNoteName(int midi_pitch) {
+    if (midi_pitch < 0) return "?";
+    return std::string(NOTE_NAMES[midi_pitch % SEMITONES_IN_OCTAVE]) +
+           std::to_string(midi_pitch / SEMITONES_IN_OCTAVE - 1);
+}
+
+int parseMidiNoteName(const std::string& name) {
+    // Split "F#1" into pitch name and octave digits
+    size_t digits = name.size();
+    while (digits > 0 && std::isdigit(static_cast<unsigned char>(name[digits - 1]))) {
+        --digits;
+    }
+    if (digits == 0 || digits == name.size() || name.size() - digits > 1) return -1;
+
+    std::string pitch_name = name.substr(0, digits);
+    int shift = 0;
+    if (pitch_name.size() == 2 && pitch_name[1] == 'b') {
+        pitch_name.pop_back();  // Flat: one semitone below the natural
+        shift = -1;
+    }
+
+    const int key = parseKeyName(pitch_name);
+    if (key < 0) return -1;
+
+    const int octave = name[digits] - '0';
+    const int midi = (octave + 1) * SEMITONES_IN_OCTAVE + key + shift;
+    return (midi >= 0 && midi <= 127) ? midi : -1;
+}
+
 std::vector<std::string> getScalesWithIds() {
     return ScaleDictionary::getInstance().getAllScaleNames();
 }
@@ -65,8 +94,12 @@ ScaleManager::ScaleManager()
     , current_scale_name_{"Major"}
     , current_intervals_{2, 2, 1, 2, 2, 2, 1}
     , valid_pitch_classes_{}
+    , pitch_class_mask_{0}
     , scale_notes_{} {
-    selectRandomKeyAndScale();
+    // C Major until a key and scale are chosen: no random pick here, so
+    // constructing a manager never reads the user scale files
+    computeValidPitchClasses();
+    computeScaleNotes();
 }
 
 void ScaleManager::selectRandomKeyAndScale() {
@@ -117,6 +150,11 @@ void ScaleManager::computeValidPitchClasses() {
         std::unique(valid_pitch_classes_.begin(), valid_pitch_classes_.end()),
         valid_pitch_classes_.end()
     );
+
+    pitch_class_mask_ = 0;
+    for (PitchClass pc : valid_pitch_classes_) {
+        pitch_class_mask_ = static_cast<uint16_t>(pitch_class_mask_ | (1u << pc));
+    }
 }
 
 void ScaleManager::computeScaleNotes() {
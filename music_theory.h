@@ -40,7 +40,7 @@ constexpr std::array<const char*, NUM_KEYS> KEY_NAMES = {
 
 class ScaleManager {
 public:
-    ScaleManager();
+    ScaleManager();  // C Major
 
     // Select random key and scale
     void selectRandomKeyAndScale();
@@ -72,6 +72,9 @@ public:
     // Get all valid pitch classes for current scale
     [[nodiscard]] const std::vector<PitchClass>& getValidPitchClasses() const;
 
+    // Valid pitch classes as a 12-bit mask (bit 0 = C, bit 11 = B)
+    [[nodiscard]] uint16_t getPitchClassMask() const noexcept { return pitch_class_mask_; }
+
 private:
     void computeValidPitchClasses();
     void computeScaleNotes();
@@ -80,6 +83,7 @@ private:
     std::string current_scale_name_;
     std::vector<int> current_intervals_;  // Use int to match ScaleDictionary
     std::vector<PitchClass> valid_pitch_classes_;
+    uint16_t pitch_class_mask_;
     std::string scale_notes_;  // Formatted note names
 };
 
@@ -97,6 +101,13 @@ private:
 // Returns -1 if invalid, otherwise 0-11 (C=0, C#=1, ..., B=11)
 [[nodiscard]] int parseKeyName(const std::string& name);
 
+// MIDI pitch to note name with octave (60 -> "C4", 40 -> "E2")
+[[nodiscard]] std::string midiToNoteName(int midi_pitch);
+
+// Parse note name with octave ("E2", "F#1", "Bb3") to MIDI pitch
+// Returns -1 if invalid
+[[nodiscard]] int parseMidiNoteName(const std::string& name);
+
 // Get all scale names with indexed IDs (for display)
 [[nodiscard]] std::vector<std::string> getScalesWithIds();
 
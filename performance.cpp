@@ -0,0 +1,390 @@
+#include "performance.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <streambuf>
+#include <string_view>
+
+namespace Guitar {
+
+namespace {
+
+// ============================================================================
+// Constants - Standard MIDI File
+// ============================================================================
+
+constexpr std::uint32_t DEFAULT_MICROSECONDS_PER_QUARTER = 500000;  // 120 BPM until a tempo event
+constexpr std::uint8_t META_EVENT = 0xFF;
+constexpr std::uint8_t META_TEMPO = 0x51;
+constexpr std::uint8_t META_END_OF_TRACK = 0x2F;
+constexpr std::uint8_t SYSEX_EVENT = 0xF0;
+constexpr std::uint8_t SYSEX_ESCAPE = 0xF7;
+constexpr std::uint8_t NOTE_ON = 0x90;
+
+// Back pointers of the alignment
+constexpr std::uint8_t STEP_NONE = 0;
+constexpr std::uint8_t STEP_ALIGN = 1;   // Exercise note and played note
+constexpr std::uint8_t STEP_MISS = 2;    // Exercise note only
+constexpr std::uint8_t STEP_EXTRA = 3;   // Played note only
+constexpr int UNREACHABLE = std::numeric_limits<int>::max() / 2;
+
+struct TickEvent {
+    std::uint64_t tick;
+    std::uint32_t value;  // Pitch or microseconds per quarter
+};
+
+// ============================================================================
+// Chunk Reader - forward-only reads bounded by the chunk length
+// ============================================================================
+
+class ChunkReader {
+public:
+    ChunkReader(std::streambuf& buffer, std::uint32_t length)
+        : buffer_{buffer}
+        , remaining_{length}
+        , ok_{true} {}
+
+    [[nodiscard]] bool ok() const noexcept { return ok_; }
+    [[nodiscard]] bool done() const noexcept { return remaining_ == 0; }
+
+    std::uint8_t byte() {
+        if (remaining_ == 0) {
+            ok_ = false;
+            return 0;
+        }
+        --remaining_;
+        const int c = buffer_.sbumpc();
+        if (c == std::char_traits<char>::eof()) {
+            ok_ = false;
+            remaining_ = 0;
+            return 0;
+        }
+        return static_cast<std::uint8_t>(c);
+    }
+
+    // Variable-length quantity: 7 bits per byte, at most 4 bytes
+    std::uint32_t varLen() {
+        std::uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            const std::uint8_t b = byte();
+            value = (value << 7) | (b & 0x7F);
+            if ((b & 0x80) == 0) return value;
+        }
+        ok_ = false;
+        return 0;
+    }
+
+    void skipRest() {
+        skip(remaining_);
+    }
+
+    void skip(std::uint32_t count) {
+        if (count > remaining_) {
+            ok_ = false;
+            count = remaining_;
+        }
+        std::array<char, 256> scratch;
+        while (count > 0) {
+            const auto chunk = static_cast<std::streamsize>(std::min<std::uint32_t>(count, scratch.size()));
+            if (buffer_.sgetn(scratch.data(), chunk) != chunk) {
+                ok_ = false;
+                remaining_ = 0;
+                return;
+            }
+            count -= static_cast<std::uint32_t>(chunk);
+            remaining_ -= static_cast<std::uint32_t>(chunk);
+        }
+    }
+
+private:
+    std::streambuf& buffer_;
+    std::uint32_t remaining_;
+    bool ok_;
+};
+
+// Chunk id and length; false at the end of the stream or on a short header
+bool readChunkHeader(std::streambuf& buffer, std::array<char, 4>& id, std::uint32_t& length) {
+    std::array<char, 8> header;
+    if (buffer.sgetn(header.data(), 8) != 8) return false;
+    std::copy_n(header.begin(), 4, id.begin());
+    length = 0;
+    for (int i = 4; i < 8; ++i) {
+        length = (length << 8) | static_cast<std::uint8_t>(header[i]);
+    }
+    return true;
+}
+
+bool readTrack(ChunkReader& reader, std::vector<TickEvent>& notes, std::vector<TickEvent>& tempos) {
+    std::uint64_t tick = 0;
+    std::uint8_t status = 0;  // Running status
+
+    while (!reader.done() && reader.ok()) {
+        tick += reader.varLen();
+        const std::uint8_t first = reader.byte();
+
+        if (first == META_EVENT) {
+            const std::uint8_t type = reader.byte();
+            const std::uint32_t length = reader.varLen();
+            if (type == META_TEMPO && length == 3) {
+                std::uint32_t tempo = reader.byte();
+                tempo = (tempo << 8) | reader.byte();
+                tempo = (tempo << 8) | reader.byte();
+                if (tempo > 0) tempos.push_back({tick, tempo});
+            } else {
+                reader.skip(length);
+            }
+            if (type == META_END_OF_TRACK) break;
+            continue;
+        }
+        if (first == SYSEX_EVENT || first == SYSEX_ESCAPE) {
+            reader.skip(reader.varLen());
+            continue;
+        }
+
+        std::uint8_t data1 = first;
+        if (first & 0x80) {
+            if (first >= 0xF0) return false;  // System messages never appear in a track
+            status = first;
+            data1 = reader.byte();
+        } else if (status == 0) {
+            return false;                      // Data byte with no status to run on
+        }
+
+        const std::uint8_t kind = status & 0xF0;
+        if (kind == 0xC0 || kind == 0xD0) continue;  // Program change, channel pressure
+        const std::uint8_t data2 = reader.byte();
+        if (kind == NOTE_ON && data2 > 0) notes.push_back({tick, data1 & 0x7Fu});
+    }
+    return reader.ok();
+}
+
+} // namespace
+
+// ============================================================================
+// MIDI Take Reader
+// ============================================================================
+
+std::optional<std::vector<PlayedNote>> readMidiTake(std::istream& in) {
+    std::streambuf* buffer = in.rdbuf();
+    if (!buffer) return std::nullopt;
+
+    std::array<char, 4> id;
+    std::uint32_t length = 0;
+    if (!readChunkHeader(*buffer, id, length) || std::string_view(id.data(), 4) != "MThd" || length < 6) {
+        return std::nullopt;
+    }
+    ChunkReader header(*buffer, length);
+    header.skip(4);  // Format and track count: every MTrk chunk is read anyway
+    const std::uint8_t division_high = header.byte();
+    const auto division = static_cast<std::uint16_t>((division_high << 8) | header.byte());
+    header.skip(length - 6);
+    if (!header.ok() || division == 0) return std::nullopt;
+
+    std::vector<TickEvent> notes;
+    std::vector<TickEvent> tempos;
+    while (readChunkHeader(*buffer, id, length)) {
+        ChunkReader reader(*buffer, length);
+        if (std::string_view(id.data(), 4) == "MTrk") {
+            if (!readTrack(reader, notes, tempos)) return std::nullopt;
+        }
+        reader.skipRest();  // After End of Track, or a whole unknown chunk
+        if (!reader.ok()) return std::nullopt;
+    }
+
+    // Tracks were read one after another: merge them in time
+    auto byTick = [](const TickEvent& a, const TickEvent& b) { return a.tick < b.tick; };
+    std::stable_sort(notes.begin(), notes.end(), byTick);
+    std::stable_sort(tempos.begin(), tempos.end(), byTick);
+
+    std::vector<PlayedNote> played;
+    played.reserve(notes.size());
+    if (division & 0x8000) {
+        // SMPTE: frames per second (negated) times ticks per frame
+        const int fps = -static_cast<std::int8_t>(division >> 8);
+        const double ticks_per_second = static_cast<double>(fps) * (division & 0xFF);
+        if (ticks_per_second <= 0.0) return std::nullopt;
+        for (const auto& note : notes) {
+            played.push_back({static_cast<double>(note.tick) / ticks_per_second,
+                              static_cast<std::uint8_t>(note.value)});
+        }
+        return played;
+    }
+
+    // Seconds at the last tempo change, then linear until the next one
+    double segment_seconds = 0.0;
+    std::uint64_t segment_tick = 0;
+    double seconds_per_tick = DEFAULT_MICROSECONDS_PER_QUARTER / (1e6 * division);
+    std::size_t next_tempo = 0;
+    for (const auto& note : notes) {
+        while (next_tempo < tempos.size() && tempos[next_tempo].tick <= note.tick) {
+            segment_seconds += static_cast<double>(tempos[next_tempo].tick - segment_tick) * seconds_per_tick;
+            segment_tick = tempos[next_tempo].tick;
+            seconds_per_tick = tempos[next_tempo].value / (1e6 * division);
+            ++next_tempo;
+        }
+        played.push_back({segment_seconds + static_cast<double>(note.tick - segment_tick) * seconds_per_tick,
+                          static_cast<std::uint8_t>(note.value)});
+    }
+    return played;
+}
+
+// ============================================================================
+// PerformanceGrader Implementation
+// ============================================================================
+
+PerformanceGrader::PerformanceGrader(std::span<const Note> exercise, const InstrumentConfig& instrument,
+                                     int note_value, double seconds_per_note, int band)
+    : pitches_{}
+    , note_value_{note_value}
+    , seconds_per_note_{seconds_per_note}
+    , band_{std::max(1, band)}
+    , previous_{}
+    , current_{}
+    , back_{}
+    , matched_{} {
+    pitches_.reserve(exercise.size());
+    for (const auto& note : exercise) {
+        pitches_.push_back(static_cast<std::uint8_t>(note.getMidiPitch(instrument)));
+    }
+}
+
+bool PerformanceGrader::grade(std::span<const PlayedNote> played, PerformanceScore& out) {
+    const int n = static_cast<int>(pitches_.size());
+    const int m = static_cast<int>(played.size());
+    const int width = 2 * band_ + 1;
+    if (n == 0) {
+        out = PerformanceScore{{}, 0, 0, 0, m, m == 0 ? 100.0 : 0.0, 0.0, 0.0};
+        return true;
+    }
+
+    // Row i covers the played notes around the diagonal scaled to m / n
+    auto low = [&](int i) {
+        const auto centre = static_cast<int>((static_cast<long long>(i) * m + n / 2) / n);
+        return std::max(0, centre - band_);
+    };
+    auto high = [&](int i) {
+        const auto centre = static_cast<int>((static_cast<long long>(i) * m + n / 2) / n);
+        return std::min(m, centre + band_);
+    };
+
+    previous_.assign(static_cast<std::size_t>(width), UNREACHABLE);
+    current_.assign(static_cast<std::size_t>(width), UNREACHABLE);
+    back_.assign(static_cast<std::size_t>(n + 1) * static_cast<std::size_t>(width), STEP_NONE);
+
+    // Row 0: only extra notes before the first exercise note
+    for (int j = 0; j <= high(0); ++j) {
+        previous_[static_cast<std::size_t>(j)] = j * SKIP;
+        back_[static_cast<std::size_t>(j)] = j > 0 ? STEP_EXTRA : STEP_NONE;
+    }
+
+    for (int i = 1; i <= n; ++i) {
+        const int lo = low(i);
+        const int hi = high(i);
+        const int prev_lo = low(i - 1);
+        const int prev_hi = high(i - 1);
+        std::uint8_t* back = back_.data() + static_cast<std::size_t>(i) * static_cast<std::size_t>(width);
+        std::fill(current_.begin(), current_.end(), UNREACHABLE);
+
+        for (int j = lo; j <= hi; ++j) {
+            int best = UNREACHABLE;
+            std::uint8_t step = STEP_NONE;
+            if (j >= 1 && j - 1 >= prev_lo && j - 1 <= prev_hi) {
+                const int cost = previous_[static_cast<std::size_t>(j - 1 - prev_lo)] +
+                                 (played[static_cast<std::size_t>(j - 1)].pitch == pitches_[static_cast<std::size_t>(i - 1)]
+                                      ? 0 : SUBSTITUTION);
+                if (cost < best) {
+                    best = cost;
+                    step = STEP_ALIGN;
+                }
+            }
+            if (j >= prev_lo && j <= prev_hi) {
+                const int cost = previous_[static_cast<std::size_t>(j - prev_lo)] + SKIP;
+                if (cost < best) {
+                    best = cost;
+                    step = STEP_MISS;
+                }
+            }
+            if (j - 1 >= lo) {
+                const int cost = current_[static_cast<std::size_t>(j - 1 - lo)] + SKIP;
+                if (cost < best) {
+                    best = cost;
+                    step = STEP_EXTRA;
+                }
+            }
+            if (best >= UNREACHABLE) continue;
+            current_[static_cast<std::size_t>(j - lo)] = best;
+            back[j - lo] = step;
+        }
+        previous_.swap(current_);
+    }
+
+    if (previous_[static_cast<std::size_t>(m - low(n))] >= UNREACHABLE) return false;
+
+    // Walk the back pointers from (n, m)
+    matched_.assign(static_cast<std::size_t>(n), -1);
+    int extra = 0;
+    for (int i = n, j = m; i > 0 || j > 0;) {
+        const std::uint8_t step = back_[static_cast<std::size_t>(i) * static_cast<std::size_t>(width) +
+                                        static_cast<std::size_t>(j - low(i))];
+        if (step == STEP_ALIGN) {
+            matched_[static_cast<std::size_t>(--i)] = --j;
+        } else if (step == STEP_MISS) {
+            --i;
+        } else {
+            ++extra;
+            --j;
+        }
+    }
+
+    // Timing grid: onset = start + i * seconds per note, fitted on the correct notes
+    double sum_i = 0.0, sum_t = 0.0, sum_ii = 0.0, sum_it = 0.0;
+    int fitted = 0;
+    for (int i = 0; i < n; ++i) {
+        const int j = matched_[static_cast<std::size_t>(i)];
+        if (j < 0 || played[static_cast<std::size_t>(j)].pitch != pitches_[static_cast<std::size_t>(i)]) continue;
+        const double t = played[static_cast<std::size_t>(j)].onset;
+        sum_i += i;
+        sum_t += t;
+        sum_ii += static_cast<double>(i) * i;
+        sum_it += i * t;
+        ++fitted;
+    }
+    double slope = seconds_per_note_;
+    if (slope <= 0.0 && fitted >= 2) {
+        const double variance = fitted * sum_ii - sum_i * sum_i;
+        slope = variance > 0.0 ? (fitted * sum_it - sum_i * sum_t) / variance : 0.0;
+    }
+    slope = std::max(slope, 0.0);
+    const double start = fitted > 0 ? (sum_t - slope * sum_i) / fitted : 0.0;
+
+    out.notes.resize(static_cast<std::size_t>(n));
+    out.correct = 0;
+    out.wrong = 0;
+    out.missed = 0;
+    out.extra = extra;
+    double deviation_sum = 0.0;
+    for (int i = 0; i < n; ++i) {
+        NoteGrade& grade = out.notes[static_cast<std::size_t>(i)];
+        const int j = matched_[static_cast<std::size_t>(i)];
+        if (j < 0) {
+            grade = {NoteVerdict::Missed, 0, 0.0};
+            ++out.missed;
+            continue;
+        }
+        const PlayedNote& note = played[static_cast<std::size_t>(j)];
+        const bool correct = note.pitch == pitches_[static_cast<std::size_t>(i)];
+        grade = {correct ? NoteVerdict::Correct : NoteVerdict::Wrong, note.pitch,
+                 (note.onset - (start + slope * i)) * 1000.0};
+        deviation_sum += std::abs(grade.deviation_ms);
+        ++(correct ? out.correct : out.wrong);
+    }
+
+    const int played_notes = out.correct + out.wrong;
+    out.accuracy = n + extra > 0 ? 100.0 * out.correct / (n + extra) : 100.0;
+    out.mean_deviation_ms = played_notes > 0 ? deviation_sum / played_notes : 0.0;
+    out.tempo_bpm = slope > 0.0 ? 60.0 / (slope * note_value_ / 4.0) : 0.0;
+    return true;
+}
+
+} // namespace Guitar
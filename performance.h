@@ -0,0 +1,91 @@
+#ifndef PERFORMANCE_H
+#define PERFORMANCE_H
+
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <span>
+#include <vector>
+#include "fretboard.h"
+
+namespace Guitar {
+
+// ============================================================================
+// MIDI Take - note onsets of a Standard MIDI File
+// ============================================================================
+
+struct PlayedNote {
+    double onset;          // Seconds from the start of the file
+    std::uint8_t pitch;
+};
+
+// Note-ons (velocity > 0) of every track and channel in time order, with
+// the tempo map applied (SMPTE divisions too). Each chunk is decoded in one
+// forward pass straight from the stream buffer, with running status;
+// unknown chunks are skipped. std::nullopt on a malformed or truncated file.
+[[nodiscard]] std::optional<std::vector<PlayedNote>> readMidiTake(std::istream& in);
+
+// ============================================================================
+// Performance Grader - banded alignment of a take against the exercise
+// ============================================================================
+
+constexpr int DEFAULT_SCORE_BAND = 8;        // Played notes allowed off the diagonal
+
+enum class NoteVerdict : std::uint8_t {
+    Correct,   // Right pitch
+    Wrong,     // Another pitch played in its place
+    Missed     // Nothing played for it
+};
+
+struct NoteGrade {
+    NoteVerdict verdict;
+    std::uint8_t played_pitch;   // Correct / Wrong only
+    double deviation_ms;         // Against the timing grid; Correct / Wrong only
+};
+
+struct PerformanceScore {
+    std::vector<NoteGrade> notes;  // One per exercise note
+    int correct;
+    int wrong;
+    int missed;
+    int extra;                     // Played notes aligned to no exercise note
+    double accuracy;               // correct / (exercise notes + extra), 0-100
+    double mean_deviation_ms;      // Mean |deviation| of the played exercise notes
+    double tempo_bpm;              // Tempo of the timing grid
+};
+
+// Dynamic time warping with edit steps: an exercise note and a played note
+// align (free if the pitches match, SUBSTITUTION otherwise), or one of them
+// is skipped (missed / extra). Only cells within `band` of the scaled
+// diagonal are computed, so time is O(notes * band); two cost rows plus one
+// back pointer byte per banded cell keep memory linear in the length too.
+// The timing grid is a least-squares line through the onsets of the correct
+// notes (the student's own tempo), or the given tempo with only the start
+// fitted. All buffers are reused between takes.
+class PerformanceGrader {
+public:
+    // `seconds_per_note` <= 0 fits the tempo from the take
+    PerformanceGrader(std::span<const Note> exercise, const InstrumentConfig& instrument,
+                      int note_value, double seconds_per_note = 0.0, int band = DEFAULT_SCORE_BAND);
+
+    // False if the take has no alignment inside the band
+    // (more than `band` notes missing or extra)
+    bool grade(std::span<const PlayedNote> played, PerformanceScore& out);
+
+private:
+    static constexpr int SUBSTITUTION = 1;
+    static constexpr int SKIP = 1;
+
+    std::vector<std::uint8_t> pitches_;
+    int note_value_;
+    double seconds_per_note_;
+    int band_;
+    std::vector<int> previous_;
+    std::vector<int> current_;
+    std::vector<std::uint8_t> back_;     // (exercise notes + 1) x (2 * band + 1)
+    std::vector<int> matched_;           // Played index per exercise note, -1 if missed
+};
+
+} // namespace Guitar
+
+#endif // PERFORMANCE_H
@@ -0,0 +1,408 @@
+#include "practice.h"
+#include "formatter.h"
+#include "synth.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <numbers>
+#include <sstream>
+
+#if defined(__linux__) || defined(__FreeBSD__)
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+#define CRAZYFINGERS_CLOCK_NANOSLEEP 1
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace Guitar {
+
+namespace {
+
+// ============================================================================
+// Constants - Click Track and Terminal
+// ============================================================================
+
+constexpr int CLICK_BITS = 16;
+constexpr double ACCENT_FREQUENCY = 1760.0;    // First beat of the bar
+constexpr double BEAT_FREQUENCY = 880.0;
+constexpr float CLICK_AMPLITUDE = 0.6f;
+constexpr double CLICK_DECAY = 300.0;          // 1/s: the click is gone after its 15 ms
+constexpr int BEATS_PER_BAR = 4;
+
+constexpr const char* HIGHLIGHT_ON = "\x1b[7m";
+constexpr const char* HIGHLIGHT_OFF = "\x1b[0m";
+constexpr const char* CLEAR_LINE = "\x1b[2K";
+constexpr const char* HIDE_CURSOR = "\x1b[?25l";
+constexpr const char* SHOW_CURSOR = "\x1b[?25h";
+constexpr std::size_t CELL_WIDTH = 3;          // Fret digits plus dashes after the "-"
+
+volatile std::sig_atomic_t g_interrupted = 0;
+
+void onInterrupt(int) {
+    g_interrupted = 1;
+}
+
+// ============================================================================
+// Clock Helpers
+// ============================================================================
+
+std::int64_t monotonicNs() noexcept {
+#ifdef CRAZYFINGERS_CLOCK_NANOSLEEP
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<std::int64_t>(now.tv_sec) * 1'000'000'000 + now.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void sleepUntil(std::int64_t deadline_ns) noexcept {
+#ifdef CRAZYFINGERS_CLOCK_NANOSLEEP
+    timespec deadline{};
+    deadline.tv_sec = static_cast<time_t>(deadline_ns / 1'000'000'000);
+    deadline.tv_nsec = static_cast<long>(deadline_ns % 1'000'000'000);
+    // clock_nanosleep returns the error instead of setting errno
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {}
+#else
+    std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deadline_ns)));
+#endif
+}
+
+void requestRealtimePriority() noexcept {
+#ifdef __linux__
+    // The default 50 us slack lets the kernel batch our wake-up with others
+    (void)prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+#endif
+#ifdef CRAZYFINGERS_CLOCK_NANOSLEEP
+    sched_param param{};
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+    (void)pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);  // Needs CAP_SYS_NICE or rtprio
+#endif
+}
+
+bool isTerminal() noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+    return isatty(STDOUT_FILENO) == 1;
+#else
+    return true;
+#endif
+}
+
+// ============================================================================
+// Click Track
+// ============================================================================
+
+// Clicks on the beats, silence in between; tick k covers the samples from
+// round(k * period * rate), so long sessions never drift from the metronome
+class ClickTrack {
+public:
+    ClickTrack(double period_seconds, int ticks_per_beat)
+        : period_seconds_{period_seconds}
+        , ticks_per_beat_{ticks_per_beat}
+        , accent_{makeClick(ACCENT_FREQUENCY)}
+        , beat_{makeClick(BEAT_FREQUENCY)} {}
+
+    [[nodiscard]] bool open(const std::string& path) {
+        wav_ = path.size() >= 4 && path.compare(path.size() - 4, 4, ".wav") == 0;
+        out_.open(path, std::ios::binary | std::ios::trunc);
+        // Sizes are patched in close(); a raw stream has no header
+        if (out_ && wav_) writeWavHeader(out_, 0, DEFAULT_SAMPLE_RATE, CLICK_BITS);
+        return static_cast<bool>(out_);
+    }
+
+    [[nodiscard]] bool isOpen() const noexcept { return out_.is_open(); }
+
+    // Samples of every tick before `tick` not yet written
+    void writeUntil(std::size_t tick) {
+        for (; written_ < tick; ++written_) {
+            block_.assign(tickStart(written_ + 1) - tickStart(written_), 0.0f);
+            if (written_ % static_cast<std::size_t>(ticks_per_beat_) == 0) {
+                const std::size_t beat = written_ / static_cast<std::size_t>(ticks_per_beat_);
+                const auto& click = beat % BEATS_PER_BAR == 0 ? accent_ : beat_;
+                std::copy_n(click.begin(), std::min(click.size(), block_.size()), block_.begin());
+            }
+            writeWavSamples(out_, block_, CLICK_BITS);
+            samples_ += block_.size();
+        }
+        out_.flush();
+    }
+
+    bool close() {
+        if (wav_) {
+            out_.seekp(0);
+            writeWavHeader(out_, samples_, DEFAULT_SAMPLE_RATE, CLICK_BITS);
+        }
+        out_.close();
+        return !out_.fail();
+    }
+
+private:
+    [[nodiscard]] std::size_t tickStart(std::size_t tick) const noexcept {
+        return static_cast<std::size_t>(std::llround(static_cast<double>(tick) * period_seconds_ * DEFAULT_SAMPLE_RATE));
+    }
+
+    static std::vector<float> makeClick(double frequency) {
+        std::vector<float> click(static_cast<std::size_t>(CLICK_SECONDS * DEFAULT_SAMPLE_RATE));
+        for (std::size_t i = 0; i < click.size(); ++i) {
+            const double t = static_cast<double>(i) / DEFAULT_SAMPLE_RATE;
+            click[i] = CLICK_AMPLITUDE * static_cast<float>(std::exp(-CLICK_DECAY * t) *
+                                                            std::sin(2.0 * std::numbers::pi * frequency * t));
+        }
+        return click;
+    }
+
+    double period_seconds_;
+    int ticks_per_beat_;
+    std::vector<float> accent_;
+    std::vector<float> beat_;
+    std::vector<float> block_;
+    std::ofstream out_;
+    bool wav_ = false;
+    std::size_t written_ = 0;
+    std::size_t samples_ = 0;
+};
+
+// ============================================================================
+// Frame Helpers
+// ============================================================================
+
+// Writes `text` at `column` of the row `rows_up` above the parked cursor,
+// then parks again at the start of the line below the status row
+void putCell(std::string& frame, int rows_up, std::size_t column, const std::string& text) {
+    frame += "\x1b[" + std::to_string(rows_up) + "A\x1b[" + std::to_string(column + 1) + "G";
+    frame += text;
+    frame += "\x1b[" + std::to_string(rows_up) + "B\r";
+}
+
+} // namespace
+
+// ============================================================================
+// Options
+// ============================================================================
+
+bool isValidPracticeOptions(const PracticeOptions& options) noexcept {
+    return options.tempo_bpm >= MIN_PRACTICE_TEMPO && options.tempo_bpm <= MAX_PRACTICE_TEMPO &&
+           (options.note_value == 4 || options.note_value == 8 || options.note_value == 16) &&
+           options.count_in >= 0 && options.count_in <= MAX_COUNT_IN_BEATS &&
+           options.loops >= 1 && options.loops <= MAX_PRACTICE_LOOPS;
+}
+
+std::string formatJitterReport(const JitterStats& stats) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1) << "Jitter del metronomo: media " << stats.mean_us
+        << " us, p50 " << stats.p50_us << " us, p99 " << stats.p99_us << " us, max " << stats.max_us
+        << " us (" << stats.ticks << " ticks)";
+    return oss.str();
+}
+
+// ============================================================================
+// Metronome Implementation
+// ============================================================================
+
+Metronome::Metronome(std::chrono::nanoseconds period, std::size_t num_ticks)
+    : period_{period}
+    , num_ticks_{num_ticks}
+    , lateness_ns_(num_ticks, 0)
+    , fired_{0}
+    , done_{false}
+    , stop_{false} {}
+
+Metronome::~Metronome() {
+    stop();
+}
+
+void Metronome::start() {
+    thread_ = std::thread(&Metronome::run, this);
+}
+
+void Metronome::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    if (thread_.joinable()) thread_.join();
+}
+
+void Metronome::run() {
+    requestRealtimePriority();
+
+    const std::int64_t period = period_.count();
+    const std::int64_t start = monotonicNs() + std::chrono::nanoseconds(METRONOME_LEAD).count();
+    for (std::size_t tick = 0; tick < num_ticks_; ++tick) {
+        const std::int64_t deadline = start + static_cast<std::int64_t>(tick) * period;
+        sleepUntil(deadline);
+        lateness_ns_[tick] = monotonicNs() - deadline;
+
+        bool stop = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            fired_ = tick + 1;
+            stop = stop_;
+        }
+        ticked_.notify_one();
+        if (stop) break;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+    }
+    ticked_.notify_one();
+}
+
+std::optional<std::size_t> Metronome::waitTick(std::size_t next) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ticked_.wait(lock, [&] { return fired_ > next || done_; });
+    if (fired_ > next) return fired_ - 1;
+    return std::nullopt;
+}
+
+JitterStats Metronome::getJitter() const {
+    std::vector<std::int64_t> sorted(lateness_ns_.begin(), lateness_ns_.begin() + static_cast<std::ptrdiff_t>(fired_));
+    JitterStats stats{sorted.size(), 0.0, 0.0, 0.0, 0.0};
+    if (sorted.empty()) return stats;
+
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (const auto lateness : sorted) sum += static_cast<double>(lateness);
+
+    // Nearest-rank percentiles
+    auto percentile = [&](double p) {
+        const auto rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+        return static_cast<double>(sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1]) / 1000.0;
+    };
+    stats.mean_us = sum / static_cast<double>(sorted.size()) / 1000.0;
+    stats.p50_us = percentile(0.50);
+    stats.p99_us = percentile(0.99);
+    stats.max_us = static_cast<double>(sorted.back()) / 1000.0;
+    return stats;
+}
+
+// ============================================================================
+// Practice Session
+// ============================================================================
+
+std::optional<JitterStats> runPractice(const std::vector<Note>& notes, const InstrumentConfig& instrument,
+                                       const PracticeOptions& options) {
+    if (notes.empty()) return JitterStats{0, 0.0, 0.0, 0.0, 0.0};
+
+    const int ticks_per_beat = options.note_value / 4;
+    const double period_seconds = 60.0 / options.tempo_bpm / ticks_per_beat;
+    const std::size_t count_in = static_cast<std::size_t>(options.count_in * ticks_per_beat);
+    const std::size_t num_notes = notes.size();
+    const std::size_t play_ticks = num_notes * static_cast<std::size_t>(options.loops);
+    const std::size_t last_tick = count_in + play_ticks;  // Ends the last note
+
+    ClickTrack clicks(period_seconds, ticks_per_beat);
+    if (!options.click_path.empty() && !clicks.open(options.click_path)) return std::nullopt;
+
+    const bool redraw = options.redraw && isTerminal();
+    const bool bell = options.bell && isTerminal();
+    const auto lines = Formatter::formatTablatureLines(notes, instrument);
+    const std::size_t first_column = static_cast<std::size_t>(Formatter::getLabelWidth(instrument)) + 2;
+    const int num_strings = instrument.num_strings;
+
+    // Layout below the tab: cursor row, status row, then the parked cursor
+    constexpr int STATUS_ROW = 1;
+    constexpr int CURSOR_ROW = 2;
+    auto stringRow = [&](int string_idx) { return CURSOR_ROW + num_strings - string_idx; };
+    auto noteColumn = [&](std::size_t note) { return first_column + note * Formatter::NOTE_WIDTH; };
+    auto cell = [&](std::size_t note) {
+        return lines[static_cast<std::size_t>(notes[note].string_idx.value)].substr(noteColumn(note), CELL_WIDTH);
+    };
+
+    std::string frame;
+    for (const auto& line : lines) frame += line + "\n";
+    if (redraw) frame += std::string("\n\n") + HIDE_CURSOR;
+    std::fflush(stdout);
+    std::fwrite(frame.data(), 1, frame.size(), stdout);
+    std::fflush(stdout);
+
+    g_interrupted = 0;
+    const auto previous_handler = std::signal(SIGINT, onInterrupt);
+
+    Metronome metronome(std::chrono::nanoseconds(std::llround(period_seconds * 1e9)), last_tick + 1);
+    metronome.start();
+
+    std::optional<std::size_t> shown;  // Highlighted note
+    std::string shown_status;
+    std::size_t next = 0;
+    while (const auto tick = metronome.waitTick(next)) {
+        next = *tick + 1;
+        if (g_interrupted) {
+            metronome.stop();
+            break;
+        }
+        if (clicks.isOpen()) clicks.writeUntil(next);
+
+        frame.clear();
+        if (bell && *tick % static_cast<std::size_t>(ticks_per_beat) == 0 && *tick < last_tick) frame += '\a';
+
+        std::string status;
+        std::optional<std::size_t> note;
+        if (*tick < count_in) {
+            status = "Cuenta " + std::to_string(*tick / ticks_per_beat + 1) + "/" + std::to_string(options.count_in);
+        } else if (*tick < last_tick) {
+            const std::size_t played = *tick - count_in;
+            note = played % num_notes;
+            status = "Vuelta " + std::to_string(played / num_notes + 1) + "/" + std::to_string(options.loops) +
+                     "  Nota " + std::to_string(*note + 1) + "/" + std::to_string(num_notes);
+        } else {
+            status = "Fin";
+        }
+        status += "  " + std::to_string(options.tempo_bpm) + " BPM";
+
+        if (redraw) {
+            if (shown && shown != note) {
+                putCell(frame, stringRow(notes[*shown].string_idx.value), noteColumn(*shown), cell(*shown));
+                putCell(frame, CURSOR_ROW, noteColumn(*shown), " ");
+            }
+            if (note && shown != note) {
+                putCell(frame, stringRow(notes[*note].string_idx.value), noteColumn(*note),
+                        HIGHLIGHT_ON + cell(*note) + HIGHLIGHT_OFF);
+                putCell(frame, CURSOR_ROW, noteColumn(*note), "^");
+            }
+            if (status != shown_status) putCell(frame, STATUS_ROW, 0, CLEAR_LINE + status);
+        } else if (note || status != shown_status) {
+            frame += status;
+            if (note) {
+                frame += "  " + instrument.labels[notes[*note].string_idx.value] + " " +
+                         std::to_string(notes[*note].fret.value);
+            }
+            frame += "\n";
+        }
+        shown = note;
+        shown_status = status;
+
+        std::fwrite(frame.data(), 1, frame.size(), stdout);
+        std::fflush(stdout);
+    }
+
+    metronome.stop();
+    std::signal(SIGINT, previous_handler);
+    if (redraw) {
+        frame.clear();
+        if (shown) {
+            putCell(frame, stringRow(notes[*shown].string_idx.value), noteColumn(*shown), cell(*shown));
+        }
+        frame += SHOW_CURSOR;
+        std::fwrite(frame.data(), 1, frame.size(), stdout);
+        std::fflush(stdout);
+    }
+    if (clicks.isOpen() && !clicks.close()) return std::nullopt;
+    return metronome.getJitter();
+}
+
+} // namespace Guitar
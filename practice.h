@@ -0,0 +1,112 @@
+#ifndef PRACTICE_H
+#define PRACTICE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "fretboard.h"
+
+namespace Guitar {
+
+// ============================================================================
+// Constants - Practice Mode
+// ============================================================================
+
+constexpr int MIN_PRACTICE_TEMPO = 20;
+constexpr int MAX_PRACTICE_TEMPO = 400;
+constexpr int MAX_COUNT_IN_BEATS = 16;
+constexpr int MAX_PRACTICE_LOOPS = 100;
+constexpr double CLICK_SECONDS = 0.015;          // Length of one metronome click
+constexpr auto METRONOME_LEAD = std::chrono::milliseconds(200);  // First tick after the tab is drawn
+
+struct PracticeOptions {
+    int tempo_bpm = 80;            // Quarter notes per minute
+    int note_value = 16;           // One exercise note per 4th, 8th or 16th
+    int count_in = 4;              // Beats of clicks before the first note
+    int loops = 1;                 // Times through the exercise
+    bool bell = true;              // Terminal bell on every beat
+    bool redraw = true;            // Cursor over the tab; false prints one line per note
+    std::string click_path;        // Click track: ".wav" file, anything else raw S16LE (a FIFO)
+};
+
+// Tempo MIN-MAX_PRACTICE_TEMPO, value 4/8/16, count-in 0-MAX_COUNT_IN_BEATS,
+// loops 1-MAX_PRACTICE_LOOPS
+[[nodiscard]] bool isValidPracticeOptions(const PracticeOptions& options) noexcept;
+
+// Lateness of every wake-up against its deadline, in microseconds
+struct JitterStats {
+    std::size_t ticks;
+    double mean_us;
+    double p50_us;
+    double p99_us;
+    double max_us;
+};
+
+// "Jitter del metronomo: media X us, p50 X us, p99 X us, max X us (N ticks)"
+[[nodiscard]] std::string formatJitterReport(const JitterStats& stats);
+
+// ============================================================================
+// Metronome - timing thread with absolute deadlines
+// ============================================================================
+
+// Tick k is due at start + k * period. The thread sleeps until each
+// deadline with clock_nanosleep(TIMER_ABSTIME) on CLOCK_MONOTONIC, so
+// wake-up errors never add up, records how late it woke and publishes the
+// tick. It does nothing else: drawing and audio run on the caller's thread,
+// which may skip ticks when it falls behind. Real-time priority is
+// requested and silently dropped when not permitted.
+class Metronome {
+public:
+    Metronome(std::chrono::nanoseconds period, std::size_t num_ticks);
+    ~Metronome();
+
+    Metronome(const Metronome&) = delete;
+    Metronome& operator=(const Metronome&) = delete;
+
+    void start();
+    void stop();
+
+    // Latest tick >= `next`, blocking until it is due; std::nullopt once
+    // every tick has fired or the metronome was stopped
+    [[nodiscard]] std::optional<std::size_t> waitTick(std::size_t next);
+
+    // Valid after the thread finished (waitTick returned std::nullopt)
+    [[nodiscard]] JitterStats getJitter() const;
+
+private:
+    void run();
+
+    std::chrono::nanoseconds period_;
+    std::size_t num_ticks_;
+    std::vector<std::int64_t> lateness_ns_;  // Preallocated: no allocation while ticking
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable ticked_;
+    std::size_t fired_;                      // Ticks published so far
+    bool done_;
+    bool stop_;
+};
+
+// ============================================================================
+// Practice Session
+// ============================================================================
+
+// Prints the tab and plays it along the metronome: count-in, then one
+// exercise note per tick, `loops` times. The cursor is a highlighted cell
+// plus a '^' under the tab; each frame rewrites only the cells that changed
+// with relative cursor moves in a single write. Ctrl+C ends the session
+// early. std::nullopt if the click file cannot be opened.
+[[nodiscard]] std::optional<JitterStats> runPractice(const std::vector<Note>& notes,
+                                                     const InstrumentConfig& instrument,
+                                                     const PracticeOptions& options);
+
+} // namespace Guitar
+
+#endif // PRACTICE_H
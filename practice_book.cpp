@@ -0,0 +1,94 @@
+#include "practice_book.h"
+#include "rule_set.h"
+#include <cstdlib>
+
+namespace Guitar {
+
+namespace {
+
+std::vector<Note> generateExercise(const PracticeBookSpec& spec, const Music::ScaleManager& scale_mgr,
+                                   std::uint32_t seed) {
+    const FretboardValidator validator(scale_mgr, spec.instrument);
+    const auto generator = makeNoteGenerator(validator, spec.profile, seed);
+
+    std::vector<Note> notes;
+    notes.reserve(NUM_NOTES);
+    for (const auto& note : generator->generateTablature()) {
+        notes.push_back(*note);
+    }
+    return notes;
+}
+
+// Distinct stream per regenerated key, reproducible from the book seed
+std::uint32_t pageSeed(std::uint32_t seed, int key) noexcept {
+    return seed ^ (static_cast<std::uint32_t>(key + 1) * 0x9E3779B9u);
+}
+
+} // namespace
+
+std::optional<std::vector<Note>> transposeExercise(const std::vector<Note>& notes,
+                                                   int fret_shift,
+                                                   const PositionBox& box,
+                                                   const InstrumentConfig& instrument,
+                                                   const Music::ScaleManager& target) {
+    if (box.min_fret + fret_shift < MIN_FRET || box.max_fret + fret_shift > instrument.getMaxFret()) {
+        return std::nullopt;
+    }
+
+    std::vector<Note> shifted = notes;
+    for (auto& note : shifted) {
+        note.fret.value += fret_shift;
+        if (!instrument.containsPosition(note.string_idx.value, note.fret.value) ||
+            !target.isMidiPitchValid(note.getMidiPitch(instrument))) {
+            return std::nullopt;
+        }
+    }
+    return shifted;
+}
+
+std::vector<PracticeBookPage> buildPracticeBook(const PracticeBookSpec& spec) {
+    Music::ScaleManager scale_mgr;
+    scale_mgr.setKeyAndScale(spec.base_key, spec.scale_name);
+    const std::vector<Note> base = generateExercise(spec, scale_mgr, spec.seed);
+
+    // Same box the generator anchored on the first note
+    PositionBox box{};
+    box.initialize(base.front().fret.value, spec.instrument.getMaxFret(), spec.profile.position_box_radius);
+
+    std::vector<PracticeBookPage> pages;
+    pages.reserve(Music::NUM_KEYS);
+    pages.push_back({spec.base_key, base, 0, false});
+
+    for (int step = 1; step < Music::NUM_KEYS; ++step) {
+        const auto key = static_cast<Music::KeyIndex>((spec.base_key + step) % Music::NUM_KEYS);
+        scale_mgr.setKeyAndScale(key, spec.scale_name);
+
+        // Closer offset first; a tritone tries going down first
+        const int up = step;
+        const int down = step - Music::NUM_KEYS;
+        const int first = std::abs(down) <= up ? down : up;
+        const int second = first == up ? down : up;
+
+        // Rules such as "only fret" or "start root" can fail once shifted
+        const CompiledRules rules = RuleSet::getInstance().compile(spec.instrument, key);
+        PracticeBookPage page{key, {}, 0, false};
+        for (const int shift : {first, second}) {
+            auto moved = transposeExercise(base, shift, box, spec.instrument, scale_mgr);
+            if (moved && rules.accepts(*moved, spec.instrument)) {
+                page.notes = std::move(*moved);
+                page.fret_shift = shift;
+                break;
+            }
+        }
+
+        if (page.notes.empty()) {
+            page.notes = generateExercise(spec, scale_mgr, pageSeed(spec.seed, key));
+            page.regenerated = true;
+        }
+        pages.push_back(std::move(page));
+    }
+
+    return pages;
+}
+
+} // namespace Guitar
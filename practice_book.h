@@ -0,0 +1,50 @@
+#ifndef PRACTICE_BOOK_H
+#define PRACTICE_BOOK_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "fretboard.h"
+#include "generator.h"
+#include "music_theory.h"
+
+namespace Guitar {
+
+// ============================================================================
+// Practice Book - one scale in all 12 keys
+// ============================================================================
+
+struct PracticeBookSpec {
+    InstrumentConfig instrument = getInstrumentConfig(InstrumentType::Guitar);
+    GeneratorProfile profile = STANDARD_PROFILE;
+    std::string scale_name = "Major";
+    Music::KeyIndex base_key = 0;   // Key of the exercise every page is shifted from
+    std::uint32_t seed = 1;
+};
+
+struct PracticeBookPage {
+    Music::KeyIndex key;
+    std::vector<Note> notes;
+    int fret_shift;     // Frets moved from the base exercise (0 on the base page)
+    bool regenerated;   // No shift fit (neck, scale or rules): generated from scratch
+};
+
+// Generates the base exercise once and moves it by the fret offset of each
+// key (up or down, the closer one that keeps the Position Box on the neck).
+// Pages start at base_key and go up chromatically; a key is regenerated only
+// when neither offset fits, a shifted note falls outside the new scale or
+// the shifted exercise breaks the RuleSet.
+[[nodiscard]] std::vector<PracticeBookPage> buildPracticeBook(const PracticeBookSpec& spec);
+
+// `notes` moved by `fret_shift` frets, or std::nullopt if `box` moved with
+// them leaves the neck or a note is not valid in `target`
+[[nodiscard]] std::optional<std::vector<Note>> transposeExercise(const std::vector<Note>& notes,
+                                                                 int fret_shift,
+                                                                 const PositionBox& box,
+                                                                 const InstrumentConfig& instrument,
+                                                                 const Music::ScaleManager& target);
+
+} // namespace Guitar
+
+#endif // PRACTICE_BOOK_H
@@ -8,6 +8,8 @@ namespace Guitar {
 
 RandomEngine::RandomEngine() : engine_{std::random_device{}()} {}
 
+RandomEngine::RandomEngine(std::uint32_t seed) : engine_{seed} {}
+
 int RandomEngine::generateInt(int min_val, int max_val) {
     std::uniform_int_distribution<> dist(min_val, max_val);
     return dist(engine_);
@@ -1,6 +1,7 @@
 #ifndef RANDOM_ENGINE_H
 #define RANDOM_ENGINE_H
 
+#include <cstdint>
 #include <vector>
 #include <random>
 
@@ -13,6 +14,7 @@ namespace Guitar {
 class RandomEngine {
 public:
     RandomEngine();
+    explicit RandomEngine(std::uint32_t seed);  // Reproducible stream (batch jobs)
 
     [[nodiscard]] int generateInt(int min_val, int max_val);
     [[nodiscard]] bool generateBool();
@@ -34,8 +36,19 @@ int RandomEngine::selectWeighted(const std::vector<WeightType>& weights) {
     if (weights.empty()) return -1;
     if (weights.size() == 1) return 0;
 
-    std::discrete_distribution<int> dist(weights.begin(), weights.end());
-    return dist(engine_);
+    // Integer cumulative walk: same distribution as std::discrete_distribution
+    // without building a normalized double table on every call
+    WeightType total = 0;
+    for (const auto& w : weights) total += w;
+    if (total <= 0) return generateInt(0, static_cast<int>(weights.size()) - 1);
+
+    std::uniform_int_distribution<WeightType> dist(0, total - 1);
+    WeightType target = dist(engine_);
+    for (size_t i = 0; i < weights.size(); ++i) {
+        if (target < weights[i]) return static_cast<int>(i);
+        target -= weights[i];
+    }
+    return static_cast<int>(weights.size()) - 1;
 }
 
 } // namespace Guitar
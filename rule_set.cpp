@@ -0,0 +1,298 @@
+#include "rule_set.h"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+
+namespace Guitar {
+
+namespace {
+
+// ============================================================================
+// Parsing Helpers
+// ============================================================================
+
+constexpr std::array<const char*, NUM_RULE_METRICS> METRIC_NAMES = {"string-changes", "strings", "range"};
+
+std::vector<std::string_view> splitWords(std::string_view text) {
+    std::vector<std::string_view> words;
+    std::size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && (text[i] == ' ' || text[i] == '\t')) ++i;
+        const std::size_t start = i;
+        while (i < text.size() && text[i] != ' ' && text[i] != '\t') ++i;
+        if (i > start) words.push_back(text.substr(start, i - start));
+    }
+    return words;
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t' || text.front() == '\r')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+bool parseNumber(std::string_view text, int& value) {
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc{} && end == text.data() + text.size();
+}
+
+// "2", "2-5" or "1,3-4" as one bit per item; items must be in [lo, hi]
+bool parseItems(std::string_view text, int lo, int hi, std::uint32_t& items) {
+    items = 0;
+    while (!text.empty()) {
+        const std::size_t comma = text.find(',');
+        const std::string_view part = text.substr(0, comma);
+        const std::size_t dash = part.find('-');
+        int first = 0;
+        int last = 0;
+        if (!parseNumber(part.substr(0, dash), first)) return false;
+        last = first;
+        if (dash != std::string_view::npos && !parseNumber(part.substr(dash + 1), last)) return false;
+        if (first < lo || last > hi || first > last) return false;
+        items |= fretRangeRow(first - lo, last - lo);
+        if (comma == std::string_view::npos) break;
+        text.remove_prefix(comma + 1);
+    }
+    return items != 0;
+}
+
+// "N" or "N%" within (0, MAX_RULE_PERCENT]
+bool parsePercent(std::string_view text, int& percent) {
+    if (!text.empty() && text.back() == '%') text.remove_suffix(1);
+    return parseNumber(text, percent) && percent > 0 && percent <= MAX_RULE_PERCENT;
+}
+
+} // namespace
+
+// ============================================================================
+// CompiledRules Implementation
+// ============================================================================
+
+bool CompiledRules::accepts(std::span<const Note> notes, const InstrumentConfig& instrument) const {
+    return violations(notes, instrument) == 0;
+}
+
+bool CompiledRules::accepts(const std::vector<std::unique_ptr<Note>>& notes,
+                            const InstrumentConfig& instrument) const {
+    return violations(notes, instrument) == 0;
+}
+
+int CompiledRules::violations(const std::vector<std::unique_ptr<Note>>& notes,
+                              const InstrumentConfig& instrument) const {
+    if (!active || notes.empty()) return 0;
+    // Copied together; a generated exercise (NUM_NOTES) fits on the stack
+    std::array<Note, 32> stack;
+    std::vector<Note> heap(notes.size() > stack.size() ? notes.size() : 0);
+    Note* copy = heap.empty() ? stack.data() : heap.data();
+    for (std::size_t i = 0; i < notes.size(); ++i) copy[i] = *notes[i];
+    return violations(std::span<const Note>(copy, notes.size()), instrument);
+}
+
+int CompiledRules::violations(std::span<const Note> notes, const InstrumentConfig& instrument) const {
+    if (!active || notes.empty()) return 0;
+    int broken = 0;
+    if (!first.test(notes.front().string_idx.value, notes.front().fret.value)) ++broken;
+    if (!last.test(notes.back().string_idx.value, notes.back().fret.value)) ++broken;
+
+    std::array<int, NUM_RULE_METRICS> metric{};
+    std::uint32_t strings = 0;
+    int min_pitch = NUM_MIDI_PITCHES;
+    int max_pitch = -1;
+    for (std::size_t i = 0; i < notes.size(); ++i) {
+        const Note& note = notes[i];
+        if (!allowed.test(note.string_idx.value, note.fret.value)) ++broken;
+        const int pitch = note.getMidiPitch(instrument);
+        if (i > 0) {
+            const Note& previous = notes[i - 1];
+            if (std::abs(pitch - previous.getMidiPitch(instrument)) > max_leap) ++broken;
+            if (note.string_idx.value != previous.string_idx.value) {
+                ++metric[static_cast<std::size_t>(RuleMetric::StringChanges)];
+            }
+        }
+        strings |= 1u << note.string_idx.value;
+        min_pitch = std::min(min_pitch, pitch);
+        max_pitch = std::max(max_pitch, pitch);
+    }
+    metric[static_cast<std::size_t>(RuleMetric::Strings)] = std::popcount(strings);
+    metric[static_cast<std::size_t>(RuleMetric::Range)] = max_pitch - min_pitch;
+
+    for (std::size_t m = 0; m < metric.size(); ++m) {
+        if (metric[m] < min_metric[m] || metric[m] > max_metric[m]) ++broken;
+    }
+    return broken;
+}
+
+// ============================================================================
+// RuleSet Implementation
+// ============================================================================
+
+RuleSet& RuleSet::getInstance() {
+    static RuleSet instance;
+    return instance;
+}
+
+RuleSet::RuleSet() {
+    clear();
+}
+
+void RuleSet::clear() noexcept {
+    rules_.clear();
+    positions_.clear();
+    max_leap_ = NO_LEAP_LIMIT;
+    start_root_ = false;
+    end_root_ = false;
+    min_metric_.fill(0);
+    max_metric_.fill(NO_METRIC_LIMIT);
+}
+
+std::vector<RuleError> RuleSet::parse(std::string_view text) {
+    std::vector<RuleError> errors;
+    RuleSet parsed = *this;
+
+    int line_number = 0;
+    while (!text.empty()) {
+        ++line_number;
+        const std::size_t newline = text.find('\n');
+        std::string_view line = trim(text.substr(0, newline));
+        text.remove_prefix(newline == std::string_view::npos ? text.size() : newline + 1);
+        if (line.empty() || line.front() == '#') continue;
+
+        while (!line.empty()) {
+            const std::size_t semicolon = line.find(';');
+            std::string rule(trim(line.substr(0, semicolon)));
+            line.remove_prefix(semicolon == std::string_view::npos ? line.size() : semicolon + 1);
+            if (rule.empty()) continue;
+            std::transform(rule.begin(), rule.end(), rule.begin(), [](char c) {
+                return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+            });
+
+            const auto words = splitWords(rule);
+            auto fail = [&](const std::string& reason) {
+                errors.push_back({line_number, reason + ": " + rule});
+            };
+            const std::string_view verb = words[0];
+
+            if (verb == "forbid" || verb == "only" || verb == "avoid" || verb == "prefer") {
+                const bool weighted = verb == "avoid" || verb == "prefer";
+                if (words.size() < 3 || words.size() > (weighted ? 4u : 3u)) {
+                    fail("se espera '" + std::string(verb) + " string|fret <lista>" +
+                         (weighted ? " [N%]'" : "'"));
+                    continue;
+                }
+                PositionRule position{};
+                position.action = weighted ? PositionAction::Weight
+                                           : (verb == "forbid" ? PositionAction::Forbid : PositionAction::Only);
+                position.strings = words[1] == "string" || words[1] == "strings";
+                if (!position.strings && words[1] != "fret" && words[1] != "frets") {
+                    fail("se espera 'string' o 'fret'");
+                    continue;
+                }
+                const bool items_ok = position.strings ? parseItems(words[2], 1, MAX_STRINGS, position.items)
+                                                       : parseItems(words[2], 0, MAX_SUPPORTED_FRET, position.items);
+                if (!items_ok) {
+                    fail(position.strings ? "cuerdas invalidas (1-" + std::to_string(MAX_STRINGS) + ")"
+                                          : "trastes invalidos (0-" + std::to_string(MAX_SUPPORTED_FRET) + ")");
+                    continue;
+                }
+                position.percent = verb == "avoid" ? DEFAULT_AVOID_PERCENT : DEFAULT_PREFER_PERCENT;
+                if (words.size() == 4 && !parsePercent(words[3], position.percent)) {
+                    fail("porcentaje invalido (1-" + std::to_string(MAX_RULE_PERCENT) + ")");
+                    continue;
+                }
+                parsed.positions_.push_back(position);
+            } else if (verb == "max-leap") {
+                int leap = 0;
+                if (words.size() != 2 || !parseNumber(words[1], leap) || leap < 0 || leap >= NO_LEAP_LIMIT) {
+                    fail("se espera 'max-leap <semitonos>'");
+                    continue;
+                }
+                parsed.max_leap_ = std::min(parsed.max_leap_, leap);
+            } else if (verb == "start" || verb == "end") {
+                if (words.size() != 2 || words[1] != "root") {
+                    fail("se espera '" + std::string(verb) + " root'");
+                    continue;
+                }
+                (verb == "start" ? parsed.start_root_ : parsed.end_root_) = true;
+            } else if (verb == "min" || verb == "max") {
+                const auto metric = words.size() == 3
+                    ? std::find(METRIC_NAMES.begin(), METRIC_NAMES.end(), words[1])
+                    : METRIC_NAMES.end();
+                int value = 0;
+                if (metric == METRIC_NAMES.end() || !parseNumber(words[2], value) || value < 0) {
+                    fail("se espera '" + std::string(verb) + " string-changes|strings|range <N>'");
+                    continue;
+                }
+                const auto m = static_cast<std::size_t>(metric - METRIC_NAMES.begin());
+                if (verb == "min") {
+                    parsed.min_metric_[m] = std::max(parsed.min_metric_[m], value);
+                } else {
+                    parsed.max_metric_[m] = std::min(parsed.max_metric_[m], value);
+                }
+            } else {
+                fail("regla desconocida");
+                continue;
+            }
+            parsed.rules_.push_back(rule);
+        }
+    }
+
+    if (errors.empty()) *this = std::move(parsed);
+    return errors;
+}
+
+CompiledRules RuleSet::compile(const InstrumentConfig& instrument, Music::KeyIndex key) const {
+    CompiledRules compiled;
+    const std::uint32_t neck = fretRangeRow(0, instrument.getMaxFret());
+    for (int str = 0; str < instrument.num_strings; ++str) {
+        compiled.allowed.rows[str] = neck;
+    }
+    compiled.first = compiled.allowed;
+    compiled.last = compiled.allowed;
+    compiled.min_metric = min_metric_;
+    compiled.max_metric = max_metric_;
+    compiled.max_leap = max_leap_;
+    if (empty()) return compiled;
+    compiled.active = true;
+
+    for (const PositionRule& rule : positions_) {
+        for (int str = 0; str < instrument.num_strings; ++str) {
+            // A string rule covers or misses the whole row; a fret rule is the same row on every string
+            const std::uint32_t row = rule.strings ? (((rule.items >> str) & 1u) ? neck : 0u) : rule.items & neck;
+            switch (rule.action) {
+                case PositionAction::Forbid: compiled.allowed.rows[str] &= ~row; break;
+                case PositionAction::Only:   compiled.allowed.rows[str] &= row; break;
+                case PositionAction::Weight:
+                    for (std::uint32_t frets = row; frets != 0; frets &= frets - 1) {
+                        const auto fret = std::countr_zero(frets);
+                        auto& factor = compiled.percent[static_cast<std::size_t>(str * PITCH_TABLE_STRIDE + fret)];
+                        const int base = compiled.weighted.test(str, fret) ? factor : 100;
+                        factor = static_cast<std::uint16_t>(std::clamp(base * rule.percent / 100, 1, MAX_RULE_PERCENT));
+                        compiled.weighted.set(str, fret);
+                    }
+                    break;
+            }
+        }
+    }
+
+    compiled.first = compiled.allowed;
+    compiled.last = compiled.allowed;
+    if (start_root_ || end_root_) {
+        FretMask root;
+        for (int str = 0; str < instrument.num_strings; ++str) {
+            for (int fret = 0; fret <= instrument.getMaxFret(); ++fret) {
+                if (instrument.getPitch(str, fret) % Music::SEMITONES_IN_OCTAVE == key) root.set(str, fret);
+            }
+        }
+        for (int str = 0; str < instrument.num_strings; ++str) {
+            if (start_root_) compiled.first.rows[str] &= root.rows[str];
+            if (end_root_) compiled.last.rows[str] &= root.rows[str];
+        }
+    }
+    return compiled;
+}
+
+} // namespace Guitar
@@ -0,0 +1,141 @@
+#ifndef RULE_SET_H
+#define RULE_SET_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "fretboard.h"
+#include "music_theory.h"
+
+namespace Guitar {
+
+// ============================================================================
+// Constants - Exercise Rules
+// ============================================================================
+
+constexpr const char* DEFAULT_RULE_FILE = "crazyfingers.rules";  // Loaded at startup if present
+
+constexpr int MAX_RULE_ATTEMPTS = 64;        // Exercises tried before keeping the one closest to the rules
+constexpr int DEFAULT_AVOID_PERCENT = 25;    // "avoid" without a percentage
+constexpr int DEFAULT_PREFER_PERCENT = 200;  // "prefer" without a percentage
+constexpr int MAX_RULE_PERCENT = 1000;       // Combined weight factor bounds: 1%-1000%
+constexpr int NO_LEAP_LIMIT = NUM_MIDI_PITCHES;
+constexpr int NO_METRIC_LIMIT = 1 << 30;
+
+// Whole-exercise measures a "min"/"max" rule can bound
+enum class RuleMetric : std::uint8_t {
+    StringChanges,   // Moves to another string
+    Strings,         // Different strings used
+    Range            // Highest minus lowest pitch, in semitones
+};
+
+constexpr int NUM_RULE_METRICS = 3;
+
+// ============================================================================
+// Compiled Rules - masks over (string, fret) for one instrument and key
+// ============================================================================
+
+// Every rule as word operations for the generator: position rules are
+// rows ANDed into each step's candidate rows, "max-leap" narrows the
+// pitch band, weight rules are a factor per position behind one bit test,
+// and "min"/"max" rules are counted once per finished exercise. Without
+// rules every mask is full and nothing is counted.
+struct CompiledRules {
+    bool active = false;
+    FretMask allowed;      // Every note
+    FretMask first;        // First note: allowed & "start"
+    FretMask last;         // Last note: allowed & "end"
+    FretMask weighted;     // Positions with a weight factor
+    std::array<std::uint16_t, MAX_STRINGS * PITCH_TABLE_STRIDE> percent{};  // Factor of a weighted position
+    int max_leap = NO_LEAP_LIMIT;  // Semitones between consecutive notes
+    std::array<int, NUM_RULE_METRICS> min_metric{};
+    std::array<int, NUM_RULE_METRICS> max_metric{};
+
+    // Weight of a candidate at (string, fret) after the weight rules; a
+    // weight of 0 (a move the profile rules out) stays 0
+    [[nodiscard]] int adjustWeight(int weight, int string_idx, int fret) const noexcept {
+        if (weight == 0 || !weighted.test(string_idx, fret)) return weight;
+        const int factor = percent[static_cast<std::size_t>(string_idx * PITCH_TABLE_STRIDE + fret)];
+        return std::max(1, static_cast<int>(static_cast<long long>(weight) * factor / 100));
+    }
+
+    // Every rule holds for the whole exercise (positions, leaps, start,
+    // end and the min/max measures)
+    [[nodiscard]] bool accepts(std::span<const Note> notes, const InstrumentConfig& instrument) const;
+    [[nodiscard]] bool accepts(const std::vector<std::unique_ptr<Note>>& notes,
+                               const InstrumentConfig& instrument) const;
+
+    // Broken rules, to rank exercises that miss them: one per note off the
+    // allowed positions, leap too wide, wrong start/end and measure out of bounds
+    [[nodiscard]] int violations(std::span<const Note> notes, const InstrumentConfig& instrument) const;
+    [[nodiscard]] int violations(const std::vector<std::unique_ptr<Note>>& notes,
+                                 const InstrumentConfig& instrument) const;
+};
+
+// ============================================================================
+// Rule Set - the parsed rules, independent of instrument and key
+// ============================================================================
+
+struct RuleError {
+    int line;             // 1-based
+    std::string reason;
+};
+
+// One rule per line (or separated by ';'), '#' starts a comment line.
+// Strings are numbered as in the tab, 1 = highest; lists are "2", "2-5"
+// or "1,3-4"; frets are 0-31.
+//   forbid string 2        forbid fret 0          (never)
+//   only string 2-5        only fret 0-7          (nowhere else)
+//   avoid string 2 [N%]    prefer fret 5-7 [N%]   (weight x N%, 25% / 200%)
+//   max-leap 7             (semitones between consecutive notes)
+//   start root             end root               (first / last note on the key)
+//   min string-changes 3   max strings 4          max range 12
+// Position rules combine as an AND, weight factors multiply.
+class RuleSet {
+public:
+    // Rules used by makeNoteGenerator (load them before generating)
+    static RuleSet& getInstance();
+
+    RuleSet();
+
+    void clear() noexcept;
+
+    [[nodiscard]] bool empty() const noexcept { return rules_.empty(); }
+    [[nodiscard]] std::size_t size() const noexcept { return rules_.size(); }
+
+    // Rules as written, one per entry, normalized to lower case
+    [[nodiscard]] const std::vector<std::string>& getRules() const noexcept { return rules_; }
+
+    // Adds the rules of `text`; on any error none of them are added
+    [[nodiscard]] std::vector<RuleError> parse(std::string_view text);
+
+    // Masks for an instrument, "root" being the key's pitch class
+    [[nodiscard]] CompiledRules compile(const InstrumentConfig& instrument, Music::KeyIndex key) const;
+
+private:
+    enum class PositionAction : std::uint8_t { Forbid, Only, Weight };
+
+    struct PositionRule {
+        PositionAction action;
+        bool strings;            // Targets strings (else frets)
+        std::uint32_t items;     // Bit per string (0 = string 1) or fret
+        int percent;
+    };
+
+    std::vector<std::string> rules_;
+    std::vector<PositionRule> positions_;
+    int max_leap_ = NO_LEAP_LIMIT;
+    bool start_root_ = false;
+    bool end_root_ = false;
+    std::array<int, NUM_RULE_METRICS> min_metric_{};
+    std::array<int, NUM_RULE_METRICS> max_metric_{};
+};
+
+} // namespace Guitar
+
+#endif // RULE_SET_H
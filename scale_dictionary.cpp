@@ -1,9 +1,71 @@
 #include "scale_dictionary.h"
+#include "mapped_file.h"
+#include "music_theory.h"
 #include <random>
 #include <algorithm>
+#include <charconv>
+#include <numeric>
 
 namespace Music {
 
+namespace {
+
+std::string_view trimView(std::string_view text) {
+    const auto first = text.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos) return {};
+    const auto last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+bool parseNumber(std::string_view text, int& value) {
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc{} && result.ptr == text.data() + text.size();
+}
+
+// Fills `intervals` (repeated until the pattern closes on the octave) from
+// "1 3 1 2 1 3 1 [| period]"; returns why the line is invalid, or ""
+std::string parseScaleBody(std::string_view body, std::vector<int>& intervals) {
+    int period = SEMITONES_IN_OCTAVE;
+    if (const auto bar = body.find('|'); bar != std::string_view::npos) {
+        if (!parseNumber(trimView(body.substr(bar + 1)), period) || period < 1 || period > MAX_SCALE_PERIOD) {
+            return "periodo invalido (1-" + std::to_string(MAX_SCALE_PERIOD) + ")";
+        }
+        body = body.substr(0, bar);
+    }
+
+    std::vector<int> pattern;
+    int sum = 0;
+    std::size_t pos = 0;
+    while (pos < body.size()) {
+        const auto start = body.find_first_not_of(" \t\r,", pos);
+        if (start == std::string_view::npos) break;
+        auto end = body.find_first_of(" \t\r,", start);
+        if (end == std::string_view::npos) end = body.size();
+        pos = end;
+
+        int interval = 0;
+        if (!parseNumber(body.substr(start, end - start), interval) || interval < 1 || interval > period) {
+            return "intervalo invalido: " + std::string(body.substr(start, end - start));
+        }
+        pattern.push_back(interval);
+        sum += interval;
+    }
+
+    if (pattern.empty()) return "sin intervalos";
+    if (sum != period) {
+        return "los intervalos suman " + std::to_string(sum) + ", no " + std::to_string(period);
+    }
+
+    const int repeats = std::lcm(period, SEMITONES_IN_OCTAVE) / period;
+    intervals.clear();
+    for (int i = 0; i < repeats; ++i) {
+        intervals.insert(intervals.end(), pattern.begin(), pattern.end());
+    }
+    return "";
+}
+
+} // namespace
+
 // ============================================================================
 // ScaleDictionary Implementation
 // ============================================================================
@@ -12,6 +74,8 @@ ScaleDictionary::ScaleDictionary() {
     initializeDictionary();
 }
 
+ScaleDictionary::~ScaleDictionary() = default;
+
 ScaleDictionary& ScaleDictionary::getInstance() {
     static ScaleDictionary instance;
     return instance;
@@ -139,9 +203,13 @@ void ScaleDictionary::initializeDictionary() {
         "Moorish Phrygian", "Double Harmonic", "Enigmatic"
     };
     
-    // Build all_names_ list
-    for (const auto& [name, _] : scales_) {
-        all_names_.push_back(name);
+    // Built-in IDs follow the category listings
+    category_order_ = {"Common/Modes", "Symmetric/Altered", "Jazz/Bebop", "Exotic & World"};
+    for (const auto& category : category_order_) {
+        for (const auto& name : categories_[category]) {
+            builtin_ids_.emplace(name, static_cast<std::uint32_t>(all_names_.size()));
+            all_names_.push_back(name);
+        }
     }
 }
 
@@ -150,32 +218,198 @@ std::vector<int> ScaleDictionary::getIntervals(const std::string& name) const {
     if (it != scales_.end()) {
         return it->second;
     }
+    if (hasUserScales()) {
+        const UserScale* user = findUserScale(name);
+        if (user && !user->intervals.empty()) return user->intervals;
+    }
     return {2, 2, 1, 2, 2, 2, 1};  // Default to Major
 }
 
 std::vector<std::string> ScaleDictionary::getAllScaleNames() const {
-    return all_names_;
+    std::vector<std::string> names = all_names_;
+    if (hasUserScales()) {
+        indexUserScales();
+        for (std::uint32_t i = 0; i < user_scales_.size(); ++i) {
+            const UserScale& user = parseUserScale(i);
+            if (!user.intervals.empty()) names.emplace_back(user.name);
+        }
+    }
+    return names;
 }
 
 std::vector<std::string> ScaleDictionary::getScalesByCategory(const std::string& category) const {
+    std::vector<std::string> names;
     auto it = categories_.find(category);
     if (it != categories_.end()) {
-        return it->second;
+        names = it->second;
+    }
+    if (hasUserScales()) {
+        indexUserScales();
+        for (std::uint32_t i = 0; i < user_scales_.size(); ++i) {
+            if (user_scales_[i].category != category) continue;
+            const UserScale& user = parseUserScale(i);
+            if (!user.intervals.empty()) names.emplace_back(user.name);
+        }
     }
-    return {};
+    return names;
 }
 
 bool ScaleDictionary::hasScale(const std::string& name) const {
-    return scales_.find(name) != scales_.end();
+    if (scales_.find(name) != scales_.end()) return true;
+    if (!hasUserScales()) return false;
+    const UserScale* user = findUserScale(name);
+    return user && !user->intervals.empty();
 }
 
 std::string ScaleDictionary::getRandomScaleName() const {
-    if (all_names_.empty()) return "Major";
+    // Only valid user scales take part: an invalid line must not hand its
+    // turn to the scale after it
+    std::vector<std::uint32_t> valid_user;
+    if (hasUserScales()) {
+        indexUserScales();
+        for (std::uint32_t i = 0; i < user_scales_.size(); ++i) {
+            if (!parseUserScale(i).intervals.empty()) valid_user.push_back(i);
+        }
+    }
+    const std::size_t total = all_names_.size() + valid_user.size();
+    if (total == 0) return "Major";
     
     std::random_device rd;
     std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dist(0, static_cast<int>(all_names_.size()) - 1);
-    return all_names_[dist(gen)];
+    std::uniform_int_distribution<std::size_t> dist(0, total - 1);
+    const std::size_t pick = dist(gen);
+    if (pick < all_names_.size()) return all_names_[pick];
+    return std::string(user_scales_[valid_user[pick - all_names_.size()]].name);
+}
+
+std::vector<std::string> ScaleDictionary::getCategoryNames() const {
+    std::vector<std::string> names = category_order_;
+    if (hasUserScales()) {
+        indexUserScales();
+        for (std::uint32_t i = 0; i < user_scales_.size(); ++i) {
+            const UserScale& user = parseUserScale(i);
+            if (user.intervals.empty()) continue;
+            if (std::find(names.begin(), names.end(), user.category) == names.end()) {
+                names.emplace_back(user.category);
+            }
+        }
+    }
+    return names;
+}
+
+std::optional<std::uint32_t> ScaleDictionary::getScaleId(const std::string& name) const {
+    auto it = builtin_ids_.find(name);
+    if (it != builtin_ids_.end()) return it->second;
+    if (!hasUserScales()) return std::nullopt;
+
+    const UserScale* user = findUserScale(name);
+    if (!user || user->intervals.empty()) return std::nullopt;
+    return static_cast<std::uint32_t>(all_names_.size()) + user_index_.find(user->name)->second;
+}
+
+std::string ScaleDictionary::getScaleName(std::uint32_t id) const {
+    if (id < all_names_.size()) return all_names_[id];
+    if (!hasUserScales()) return "";
+
+    indexUserScales();
+    const std::uint32_t index = id - static_cast<std::uint32_t>(all_names_.size());
+    if (index >= user_scales_.size()) return "";
+    const UserScale& user = parseUserScale(index);
+    return user.intervals.empty() ? "" : std::string(user.name);
+}
+
+std::uint32_t ScaleDictionary::getBuiltinCount() const noexcept {
+    return static_cast<std::uint32_t>(all_names_.size());
+}
+
+// ============================================================================
+// User Scale Files
+// ============================================================================
+
+bool ScaleDictionary::loadScaleFile(const std::string& path) {
+    auto file = MappedFile::open(path);
+    if (!file) return false;
+
+    std::lock_guard<std::mutex> lock(user_mutex_);
+    source_paths_.push_back(path);
+    sources_.push_back(std::move(file));
+    return true;
+}
+
+std::vector<ScaleFileError> ScaleDictionary::getScaleFileErrors() const {
+    std::vector<ScaleFileError> errors;
+    if (!hasUserScales()) return errors;
+
+    indexUserScales();
+    for (std::uint32_t i = 0; i < user_scales_.size(); ++i) {
+        const UserScale& user = parseUserScale(i);
+        if (user.intervals.empty()) {
+            errors.push_back({source_paths_[user.source], user.line, user.error});
+        }
+    }
+    return errors;
+}
+
+void ScaleDictionary::indexUserScales() const {
+    if (indexed_sources_.load(std::memory_order_acquire) == sources_.size()) return;
+
+    std::lock_guard<std::mutex> lock(user_mutex_);
+    for (std::size_t source = indexed_sources_.load(std::memory_order_relaxed); source < sources_.size(); ++source) {
+        const std::string_view text = sources_[source]->view();
+        int line_number = 0;
+        std::size_t pos = 0;
+
+        while (pos < text.size()) {
+            auto end = text.find('\n', pos);
+            if (end == std::string_view::npos) end = text.size();
+            const std::string_view line = trimView(text.substr(pos, end - pos));
+            pos = end + 1;
+            ++line_number;
+            if (line.empty() || line.front() == '#') continue;
+
+            // Only the name and category are split here; the intervals wait for first use
+            UserScale& scale = user_scales_.emplace_back();
+            scale.source = source;
+            scale.line = line_number;
+
+            const auto first = line.find('|');
+            const auto second = first == std::string_view::npos ? first : line.find('|', first + 1);
+            if (second != std::string_view::npos) {
+                scale.name = trimView(line.substr(0, first));
+                scale.category = trimView(line.substr(first + 1, second - first - 1));
+                scale.body = line.substr(second + 1);
+            }
+
+            if (second == std::string_view::npos || scale.name.empty() || scale.category.empty()) {
+                scale.error = "formato esperado: Nombre | Categoria | intervalos [| periodo]";
+            } else if (scales_.count(std::string(scale.name)) || user_index_.count(scale.name)) {
+                scale.error = "escala repetida: " + std::string(scale.name);
+            } else {
+                user_index_.emplace(scale.name, static_cast<std::uint32_t>(user_scales_.size() - 1));
+                continue;
+            }
+            scale.parsed.store(true, std::memory_order_relaxed);
+        }
+    }
+    indexed_sources_.store(sources_.size(), std::memory_order_release);
+}
+
+const ScaleDictionary::UserScale* ScaleDictionary::findUserScale(std::string_view name) const {
+    indexUserScales();
+    auto it = user_index_.find(name);
+    return it != user_index_.end() ? &parseUserScale(it->second) : nullptr;
+}
+
+const ScaleDictionary::UserScale& ScaleDictionary::parseUserScale(std::uint32_t index) const {
+    UserScale& scale = user_scales_[index];
+    if (!scale.parsed.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(user_mutex_);
+        if (!scale.parsed.load(std::memory_order_relaxed)) {
+            scale.error = parseScaleBody(scale.body, scale.intervals);
+            scale.parsed.store(true, std::memory_order_release);
+        }
+    }
+    return scale;
 }
 
 } // namespace Music
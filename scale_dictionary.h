@@ -1,12 +1,36 @@
 #ifndef SCALE_DICTIONARY_H
 #define SCALE_DICTIONARY_H
 
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 
 namespace Music {
 
+// ============================================================================
+// User Scale Files - one "Name | Category | 1 3 1 2 1 3 1 [| period]" per line
+// ============================================================================
+// Blank lines and lines starting with '#' are ignored. Intervals must sum to
+// the period (12 unless declared, at most MAX_SCALE_PERIOD); shorter periods
+// are repeated until they close on the octave.
+
+constexpr int MAX_SCALE_PERIOD = 24;
+
+struct ScaleFileError {
+    std::string path;
+    int line;
+    std::string reason;
+};
+
+class MappedFile;  // Read-only memory map of a whole file
+
 // ============================================================================
 // Scale Dictionary Class - Provides runtime access to all scales
 // Over 70 scales from ethnomusicology consensus
@@ -31,13 +55,60 @@ public:
     // Get random scale name
     [[nodiscard]] std::string getRandomScaleName() const;
 
+    // Category names: built-ins first, then new user categories in file order
+    [[nodiscard]] std::vector<std::string> getCategoryNames() const;
+
+    // Stable IDs: built-ins are 0..getBuiltinCount()-1 in category order,
+    // user scales follow in load order (an invalid line keeps its ID)
+    [[nodiscard]] std::optional<std::uint32_t> getScaleId(const std::string& name) const;
+    [[nodiscard]] std::string getScaleName(std::uint32_t id) const;  // "" if unknown or invalid
+    [[nodiscard]] std::uint32_t getBuiltinCount() const noexcept;
+
+    // Maps a user scale file; false if it cannot be opened. Nothing is read
+    // until a user scale is needed: the first lookup indexes the names in
+    // place and each scale is parsed and validated the first time it is used.
+    // Load files before generating; lookups are safe from any thread.
+    [[nodiscard]] bool loadScaleFile(const std::string& path);
+
+    // Parses every user scale and reports the invalid lines
+    [[nodiscard]] std::vector<ScaleFileError> getScaleFileErrors() const;
+
 private:
+    // One scale line of a user file; the views point into the mapping
+    struct UserScale {
+        std::string_view name;
+        std::string_view category;
+        std::string_view body;  // "intervals [| period]"
+        std::size_t source;
+        int line;
+        std::atomic<bool> parsed{false};
+        std::vector<int> intervals;  // Empty when invalid
+        std::string error;
+    };
+
     ScaleDictionary();
+    ~ScaleDictionary();
     void initializeDictionary();
-    
+
+    void indexUserScales() const;
+    [[nodiscard]] const UserScale* findUserScale(std::string_view name) const;  // Parsed, valid or not
+    [[nodiscard]] const UserScale& parseUserScale(std::uint32_t index) const;
+    [[nodiscard]] bool hasUserScales() const noexcept { return !sources_.empty(); }
+
     std::unordered_map<std::string, std::vector<int>> scales_;
-    std::vector<std::string> all_names_;
+    std::vector<std::string> all_names_;  // Built-in IDs, in category order
+    std::unordered_map<std::string, std::uint32_t> builtin_ids_;
     std::unordered_map<std::string, std::vector<std::string>> categories_;
+    std::vector<std::string> category_order_;
+
+    std::vector<std::string> source_paths_;
+    std::vector<std::unique_ptr<MappedFile>> sources_;
+
+    // Filled lazily under user_mutex_; readers check the atomics first
+    mutable std::mutex user_mutex_;
+    mutable std::atomic<std::size_t> indexed_sources_{0};
+    mutable std::deque<UserScale> user_scales_;
+    mutable std::unordered_map<std::string_view, std::uint32_t> user_index_;
 };
 
 } // namespace Music
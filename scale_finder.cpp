@@ -0,0 +1,211 @@
+#include "scale_finder.h"
+#include "scale_dictionary.h"
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <sstream>
+
+// The AVX2 compare uses a per-function target attribute, so it builds without
+// -mavx2 and is picked at runtime from the CPU features
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CRAZYFINGERS_FINDER_SIMD 1
+#include <immintrin.h>
+#else
+#define CRAZYFINGERS_FINDER_SIMD 0
+#endif
+
+namespace Music {
+
+namespace {
+
+constexpr std::size_t TABLE_PADDING = 32;  // Whole AVX2 blocks, masks of 0 never match
+constexpr uint16_t OCTAVE_MASK = (1u << SEMITONES_IN_OCTAVE) - 1;
+
+uint16_t rotateMask(uint16_t mask, int semitones) noexcept {
+    return static_cast<uint16_t>(((mask << semitones) | (mask >> (SEMITONES_IN_OCTAVE - semitones))) & OCTAVE_MASK);
+}
+
+uint16_t intervalsToMask(const std::vector<int>& intervals) noexcept {
+    uint16_t mask = 1;  // Root
+    int current = 0;
+    for (int interval : intervals) {
+        current = (current + interval) % SEMITONES_IN_OCTAVE;
+        mask = static_cast<uint16_t>(mask | (1u << current));
+    }
+    return mask;
+}
+
+// ============================================================================
+// Containment Kernels - entries whose mask holds every query bit
+// ============================================================================
+
+void containingScalar(const std::vector<uint16_t>& masks, uint16_t query, std::vector<uint32_t>& out) {
+    for (std::size_t i = 0; i < masks.size(); ++i) {
+        if ((masks[i] & query) == query) out.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+#if CRAZYFINGERS_FINDER_SIMD
+
+[[gnu::target("avx2")]]
+void containingAvx2(const std::vector<uint16_t>& masks, uint16_t query, std::vector<uint32_t>& out) {
+    const __m256i wanted = _mm256_set1_epi16(static_cast<short>(query));
+    for (std::size_t i = 0; i < masks.size(); i += 16) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masks.data() + i));
+        const __m256i hit = _mm256_cmpeq_epi16(_mm256_and_si256(block, wanted), wanted);
+        // Two mask bits per 16-bit entry; keep the low one
+        auto bits = static_cast<uint32_t>(_mm256_movemask_epi8(hit)) & 0x55555555u;
+        while (bits) {
+            out.push_back(static_cast<uint32_t>(i) + static_cast<uint32_t>(std::countr_zero(bits)) / 2);
+            bits &= bits - 1;
+        }
+    }
+}
+
+#endif
+
+void findContaining(const std::vector<uint16_t>& masks, uint16_t query, std::vector<uint32_t>& out) {
+#if CRAZYFINGERS_FINDER_SIMD
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    if (has_avx2) {
+        containingAvx2(masks, query, out);
+        return;
+    }
+#endif
+    containingScalar(masks, query, out);
+}
+
+} // namespace
+
+// ============================================================================
+// Pitch-Class Sets
+// ============================================================================
+
+std::optional<uint16_t> parsePitchClassSet(const std::string& text) {
+    std::string normalized = text;
+    std::replace(normalized.begin(), normalized.end(), ',', ' ');
+
+    std::istringstream tokens(normalized);
+    std::string token;
+    uint16_t mask = 0;
+    while (tokens >> token) {
+        int pitch_class = -1;
+        if (std::all_of(token.begin(), token.end(), [](unsigned char c) { return std::isdigit(c); })) {
+            pitch_class = token.size() <= 2 ? std::stoi(token) : -1;
+            if (pitch_class >= NUM_KEYS) pitch_class = -1;
+        } else {
+            int shift = 0;
+            if (token.size() == 2 && token[1] == 'b') {
+                token.pop_back();  // Flat: one semitone below the natural
+                shift = -1;
+            }
+            const int key = parseKeyName(token);
+            if (key >= 0) pitch_class = (key + shift + NUM_KEYS) % NUM_KEYS;
+        }
+
+        if (pitch_class < 0) return std::nullopt;
+        mask = static_cast<uint16_t>(mask | (1u << pitch_class));
+    }
+
+    if (mask == 0) return std::nullopt;
+    return mask;
+}
+
+std::string describePitchClassSet(uint16_t mask) {
+    std::string text;
+    for (int pc = 0; pc < NUM_KEYS; ++pc) {
+        if (!(mask & (1u << pc))) continue;
+        if (!text.empty()) text += ' ';
+        text += NOTE_NAMES[pc];
+    }
+    return text;
+}
+
+// ============================================================================
+// ScaleFinder Implementation
+// ============================================================================
+
+ScaleFinder::ScaleFinder()
+    : names_{ScaleDictionary::getInstance().getAllScaleNames()}
+    , ids_{}
+    , masks_{}
+    , num_entries_{0} {
+    const auto& dict = ScaleDictionary::getInstance();
+
+    num_entries_ = names_.size() * NUM_KEYS;
+    masks_.assign((num_entries_ + TABLE_PADDING - 1) / TABLE_PADDING * TABLE_PADDING, 0);
+    ids_.reserve(names_.size());
+
+    for (std::size_t scale = 0; scale < names_.size(); ++scale) {
+        ids_.push_back(dict.getScaleId(names_[scale]).value_or(0));
+        const uint16_t root_mask = intervalsToMask(dict.getIntervals(names_[scale]));
+        for (int key = 0; key < NUM_KEYS; ++key) {
+            masks_[scale * NUM_KEYS + key] = rotateMask(root_mask, key);
+        }
+    }
+}
+
+uint16_t ScaleFinder::getMask(KeyIndex key, uint32_t scale) const noexcept {
+    return masks_[static_cast<std::size_t>(scale) * NUM_KEYS + key];
+}
+
+ScaleMatch ScaleFinder::makeMatch(uint32_t entry, uint16_t query) const noexcept {
+    const uint16_t mask = masks_[entry];
+    const auto key = static_cast<KeyIndex>(entry % NUM_KEYS);
+    return ScaleMatch{
+        .key = key,
+        .scale = entry / NUM_KEYS,
+        .matched = std::popcount(static_cast<unsigned>(mask & query)),
+        .extra = std::popcount(static_cast<unsigned>(mask & ~query & OCTAVE_MASK)),
+        .root_in_query = (query & (1u << key)) != 0,
+    };
+}
+
+std::vector<ScaleMatch> ScaleFinder::rank(std::vector<ScaleMatch> matches, std::size_t limit) const {
+    auto tighter = [](const ScaleMatch& a, const ScaleMatch& b) {
+        if (a.matched != b.matched) return a.matched > b.matched;
+        if (a.extra != b.extra) return a.extra < b.extra;
+        if (a.root_in_query != b.root_in_query) return a.root_in_query;
+        if (a.scale != b.scale) return a.scale < b.scale;
+        return a.key < b.key;
+    };
+
+    if (limit > 0 && limit < matches.size()) {
+        std::partial_sort(matches.begin(), matches.begin() + static_cast<std::ptrdiff_t>(limit),
+                          matches.end(), tighter);
+        matches.resize(limit);
+    } else {
+        std::sort(matches.begin(), matches.end(), tighter);
+    }
+    return matches;
+}
+
+std::vector<ScaleMatch> ScaleFinder::find(uint16_t query, std::size_t limit) const {
+    query &= OCTAVE_MASK;
+
+    std::vector<uint32_t> entries;
+    entries.reserve(num_entries_);
+    findContaining(masks_, query, entries);
+
+    std::vector<ScaleMatch> matches;
+    matches.reserve(entries.size());
+    for (uint32_t entry : entries) {
+        if (entry < num_entries_) matches.push_back(makeMatch(entry, query));
+    }
+    return rank(std::move(matches), limit);
+}
+
+std::vector<ScaleMatch> ScaleFinder::findPartial(uint16_t query, int min_matched, std::size_t limit) const {
+    query &= OCTAVE_MASK;
+    min_matched = std::max(min_matched, 1);
+
+    std::vector<ScaleMatch> matches;
+    for (std::size_t entry = 0; entry < num_entries_; ++entry) {
+        if (std::popcount(static_cast<unsigned>(masks_[entry] & query)) >= min_matched) {
+            matches.push_back(makeMatch(static_cast<uint32_t>(entry), query));
+        }
+    }
+    return rank(std::move(matches), limit);
+}
+
+} // namespace Music
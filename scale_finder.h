@@ -0,0 +1,73 @@
+#ifndef SCALE_FINDER_H
+#define SCALE_FINDER_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "music_theory.h"
+
+namespace Music {
+
+// ============================================================================
+// Pitch-Class Sets - 12-bit masks (bit 0 = C, bit 11 = B)
+// ============================================================================
+
+// "C E G Bb", "c,e,g" or "0 4 7"; flats are accepted as in parseMidiNoteName
+// Returns std::nullopt if any token is not a note name or 0-11
+[[nodiscard]] std::optional<uint16_t> parsePitchClassSet(const std::string& text);
+
+// "C E G A#" (ascending from C)
+[[nodiscard]] std::string describePitchClassSet(uint16_t mask);
+
+// ============================================================================
+// Scale Match
+// ============================================================================
+
+struct ScaleMatch {
+    KeyIndex key;
+    uint32_t scale;     // Finder table index (see getScaleName / getScaleId)
+    int matched;        // Query notes inside the scale
+    int extra;          // Scale notes outside the query (lower = tighter fit)
+    bool root_in_query;
+};
+
+// ============================================================================
+// Scale Finder - every (key, scale) pair as one rotated mask
+// ============================================================================
+
+// Snapshot of ScaleDictionary (user scales included) taken at construction.
+// Exact queries compare the whole 12 x N mask table at once (AVX2 when the
+// CPU has it); partial queries rank by overlap, popcount(mask & query).
+class ScaleFinder {
+public:
+    ScaleFinder();
+
+    // Pairs containing every query note, tightest first: fewest extra notes,
+    // then the scale's root among the query, then dictionary order.
+    // limit = 0 returns every match.
+    [[nodiscard]] std::vector<ScaleMatch> find(uint16_t query, std::size_t limit = 0) const;
+
+    // Pairs containing at least `min_matched` query notes, most shared notes
+    // first and then as find()
+    [[nodiscard]] std::vector<ScaleMatch> findPartial(uint16_t query, int min_matched,
+                                                      std::size_t limit = 0) const;
+
+    [[nodiscard]] const std::string& getScaleName(uint32_t scale) const { return names_[scale]; }
+    [[nodiscard]] uint32_t getScaleId(uint32_t scale) const { return ids_[scale]; }  // ScaleDictionary ID
+    [[nodiscard]] uint16_t getMask(KeyIndex key, uint32_t scale) const noexcept;
+    [[nodiscard]] std::size_t getScaleCount() const noexcept { return names_.size(); }
+
+private:
+    [[nodiscard]] ScaleMatch makeMatch(uint32_t entry, uint16_t query) const noexcept;
+    [[nodiscard]] std::vector<ScaleMatch> rank(std::vector<ScaleMatch> matches, std::size_t limit) const;
+
+    std::vector<std::string> names_;  // Dictionary order, invalid user lines skipped
+    std::vector<uint32_t> ids_;
+    std::vector<uint16_t> masks_;     // Entry = scale * 12 + key, padded to 32 entries
+    std::size_t num_entries_;
+};
+
+} // namespace Music
+
+#endif // SCALE_FINDER_H
@@ -0,0 +1,454 @@
+#include "similarity.h"
+#include "generator.h"
+#include "scale_dictionary.h"
+#include "thread_count.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace Guitar {
+
+namespace {
+
+// ============================================================================
+// Hashing Helpers
+// ============================================================================
+
+constexpr char INDEX_MAGIC[8] = {'C', 'F', 'S', 'I', 'M', 'L', 'S', 'H'};
+constexpr std::uint32_t INDEX_VERSION = 3;  // v2: full instrument descriptor, v3: box radius
+
+// Feature tags keep the four feature families in disjoint token spaces
+constexpr std::uint64_t TAG_CONTOUR = 1;
+constexpr std::uint64_t TAG_STRING_TRANSITION = 2;
+constexpr std::uint64_t TAG_FRET_HISTOGRAM = 3;
+constexpr std::uint64_t TAG_DISTANCE_CLASS = 4;
+
+constexpr int MAX_HISTOGRAM_DELTA = 5;  // Deltas >= 5 share the last bin
+
+// Every string delta of the widest instrument, shifted to 0..2 * MAX (one byte)
+constexpr int MAX_STRING_DELTA = MAX_STRINGS - 1;
+static_assert(2 * MAX_STRING_DELTA < 0xFF, "String deltas must stay below the end marker");
+
+// SplitMix64 finalizer: cheap and well distributed
+constexpr std::uint64_t mix64(std::uint64_t x) noexcept {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+constexpr std::array<std::uint64_t, MINHASH_SIZE> makeHashSeeds() {
+    std::array<std::uint64_t, MINHASH_SIZE> seeds{};
+    for (int i = 0; i < MINHASH_SIZE; ++i) {
+        seeds[i] = mix64(static_cast<std::uint64_t>(i) * 0xD1B54A32D192ED03ULL + 1);
+    }
+    return seeds;
+}
+
+constexpr auto HASH_SEEDS = makeHashSeeds();
+
+constexpr std::uint64_t makeToken(std::uint64_t tag, std::uint64_t payload) noexcept {
+    return (tag << 56) | (payload & 0x00FFFFFFFFFFFFFFULL);
+}
+
+// Signed pitch step bucketed into 9 symbols (-4..4 shifted to 0..8)
+int contourSymbol(int pitch_delta) noexcept {
+    const int magnitude = pitch_delta < 0 ? -pitch_delta : pitch_delta;
+    int bucket = 0;
+    if (magnitude >= 8) bucket = 4;
+    else if (magnitude >= 5) bucket = 3;
+    else if (magnitude >= 3) bucket = 2;
+    else if (magnitude >= 1) bucket = 1;
+    return (pitch_delta < 0 ? -bucket : bucket) + 4;
+}
+
+std::uint32_t bandKey(const MinHashSignature& signature, int band) noexcept {
+    std::uint64_t packed = 0;
+    for (int r = 0; r < LSH_ROWS; ++r) {
+        packed = (packed << 16) | signature[band * LSH_ROWS + r];
+    }
+    return static_cast<std::uint32_t>(mix64(packed ^ static_cast<std::uint64_t>(band)));
+}
+
+std::uint32_t exerciseSeed(std::uint32_t base_seed, std::uint32_t id) noexcept {
+    return static_cast<std::uint32_t>(mix64((static_cast<std::uint64_t>(base_seed) << 32) | id));
+}
+
+template<typename T>
+void writeVector(std::ofstream& out, const std::vector<T>& values) {
+    out.write(reinterpret_cast<const char*>(values.data()),
+              static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+template<typename T>
+bool readVector(std::ifstream& in, std::vector<T>& values, std::size_t count) {
+    values.resize(count);
+    in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(count * sizeof(T)));
+    return static_cast<bool>(in);
+}
+
+template<typename T>
+void writeValue(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool readValue(std::ifstream& in, T& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return static_cast<bool>(in);
+}
+
+void writeString(std::ofstream& out, const std::string& text) {
+    writeValue(out, static_cast<std::uint16_t>(text.size()));
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+bool readString(std::ifstream& in, std::string& text) {
+    std::uint16_t length = 0;
+    if (!readValue(in, length)) return false;
+    text.resize(length);
+    in.read(text.data(), length);
+    return static_cast<bool>(in);
+}
+
+} // namespace
+
+// ============================================================================
+// Feature Extraction Implementation
+// ============================================================================
+
+std::vector<std::uint64_t> extractFeatures(const std::vector<Note>& notes,
+                                           const InstrumentConfig& instrument,
+                                           int box_radius) {
+    std::vector<std::uint64_t> features;
+    if (notes.size() < 2) return features;
+
+    const std::size_t steps = notes.size() - 1;
+    features.reserve(steps * 4);
+
+    std::vector<int> contour(steps);
+    std::vector<int> classes(steps);
+    std::array<int, MAX_HISTOGRAM_DELTA + 1> histogram{};
+
+    for (std::size_t i = 0; i < steps; ++i) {
+        const Note& from = notes[i];
+        const Note& to = notes[i + 1];
+
+        contour[i] = contourSymbol(to.getMidiPitch(instrument) - from.getMidiPitch(instrument));
+
+        const int fret_delta = std::abs(to.fret.value - from.fret.value);
+        classes[i] = static_cast<int>(classifyFretDistance(fret_delta, box_radius));
+        histogram[std::min(fret_delta, MAX_HISTOGRAM_DELTA)]++;
+
+        const int string_delta = std::clamp(to.string_idx.value - from.string_idx.value,
+                                            -MAX_STRING_DELTA, MAX_STRING_DELTA) + MAX_STRING_DELTA;
+        const int next_delta = (i + 1 < steps)
+            ? std::clamp(notes[i + 2].string_idx.value - to.string_idx.value,
+                         -MAX_STRING_DELTA, MAX_STRING_DELTA) + MAX_STRING_DELTA
+            : 0xFF;  // End marker keeps the final transition in the set
+        features.push_back(makeToken(TAG_STRING_TRANSITION,
+                                     static_cast<std::uint64_t>(string_delta << 8 | next_delta)));
+    }
+
+    const std::size_t trigrams = steps > 2 ? steps - 2 : 1;
+    for (std::size_t i = 0; i < trigrams; ++i) {
+        const std::uint64_t c0 = static_cast<std::uint64_t>(contour[i]);
+        const std::uint64_t c1 = i + 1 < steps ? static_cast<std::uint64_t>(contour[i + 1]) : 0xFF;
+        const std::uint64_t c2 = i + 2 < steps ? static_cast<std::uint64_t>(contour[i + 2]) : 0xFF;
+        features.push_back(makeToken(TAG_CONTOUR, c0 << 16 | c1 << 8 | c2));
+
+        const std::uint64_t d0 = static_cast<std::uint64_t>(classes[i]);
+        const std::uint64_t d1 = i + 1 < steps ? static_cast<std::uint64_t>(classes[i + 1]) : 0xFF;
+        const std::uint64_t d2 = i + 2 < steps ? static_cast<std::uint64_t>(classes[i + 2]) : 0xFF;
+        features.push_back(makeToken(TAG_DISTANCE_CLASS, d0 << 16 | d1 << 8 | d2));
+    }
+
+    // Histogram as a set: bin b with count c contributes (b, 1) .. (b, c)
+    for (int bin = 0; bin <= MAX_HISTOGRAM_DELTA; ++bin) {
+        for (int k = 1; k <= histogram[bin]; ++k) {
+            features.push_back(makeToken(TAG_FRET_HISTOGRAM, static_cast<std::uint64_t>(bin << 8 | k)));
+        }
+    }
+
+    std::sort(features.begin(), features.end());
+    features.erase(std::unique(features.begin(), features.end()), features.end());
+    return features;
+}
+
+MinHashSignature computeSignature(const std::vector<std::uint64_t>& features) {
+    MinHashSignature signature;
+    signature.fill(0xFFFF);
+
+    for (std::uint64_t feature : features) {
+        for (int i = 0; i < MINHASH_SIZE; ++i) {
+            const auto h = static_cast<std::uint16_t>(mix64(feature ^ HASH_SEEDS[i]) >> 48);
+            if (h < signature[i]) signature[i] = h;
+        }
+    }
+
+    return signature;
+}
+
+double estimateSimilarity(const MinHashSignature& a, const MinHashSignature& b) noexcept {
+    int matches = 0;
+    for (int i = 0; i < MINHASH_SIZE; ++i) {
+        matches += (a[i] == b[i]) ? 1 : 0;
+    }
+    return static_cast<double>(matches) / MINHASH_SIZE;
+}
+
+// ============================================================================
+// SimilarityIndex Implementation
+// ============================================================================
+
+void SimilarityIndex::build(const CorpusSpec& spec) {
+    const auto& dict = Music::ScaleDictionary::getInstance();
+
+    instrument_ = spec.instrument;
+    notes_per_exercise_ = NUM_NOTES;
+    box_radius_ = spec.profile.position_box_radius;
+    scale_names_ = dict.getAllScaleNames();
+
+    int fixed_scale_id = -1;
+    if (!spec.scale_name.empty()) {
+        const auto it = std::find(scale_names_.begin(), scale_names_.end(), spec.scale_name);
+        if (it != scale_names_.end()) {
+            fixed_scale_id = static_cast<int>(it - scale_names_.begin());
+        }
+    }
+
+    const std::size_t count = spec.count;
+    keys_.assign(count, 0);
+    scale_ids_.assign(count, 0);
+    packed_notes_.assign(count * NUM_NOTES, 0);
+    signatures_.assign(count, MinHashSignature{});
+
+    const unsigned num_threads = resolveThreads(spec.num_threads);
+
+    auto worker = [&](std::size_t begin, std::size_t end) {
+        Music::ScaleManager scale_mgr;
+        std::vector<Note> notes;
+        notes.reserve(NUM_NOTES);
+
+        for (std::size_t id = begin; id < end; ++id) {
+            const std::uint32_t seed = exerciseSeed(spec.base_seed, static_cast<std::uint32_t>(id));
+            RandomEngine picker(seed);
+
+            const int key = spec.key >= 0 ? spec.key : picker.generateInt(0, Music::NUM_KEYS - 1);
+            const int scale_id = fixed_scale_id >= 0
+                ? fixed_scale_id
+                : picker.generateInt(0, static_cast<int>(scale_names_.size()) - 1);
+
+            scale_mgr.setKeyAndScale(static_cast<Music::KeyIndex>(key), scale_names_[scale_id]);
+            FretboardValidator validator(scale_mgr, instrument_);
+            const auto generator = makeNoteGenerator(validator, spec.profile, seed);
+            const auto generated = generator->generateTablature();
+
+            notes.clear();
+            for (std::size_t n = 0; n < generated.size(); ++n) {
+                notes.push_back(*generated[n]);
+                packed_notes_[id * NUM_NOTES + n] = static_cast<std::uint16_t>(
+                    generated[n]->string_idx.value << 8 | generated[n]->fret.value);
+            }
+
+            keys_[id] = static_cast<std::uint8_t>(key);
+            scale_ids_[id] = static_cast<std::uint16_t>(scale_id);
+            signatures_[id] = computeSignature(extractFeatures(notes, instrument_, box_radius_));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    const std::size_t chunk = (count + num_threads - 1) / num_threads;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        const std::size_t begin = t * chunk;
+        const std::size_t end = std::min(count, begin + chunk);
+        if (begin >= end) break;
+        threads.emplace_back(worker, begin, end);
+    }
+    for (auto& thread : threads) thread.join();
+
+    buildBands(num_threads);
+}
+
+void SimilarityIndex::buildBands(unsigned num_threads) {
+    // Each band is independent: threads own whole bands, no locking needed
+    auto worker = [this](int first_band, int stride) {
+        for (int band = first_band; band < LSH_BANDS; band += stride) {
+            auto& entries = bands_[band];
+            entries.resize(signatures_.size());
+            for (std::size_t id = 0; id < signatures_.size(); ++id) {
+                entries[id] = {bandKey(signatures_[id], band), static_cast<std::uint32_t>(id)};
+            }
+            std::sort(entries.begin(), entries.end(), [](const BucketEntry& a, const BucketEntry& b) {
+                return a.band_key != b.band_key ? a.band_key < b.band_key : a.id < b.id;
+            });
+        }
+    };
+
+    const int stride = static_cast<int>(std::min<unsigned>(num_threads, LSH_BANDS));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < stride; ++t) {
+        threads.emplace_back(worker, t, stride);
+    }
+    for (auto& thread : threads) thread.join();
+}
+
+bool SimilarityIndex::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+
+    const auto count = static_cast<std::uint32_t>(size());
+    out.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    writeValue(out, INDEX_VERSION);
+    writeValue(out, static_cast<std::uint32_t>(instrument_.type));
+    writeString(out, instrument_.name);
+    writeString(out, instrument_.tuning_name);
+    writeValue(out, static_cast<std::uint32_t>(instrument_.num_strings));
+    writeValue(out, instrument_.open_midi);
+    writeValue(out, static_cast<std::uint32_t>(instrument_.num_frets));
+    writeValue(out, static_cast<std::uint32_t>(instrument_.capo));
+    writeValue(out, static_cast<std::uint32_t>(notes_per_exercise_));
+    writeValue(out, static_cast<std::uint32_t>(box_radius_));
+    writeValue(out, count);
+    writeValue(out, static_cast<std::uint32_t>(scale_names_.size()));
+
+    for (const auto& name : scale_names_) {
+        writeString(out, name);
+    }
+
+    writeVector(out, keys_);
+    writeVector(out, scale_ids_);
+    writeVector(out, packed_notes_);
+    writeVector(out, signatures_);
+    for (const auto& band : bands_) {
+        writeVector(out, band);
+    }
+
+    return static_cast<bool>(out);
+}
+
+bool SimilarityIndex::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    char magic[sizeof(INDEX_MAGIC)];
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) return false;
+
+    std::uint32_t version = 0, type = 0, num_strings = 0, num_frets = 0, capo = 0;
+    std::uint32_t notes_per_exercise = 0, box_radius = 0, count = 0, num_names = 0;
+    std::string name, tuning_name;
+    std::array<int, MAX_STRINGS> open_midi{};
+    if (!readValue(in, version) || version != INDEX_VERSION) return false;
+    if (!readValue(in, type) || !readString(in, name) || !readString(in, tuning_name) ||
+        !readValue(in, num_strings) || !readValue(in, open_midi) ||
+        !readValue(in, num_frets) || !readValue(in, capo)) return false;
+    if (!readValue(in, notes_per_exercise) || !readValue(in, box_radius) ||
+        !readValue(in, count) || !readValue(in, num_names)) return false;
+    if (num_strings > MAX_STRINGS || notes_per_exercise == 0 || box_radius > MAX_PROFILE_BOX_RADIUS) return false;
+
+    const std::vector<int> low_to_high(open_midi.rend() - num_strings, open_midi.rend());
+    auto instrument = makeInstrument(static_cast<InstrumentType>(type), name, tuning_name, low_to_high,
+                                     static_cast<int>(num_frets), static_cast<int>(capo));
+    if (!instrument) return false;
+
+    SimilarityIndex loaded;
+    loaded.instrument_ = *instrument;
+    loaded.notes_per_exercise_ = static_cast<int>(notes_per_exercise);
+    loaded.box_radius_ = static_cast<int>(box_radius);
+    loaded.scale_names_.assign(num_names, std::string{});
+    for (auto& scale_name : loaded.scale_names_) {
+        if (!readString(in, scale_name)) return false;
+    }
+
+    // Every array is `count` long: a count the rest of the file cannot hold
+    // is a corrupt header, rejected before anything is allocated
+    const std::uint64_t per_exercise = sizeof(std::uint8_t) + sizeof(std::uint16_t) +
+                                       std::uint64_t{notes_per_exercise} * sizeof(std::uint16_t) +
+                                       sizeof(MinHashSignature) + LSH_BANDS * sizeof(BucketEntry);
+    const auto data_start = in.tellg();
+    in.seekg(0, std::ios::end);
+    const auto remaining = static_cast<std::uint64_t>(in.tellg() - data_start);
+    in.seekg(data_start);
+    if (std::uint64_t{count} * per_exercise > remaining) return false;
+
+    if (!readVector(in, loaded.keys_, count)) return false;
+    if (!readVector(in, loaded.scale_ids_, count)) return false;
+    if (!readVector(in, loaded.packed_notes_, static_cast<std::size_t>(count) * notes_per_exercise)) return false;
+    if (!readVector(in, loaded.signatures_, count)) return false;
+    for (auto& band : loaded.bands_) {
+        if (!readVector(in, band, count)) return false;
+    }
+
+    // Ids index the name table, the neck and the corpus: check them once
+    // here so the accessors stay plain array reads
+    for (std::uint32_t id = 0; id < count; ++id) {
+        if (loaded.keys_[id] >= Music::NUM_KEYS || loaded.scale_ids_[id] >= num_names) return false;
+    }
+    for (const std::uint16_t packed : loaded.packed_notes_) {
+        if (!loaded.instrument_.containsPosition(packed >> 8, packed & 0xFF)) return false;
+    }
+    for (const auto& band : loaded.bands_) {
+        for (const BucketEntry& entry : band) {
+            if (entry.id >= count) return false;
+        }
+        const auto by_key = [](const BucketEntry& a, const BucketEntry& b) { return a.band_key < b.band_key; };
+        if (!std::is_sorted(band.begin(), band.end(), by_key)) return false;
+    }
+
+    *this = std::move(loaded);
+    return true;
+}
+
+std::vector<SimilarityMatch> SimilarityIndex::query(const std::vector<Note>& notes, int top_k) const {
+    std::vector<SimilarityMatch> matches;
+    if (signatures_.empty() || top_k <= 0) return matches;
+
+    const MinHashSignature signature = computeSignature(extractFeatures(notes, instrument_, box_radius_));
+
+    // Gather candidates sharing at least one band bucket
+    std::vector<std::uint32_t> candidates;
+    for (int band = 0; band < LSH_BANDS; ++band) {
+        const std::uint32_t key = bandKey(signature, band);
+        const auto& entries = bands_[band];
+        auto it = std::lower_bound(entries.begin(), entries.end(), key,
+                                   [](const BucketEntry& e, std::uint32_t k) { return e.band_key < k; });
+
+        for (int scanned = 0; it != entries.end() && it->band_key == key && scanned < MAX_BUCKET_SCAN;
+             ++it, ++scanned) {
+            candidates.push_back(it->id);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    matches.reserve(candidates.size());
+    for (std::uint32_t id : candidates) {
+        matches.push_back({id, estimateSimilarity(signature, signatures_[id])});
+    }
+
+    const auto by_score = [](const SimilarityMatch& a, const SimilarityMatch& b) {
+        return a.similarity != b.similarity ? a.similarity > b.similarity : a.id < b.id;
+    };
+    const std::size_t keep = std::min(matches.size(), static_cast<std::size_t>(top_k));
+    std::partial_sort(matches.begin(), matches.begin() + static_cast<std::ptrdiff_t>(keep), matches.end(), by_score);
+    matches.resize(keep);
+
+    return matches;
+}
+
+std::vector<Note> SimilarityIndex::getExercise(std::uint32_t id) const {
+    const int num_strings = instrument_.num_strings;
+
+    std::vector<Note> notes;
+    notes.reserve(notes_per_exercise_);
+    for (int n = 0; n < notes_per_exercise_; ++n) {
+        const std::uint16_t packed = packed_notes_[static_cast<std::size_t>(id) * notes_per_exercise_ + n];
+        notes.push_back({{packed >> 8, num_strings}, {packed & 0xFF}});
+    }
+    return notes;
+}
+
+} // namespace Guitar
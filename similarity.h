@@ -0,0 +1,112 @@
+#ifndef SIMILARITY_H
+#define SIMILARITY_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "fretboard.h"
+#include "generator.h"
+#include "music_theory.h"
+
+namespace Guitar {
+
+// ============================================================================
+// Constants - MinHash Signature + LSH Banding
+// ============================================================================
+
+constexpr int MINHASH_SIZE = 64;                     // Hash functions per signature
+constexpr int LSH_BANDS = 16;                        // Buckets probed per query
+constexpr int LSH_ROWS = MINHASH_SIZE / LSH_BANDS;   // Signature rows per band
+constexpr int MAX_BUCKET_SCAN = 4096;                // Cap per band (very common shapes)
+
+static_assert(LSH_BANDS * LSH_ROWS == MINHASH_SIZE, "Bands must tile the signature");
+
+// 16-bit MinHash values: unrelated collisions stay at 1/65536 and
+// the signature of a million-exercise corpus fits in 128 MB
+using MinHashSignature = std::array<std::uint16_t, MINHASH_SIZE>;
+
+// ============================================================================
+// Feature Extraction
+// ============================================================================
+
+// Shingles describing the "shape" of an exercise, independent of key:
+//   - interval contour (trigrams of signed, bucketed pitch steps)
+//   - string-transition pattern (bigrams of string deltas)
+//   - fret-delta histogram (multiset expanded to a set)
+//   - distance classes used by the weight system (trigrams), measured
+//     against the Position Box radius of the profile that generated them
+[[nodiscard]] std::vector<std::uint64_t> extractFeatures(const std::vector<Note>& notes,
+                                                        const InstrumentConfig& instrument,
+                                                        int box_radius);
+
+[[nodiscard]] MinHashSignature computeSignature(const std::vector<std::uint64_t>& features);
+
+// Fraction of agreeing signature rows (estimates the Jaccard similarity)
+[[nodiscard]] double estimateSimilarity(const MinHashSignature& a, const MinHashSignature& b) noexcept;
+
+// ============================================================================
+// Corpus Description
+// ============================================================================
+
+struct CorpusSpec {
+    InstrumentConfig instrument = getInstrumentConfig(InstrumentType::Guitar);
+    GeneratorProfile profile = STANDARD_PROFILE;
+    std::uint32_t count = 100000;
+    std::uint32_t base_seed = 1;
+    int key = -1;                 // -1 = random key per exercise
+    std::string scale_name;       // Empty = random scale per exercise
+    unsigned num_threads = 0;     // 0 = all hardware threads
+};
+
+struct SimilarityMatch {
+    std::uint32_t id;
+    double similarity;
+};
+
+// ============================================================================
+// Similarity Index - MinHash LSH over a generated exercise corpus
+// ============================================================================
+
+class SimilarityIndex {
+public:
+    SimilarityIndex() = default;
+
+    // Generate the corpus and index it (parallel, reproducible per seed)
+    void build(const CorpusSpec& spec);
+
+    // Binary persistence (signatures and band tables are stored, not rebuilt)
+    [[nodiscard]] bool save(const std::string& path) const;
+    [[nodiscard]] bool load(const std::string& path);
+
+    // Top-k most similar exercises, best first
+    [[nodiscard]] std::vector<SimilarityMatch> query(const std::vector<Note>& notes, int top_k) const;
+
+    [[nodiscard]] std::size_t size() const noexcept { return keys_.size(); }
+    [[nodiscard]] const InstrumentConfig& getInstrument() const noexcept { return instrument_; }
+    [[nodiscard]] std::vector<Note> getExercise(std::uint32_t id) const;
+    [[nodiscard]] Music::KeyIndex getKey(std::uint32_t id) const { return keys_[id]; }
+    [[nodiscard]] const std::string& getScaleName(std::uint32_t id) const { return scale_names_[scale_ids_[id]]; }
+
+private:
+    struct BucketEntry {
+        std::uint32_t band_key;
+        std::uint32_t id;
+    };
+
+    void buildBands(unsigned num_threads);
+
+    InstrumentConfig instrument_ = getInstrumentConfig(InstrumentType::Guitar);
+    int notes_per_exercise_ = 0;
+    int box_radius_ = POSITION_BOX_RADIUS;        // Profile radius of the distance classes
+    std::vector<std::string> scale_names_;        // Snapshot of the dictionary order
+    std::vector<std::uint8_t> keys_;
+    std::vector<std::uint16_t> scale_ids_;
+    std::vector<std::uint16_t> packed_notes_;     // (string << 8) | fret
+    std::vector<MinHashSignature> signatures_;
+    std::array<std::vector<BucketEntry>, LSH_BANDS> bands_;  // Sorted by band_key
+};
+
+} // namespace Guitar
+
+#endif // SIMILARITY_H
@@ -0,0 +1,141 @@
+#include "svg_sheet.h"
+#include "exporter.h"
+#include <algorithm>
+#include <bitset>
+
+namespace Guitar {
+
+namespace {
+
+// ============================================================================
+// Constants - Block Geometry (relative to the content box)
+// ============================================================================
+
+constexpr int CONTENT_WIDTH = SHEET_PAGE_WIDTH - 2 * SHEET_MARGIN;
+constexpr int PAGE_HEADER_HEIGHT = 40;
+constexpr int BLOCK_HEADER_HEIGHT = 28;   // Harmonic info above the staff
+constexpr int BLOCK_GAP = 30;
+constexpr int LABEL_WIDTH = 22;           // String labels left of the staff
+constexpr int BOX_PADDING = 8;            // Position Box beyond the outer staff lines
+constexpr int NOTE_STEP = (CONTENT_WIDTH - LABEL_WIDTH - 16) / NUM_NOTES;
+constexpr int FIRST_NOTE_X = LABEL_WIDTH + (CONTENT_WIDTH - LABEL_WIDTH - NOTE_STEP * NUM_NOTES + NOTE_STEP) / 2;
+
+constexpr const char* STYLE =
+    "<style>text{font-family:Helvetica,Arial,sans-serif}"
+    ".l{font-size:10px;fill:#555}.f{font-size:11px;text-anchor:middle}"
+    ".h{font-size:13px}.t{font-size:18px;font-weight:bold}.p{font-size:11px;text-anchor:end;fill:#555}"
+    ".b{fill:#eef4ff;stroke:#4a6fb5}.bt{font-size:10px;text-anchor:end;fill:#2b4a86}</style>";
+
+} // namespace
+
+// ============================================================================
+// SvgSheetRenderer Implementation
+// ============================================================================
+
+SvgSheetRenderer::SvgSheetRenderer(const InstrumentConfig& instrument, const SheetOptions& options)
+    : instrument_{instrument}
+    , options_{options}
+    , per_page_{0}
+    , staff_height_{(instrument.num_strings - 1) * SHEET_STRING_SPACING}
+    , block_height_{BLOCK_HEADER_HEIGHT + staff_height_ + BLOCK_GAP}
+    , staff_symbol_{}
+    , fret_glyphs_(static_cast<std::size_t>(MAX_SUPPORTED_FRET) + 1)
+    , page_{} {
+    const int usable = SHEET_PAGE_HEIGHT - 2 * SHEET_MARGIN - PAGE_HEADER_HEIGHT;
+    const int fit = std::clamp(usable / block_height_, 1, MAX_SHEET_EXERCISES);
+    per_page_ = options_.exercises_per_page > 0 ? std::min(options_.exercises_per_page, fit) : fit;
+
+    // Staff: one line per string, labels, opening and closing bars
+    staff_symbol_ = "<g id=\"staff\" stroke=\"#000\" stroke-width=\"0.8\">";
+    for (int s = 0; s < instrument_.num_strings; ++s) {
+        const int y = s * SHEET_STRING_SPACING;
+        staff_symbol_ += "<path d=\"M" + std::to_string(LABEL_WIDTH) + " " + std::to_string(y) + "H" +
+                         std::to_string(CONTENT_WIDTH) + "\"/>";
+        staff_symbol_ += "<text class=\"l\" stroke=\"none\" x=\"0\" y=\"" + std::to_string(y + 3) + "\">" +
+                         escapeXml(instrument_.labels[s]) + "</text>";
+    }
+    staff_symbol_ += "<path stroke-width=\"1.6\" d=\"M" + std::to_string(LABEL_WIDTH) + " 0V" +
+                     std::to_string(staff_height_) + "M" + std::to_string(CONTENT_WIDTH) + " 0V" +
+                     std::to_string(staff_height_) + "\"/></g>";
+}
+
+const std::string& SvgSheetRenderer::fretGlyph(int fret) {
+    std::string& glyph = fret_glyphs_[fret];
+    if (glyph.empty()) {
+        // Backing in the Position Box colour breaks the staff line behind the number
+        const int width = fret >= 10 ? 14 : 8;
+        glyph = "<g id=\"f" + std::to_string(fret) + "\"><rect x=\"" + std::to_string(-width / 2) +
+                "\" y=\"-6\" width=\"" + std::to_string(width) + "\" height=\"12\" fill=\"#eef4ff\"/>"
+                "<text class=\"f\" y=\"4\">" + std::to_string(fret) + "</text></g>";
+    }
+    return glyph;
+}
+
+void SvgSheetRenderer::renderPage(std::ostream& out, const std::vector<SheetExercise>& exercises,
+                                  int page_number, int page_count) {
+    const auto count = std::min<std::size_t>(exercises.size(), static_cast<std::size_t>(per_page_));
+
+    std::bitset<MAX_SUPPORTED_FRET + 1> used;
+    for (std::size_t i = 0; i < count; ++i) {
+        for (const auto& note : exercises[i].notes) used.set(static_cast<std::size_t>(note.fret.value));
+    }
+
+    page_.clear();
+    page_ += "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" + std::to_string(SHEET_PAGE_WIDTH) +
+             "\" height=\"" + std::to_string(SHEET_PAGE_HEIGHT) + "\" viewBox=\"0 0 " +
+             std::to_string(SHEET_PAGE_WIDTH) + " " + std::to_string(SHEET_PAGE_HEIGHT) + "\">";
+    page_ += STYLE;
+    page_ += "<defs>" + staff_symbol_;
+    for (int fret = 0; fret <= MAX_SUPPORTED_FRET; ++fret) {
+        if (used.test(static_cast<std::size_t>(fret))) page_ += fretGlyph(fret);
+    }
+    page_ += "</defs><rect width=\"100%\" height=\"100%\" fill=\"#fff\"/>";
+
+    // Page header: title and page number
+    page_ += "<g transform=\"translate(" + std::to_string(SHEET_MARGIN) + " " + std::to_string(SHEET_MARGIN) + ")\">";
+    page_ += "<text class=\"t\" y=\"18\">" + escapeXml(options_.title) + "</text>";
+    page_ += "<text class=\"p\" x=\"" + std::to_string(CONTENT_WIDTH) + "\" y=\"18\">" +
+             escapeXml(instrument_.name + " (" + describeTuning(instrument_) + ")") + " - " +
+             std::to_string(page_number) + "/" + std::to_string(page_count) + "</text>";
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const SheetExercise& exercise = exercises[i];
+        const int top = PAGE_HEADER_HEIGHT + static_cast<int>(i) * block_height_;
+        const int staff_top = top + BLOCK_HEADER_HEIGHT;
+
+        // Header as printHarmonicInfo
+        page_ += "<text class=\"h\" y=\"" + std::to_string(top + 14) + "\"><tspan font-weight=\"bold\">" +
+                 escapeXml(exercise.key_name + " " + exercise.scale_name) + "</tspan> (" +
+                 escapeXml(exercise.scale_notes) + ")</text>";
+
+        // Position Box behind the staff: every string, from the first note
+        // to the last, labelled with its fret range (the generator anchors
+        // it on the first note)
+        const auto shown = std::min<std::size_t>(exercise.notes.size(), static_cast<std::size_t>(NUM_NOTES));
+        if (shown > 0) {
+            PositionBox box{};
+            box.initialize(exercise.notes.front().fret.value, instrument_.getMaxFret(), options_.box_radius);
+            const int left = FIRST_NOTE_X - NOTE_STEP / 2;
+            const int right = FIRST_NOTE_X + static_cast<int>(shown - 1) * NOTE_STEP + NOTE_STEP / 2;
+            page_ += "<rect class=\"b\" x=\"" + std::to_string(left) + "\" y=\"" +
+                     std::to_string(staff_top - BOX_PADDING) + "\" width=\"" + std::to_string(right - left) +
+                     "\" height=\"" + std::to_string(staff_height_ + 2 * BOX_PADDING) + "\" rx=\"4\"/>";
+            page_ += "<text class=\"bt\" x=\"" + std::to_string(right) + "\" y=\"" +
+                     std::to_string(staff_top - BOX_PADDING - 3) + "\">Caja trastes " +
+                     std::to_string(box.min_fret) + "-" + std::to_string(box.max_fret) + "</text>";
+        }
+
+        page_ += "<use href=\"#staff\" y=\"" + std::to_string(staff_top) + "\"/>";
+        for (std::size_t n = 0; n < exercise.notes.size() && n < static_cast<std::size_t>(NUM_NOTES); ++n) {
+            const Note& note = exercise.notes[n];
+            page_ += "<use href=\"#f" + std::to_string(note.fret.value) + "\" x=\"" +
+                     std::to_string(FIRST_NOTE_X + static_cast<int>(n) * NOTE_STEP) + "\" y=\"" +
+                     std::to_string(staff_top + note.string_idx.value * SHEET_STRING_SPACING) + "\"/>";
+        }
+    }
+
+    page_ += "</g></svg>\n";
+    out.write(page_.data(), static_cast<std::streamsize>(page_.size()));
+}
+
+} // namespace Guitar
@@ -0,0 +1,72 @@
+#ifndef SVG_SHEET_H
+#define SVG_SHEET_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "fretboard.h"
+#include "generator.h"
+
+namespace Guitar {
+
+// ============================================================================
+// Constants - Page Layout (A4 portrait at 96 dpi)
+// ============================================================================
+
+constexpr int SHEET_PAGE_WIDTH = 794;
+constexpr int SHEET_PAGE_HEIGHT = 1123;
+constexpr int SHEET_MARGIN = 48;
+constexpr int SHEET_STRING_SPACING = 12;   // Between staff lines
+constexpr int MAX_SHEET_EXERCISES = 12;    // Per page
+
+// ============================================================================
+// Sheet Content
+// ============================================================================
+
+struct SheetOptions {
+    std::string title = "CrazyFingers";
+    int exercises_per_page = 0;                    // 0 = as many as fit (up to MAX_SHEET_EXERCISES)
+    int box_radius = POSITION_BOX_RADIUS;          // Position Box shaded behind each staff
+};
+
+struct SheetExercise {
+    std::vector<Note> notes;
+    std::string key_name;       // Header as printHarmonicInfo: "C Major (C D E F G A B C)"
+    std::string scale_name;
+    std::string scale_notes;
+};
+
+// ============================================================================
+// SVG Sheet Renderer
+// ============================================================================
+
+// Each page is a standalone SVG document. The staff, the fret numbers and
+// the page furniture are defined once in <defs> and placed with <use>, so a
+// page costs one short element per note; definitions are formatted once per
+// renderer and only the glyphs a page needs are emitted.
+class SvgSheetRenderer {
+public:
+    SvgSheetRenderer(const InstrumentConfig& instrument, const SheetOptions& options);
+
+    [[nodiscard]] int getExercisesPerPage() const noexcept { return per_page_; }
+
+    // `exercises` holds at most getExercisesPerPage() entries; pages count from 1
+    void renderPage(std::ostream& out, const std::vector<SheetExercise>& exercises,
+                    int page_number, int page_count);
+
+private:
+    [[nodiscard]] const std::string& fretGlyph(int fret);
+
+    InstrumentConfig instrument_;
+    SheetOptions options_;
+    int per_page_;
+    int staff_height_;                      // Outer string to outer string
+    int block_height_;                      // Header + staff + gap
+    std::string staff_symbol_;              // <symbol id="staff"> (lines, labels, bars)
+    std::vector<std::string> fret_glyphs_;  // Definition per fret, formatted on first use
+    std::string page_;                      // Reused page buffer
+};
+
+} // namespace Guitar
+
+#endif // SVG_SHEET_H
@@ -0,0 +1,257 @@
+#include "synth.h"
+#include "thread_count.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <thread>
+
+namespace Guitar {
+
+namespace {
+
+// ============================================================================
+// Constants - Voice Tuning
+// ============================================================================
+
+constexpr double REFERENCE_DECAY_SECONDS = 3.0;  // T60 of an open A2 (110 Hz)
+constexpr double REFERENCE_FREQUENCY = 110.0;
+constexpr double MIN_DECAY_SECONDS = 0.8;
+constexpr double MAX_DECAY_SECONDS = 8.0;
+constexpr float PLUCK_AMPLITUDE = 0.5f;
+constexpr float MIX_GAIN = 0.35f;
+constexpr float SILENCE = 1e-4f;               // -80 dB: the voice stops being mixed
+constexpr double FADE_OUT_SECONDS = 0.01;      // Avoids a click at the end
+
+double midiToFrequency(int midi_pitch) noexcept {
+    return 440.0 * std::pow(2.0, (midi_pitch - 69) / 12.0);
+}
+
+std::uint32_t xorshift32(std::uint32_t& state) noexcept {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Distinct, never-zero noise state per (seed, exercise, note)
+std::uint32_t noiseSeed(std::uint32_t seed, std::uint32_t exercise, std::size_t note) noexcept {
+    std::uint64_t x = (static_cast<std::uint64_t>(seed) << 32) ^ (static_cast<std::uint64_t>(exercise) << 8) ^ note;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    const auto state = static_cast<std::uint32_t>(x ^ (x >> 31));
+    return state != 0 ? state : 0x9E3779B9u;
+}
+
+// ============================================================================
+// Voice - one string's delay line
+// ============================================================================
+
+struct Voice {
+    std::vector<float> line;  // [0, history) past samples, then the block being computed
+    int period = 0;           // Whole-sample part of the loop delay
+    int history = 0;          // period + 2 samples the filter reads back
+    float g0 = 0.0f;          // Taps on y[n - period], y[n - period - 1], y[n - period - 2]
+    float g1 = 0.0f;
+    float g2 = 0.0f;
+    bool active = false;
+
+    void pluck(double frequency, double decay_seconds, int sample_rate, std::uint32_t noise) {
+        const double delay = sample_rate / frequency;  // Total loop delay in samples
+        period = std::max(2, static_cast<int>(delay - 0.5));
+        const double fraction = std::clamp(delay - 0.5 - period, 0.0, 1.0);
+        history = period + 2;
+
+        // Loop gain per pass so the note falls 60 dB in decay_seconds
+        const double rho = std::pow(10.0, -3.0 / (decay_seconds * frequency));
+        g0 = static_cast<float>(rho * 0.5 * (1.0 - fraction));
+        g1 = static_cast<float>(rho * 0.5);
+        g2 = static_cast<float>(rho * 0.5 * fraction);
+
+        // White-noise burst with the DC removed fills one period
+        line.assign(static_cast<std::size_t>(history + SYNTH_BLOCK_SIZE), 0.0f);
+        float mean = 0.0f;
+        for (int i = 0; i < history; ++i) {
+            line[i] = PLUCK_AMPLITUDE * (static_cast<float>(xorshift32(noise) >> 8) * (2.0f / 16777216.0f) - 1.0f);
+            mean += line[i];
+        }
+        mean /= static_cast<float>(history);
+        for (int i = 0; i < history; ++i) line[i] -= mean;
+        active = true;
+    }
+
+    // Adds `count` (<= SYNTH_BLOCK_SIZE) new samples to `mix`
+    void process(float* __restrict mix, int count) {
+        float* const base = line.data();
+        for (int done = 0; done < count; done += period) {
+            // No sample of this chunk depends on another one of the same chunk
+            const int chunk = std::min(period, count - done);
+            const float* __restrict src = base + done;
+            float* __restrict dst = base + history + done;
+            for (int i = 0; i < chunk; ++i) {
+                dst[i] = g2 * src[i] + g1 * src[i + 1] + g0 * src[i + 2];
+            }
+        }
+
+        const float* out = base + history;
+        float peak = 0.0f;
+        for (int i = 0; i < count; ++i) {
+            mix[i] += out[i];
+            peak = std::max(peak, std::fabs(out[i]));
+        }
+
+        std::memmove(base, base + count, static_cast<std::size_t>(history) * sizeof(float));
+        active = peak > SILENCE;
+    }
+};
+
+} // namespace
+
+// ============================================================================
+// Render Options
+// ============================================================================
+
+bool isValidRenderOptions(const RenderOptions& options) noexcept {
+    return options.sample_rate >= MIN_SAMPLE_RATE && options.sample_rate <= MAX_SAMPLE_RATE &&
+           (options.bits == 16 || options.bits == 24) &&
+           options.tempo_bpm >= 20 && options.tempo_bpm <= 400 &&
+           (options.note_value == 4 || options.note_value == 8 || options.note_value == 16);
+}
+
+// ============================================================================
+// StringSynth Implementation
+// ============================================================================
+
+StringSynth::StringSynth(const InstrumentConfig& instrument, const RenderOptions& options)
+    : instrument_{instrument}
+    , options_{options}
+    , decay_seconds_{}
+    , note_samples_{static_cast<std::size_t>(options.sample_rate * 60.0 * 4.0 /
+                                             (options.tempo_bpm * options.note_value))} {
+    // Thicker (lower) strings ring longer
+    for (int s = 0; s < instrument_.num_strings; ++s) {
+        const double open = midiToFrequency(instrument_.getPitch(s, MIN_FRET));
+        decay_seconds_[s] = static_cast<float>(std::clamp(
+            REFERENCE_DECAY_SECONDS * std::sqrt(REFERENCE_FREQUENCY / open), MIN_DECAY_SECONDS, MAX_DECAY_SECONDS));
+    }
+}
+
+std::size_t StringSynth::getExerciseLength(std::size_t num_notes) const noexcept {
+    return num_notes * note_samples_ + static_cast<std::size_t>(SYNTH_TAIL_SECONDS * options_.sample_rate);
+}
+
+void StringSynth::render(const std::vector<Note>& notes, std::uint32_t exercise, std::vector<float>& out) const {
+    const std::size_t length = getExerciseLength(notes.size());
+    out.assign(length, 0.0f);
+
+    std::array<Voice, MAX_STRINGS> voices;
+    std::size_t next_note = 0;
+    std::size_t pos = 0;
+
+    while (pos < length) {
+        // Blocks end at note onsets so every pluck lands on its exact sample
+        while (next_note < notes.size() && next_note * note_samples_ == pos) {
+            const Note& note = notes[next_note];
+            const int string_idx = note.string_idx.value;
+            const double open = midiToFrequency(instrument_.getPitch(string_idx, MIN_FRET));
+            const double frequency = midiToFrequency(note.getMidiPitch(instrument_));
+            // Fretted notes (shorter vibrating length) die away sooner
+            const double decay = decay_seconds_[string_idx] * std::sqrt(open / frequency);
+            voices[string_idx].pluck(frequency, decay, options_.sample_rate,
+                                     noiseSeed(options_.seed, exercise, next_note));
+            ++next_note;
+        }
+
+        std::size_t end = std::min(length, pos + SYNTH_BLOCK_SIZE);
+        if (next_note < notes.size()) end = std::min(end, next_note * note_samples_);
+        const int count = static_cast<int>(end - pos);
+
+        for (int s = 0; s < instrument_.num_strings; ++s) {
+            if (voices[s].active) voices[s].process(out.data() + pos, count);
+        }
+        pos = end;
+    }
+
+    const auto fade = static_cast<std::size_t>(FADE_OUT_SECONDS * options_.sample_rate);
+    for (std::size_t i = 0; i < length; ++i) {
+        float gain = MIX_GAIN;
+        if (length - i <= fade) gain *= static_cast<float>(length - i) / static_cast<float>(fade);
+        out[i] = std::clamp(out[i] * gain, -1.0f, 1.0f);
+    }
+}
+
+void renderExercises(const StringSynth& synth, const std::vector<std::vector<Note>>& exercises,
+                     std::uint32_t first_exercise, unsigned num_threads,
+                     std::vector<std::vector<float>>& out) {
+    out.resize(exercises.size());
+
+    // Interleaved assignment keeps the threads balanced without a queue
+    auto worker = [&](unsigned first, unsigned stride) {
+        for (std::size_t i = first; i < exercises.size(); i += stride) {
+            synth.render(exercises[i], first_exercise + static_cast<std::uint32_t>(i), out[i]);
+        }
+    };
+
+    const unsigned count = resolveThreads(num_threads, exercises.size());
+    if (count <= 1) {
+        worker(0, 1);
+        return;
+    }
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < count; ++t) {
+        threads.emplace_back(worker, t, count);
+    }
+    for (auto& thread : threads) thread.join();
+}
+
+// ============================================================================
+// WAV Output
+// ============================================================================
+
+namespace {
+
+void appendLittleEndian(std::string& out, std::uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+} // namespace
+
+bool fitsWavFile(std::uint64_t total_samples, int bits) noexcept {
+    return total_samples <= MAX_WAV_DATA_BYTES / static_cast<std::uint64_t>(bits / 8);
+}
+
+void writeWavHeader(std::ostream& out, std::size_t total_samples, int sample_rate, int bits) {
+    const int bytes_per_sample = bits / 8;
+    const auto data_bytes = static_cast<std::uint32_t>(total_samples * static_cast<std::size_t>(bytes_per_sample));
+
+    std::string header = "RIFF";
+    appendLittleEndian(header, 36 + data_bytes, 4);
+    header += "WAVEfmt ";
+    appendLittleEndian(header, 16, 4);
+    appendLittleEndian(header, 1, 2);   // PCM
+    appendLittleEndian(header, 1, 2);   // Mono
+    appendLittleEndian(header, static_cast<std::uint32_t>(sample_rate), 4);
+    appendLittleEndian(header, static_cast<std::uint32_t>(sample_rate * bytes_per_sample), 4);
+    appendLittleEndian(header, static_cast<std::uint32_t>(bytes_per_sample), 2);
+    appendLittleEndian(header, static_cast<std::uint32_t>(bits), 2);
+    header += "data";
+    appendLittleEndian(header, data_bytes, 4);
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+}
+
+void writeWavSamples(std::ostream& out, const std::vector<float>& samples, int bits) {
+    const int bytes_per_sample = bits / 8;
+    const double scale = bits == 24 ? 8388607.0 : 32767.0;
+
+    std::string buffer;
+    buffer.reserve(samples.size() * static_cast<std::size_t>(bytes_per_sample));
+    for (float sample : samples) {
+        const auto value = static_cast<std::int32_t>(std::lround(sample * scale));
+        appendLittleEndian(buffer, static_cast<std::uint32_t>(value), bytes_per_sample);
+    }
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+} // namespace Guitar
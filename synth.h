@@ -0,0 +1,83 @@
+#ifndef SYNTH_H
+#define SYNTH_H
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "fretboard.h"
+
+namespace Guitar {
+
+// ============================================================================
+// Constants - Audio Rendering
+// ============================================================================
+
+constexpr int DEFAULT_SAMPLE_RATE = 44100;
+constexpr int MIN_SAMPLE_RATE = 8000;
+constexpr int MAX_SAMPLE_RATE = 96000;
+constexpr int SYNTH_BLOCK_SIZE = 256;        // Samples per voice pass
+constexpr double SYNTH_TAIL_SECONDS = 1.0;   // Ring-out after the last note
+
+struct RenderOptions {
+    int sample_rate = DEFAULT_SAMPLE_RATE;
+    int bits = 16;                 // 16 or 24 bit PCM
+    int tempo_bpm = 100;
+    int note_value = 16;           // 4 = quarters, 8 = eighths, 16 = sixteenths
+    std::uint32_t seed = 1;        // Pluck noise: same seed, same samples
+};
+
+// Rate within MIN/MAX_SAMPLE_RATE, 16/24 bits, tempo 20-400, value 4/8/16
+[[nodiscard]] bool isValidRenderOptions(const RenderOptions& options) noexcept;
+
+// ============================================================================
+// String Synth - Karplus-Strong plucked strings, one voice per string
+// ============================================================================
+
+// Each string is a delay line closed by a 3-tap loop filter (two-point
+// average plus linear fractional delay, so it stays in tune). The filter
+// only reads samples a full period back, so a voice computes up to one
+// period per pass with no loop-carried dependency and the inner loop
+// vectorizes. A new note on a string re-plucks its voice, as on the real
+// instrument. Decay times come from the open pitch of each string.
+class StringSynth {
+public:
+    StringSynth(const InstrumentConfig& instrument, const RenderOptions& options);
+
+    // Samples of one exercise, tail included
+    [[nodiscard]] std::size_t getExerciseLength(std::size_t num_notes) const noexcept;
+
+    // Mono samples in [-1, 1]; `exercise` selects the pluck-noise stream
+    void render(const std::vector<Note>& notes, std::uint32_t exercise, std::vector<float>& out) const;
+
+    [[nodiscard]] const RenderOptions& getOptions() const noexcept { return options_; }
+
+private:
+    InstrumentConfig instrument_;
+    RenderOptions options_;
+    std::array<float, MAX_STRINGS> decay_seconds_;  // T60 of each open string
+    std::size_t note_samples_;
+};
+
+// Renders exercises in order on `num_threads` threads (0 = all);
+// exercise i uses noise stream first_exercise + i
+void renderExercises(const StringSynth& synth, const std::vector<std::vector<Note>>& exercises,
+                     std::uint32_t first_exercise, unsigned num_threads,
+                     std::vector<std::vector<float>>& out);
+
+// ============================================================================
+// WAV Output - mono PCM
+// ============================================================================
+
+constexpr std::uint64_t MAX_WAV_DATA_BYTES = 0xFFFFFFFFull - 36;  // RIFF sizes are 32-bit
+
+// A single WAV file can hold `total_samples` samples of `bits` bits
+[[nodiscard]] bool fitsWavFile(std::uint64_t total_samples, int bits) noexcept;
+
+// Header for `total_samples` samples (see fitsWavFile); write them with writeWavSamples
+void writeWavHeader(std::ostream& out, std::size_t total_samples, int sample_rate, int bits);
+void writeWavSamples(std::ostream& out, const std::vector<float>& samples, int bits);
+
+} // namespace Guitar
+
+#endif // SYNTH_H
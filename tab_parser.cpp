@@ -0,0 +1,671 @@
+#include "tab_parser.h"
+#include "formatter.h"
+#include "mapped_file.h"
+#include "thread_count.h"
+#include "verifier.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <thread>
+
+// The AVX2 classifier uses a per-function target attribute, so it builds
+// without -mavx2 and is picked at runtime from the CPU features
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CRAZYFINGERS_TAB_SIMD 1
+#include <immintrin.h>
+#else
+#define CRAZYFINGERS_TAB_SIMD 0
+#endif
+
+namespace Guitar {
+
+namespace {
+
+// ============================================================================
+// Constants - Detection
+// ============================================================================
+
+// Detection order: the first preset of a string count is its default
+constexpr std::array<const char*, 10> TAB_PRESETS = {
+    "guitar", "drop-d", "open-g", "open-d", "dadgad", "guitar7", "guitar8", "bass", "bass5", "bass6",
+};
+
+constexpr int MIN_TAB_STRINGS = 3;   // Fewer consecutive tab lines are not a tab
+constexpr int MIN_TAB_BODY = 3;      // Shorter bodies ("|-|") are not tab lines
+constexpr int MIN_DASH_SHARE = 3;    // A tab body is at least 1/3 '-'
+constexpr std::size_t BYTES_PER_NOTE = 16;   // Dense tab; the note arrays are reserved from it
+
+// ============================================================================
+// Block Classification - 64 bytes to four bit masks
+// ============================================================================
+
+struct BlockMasks {
+    std::uint64_t newline;
+    std::uint64_t bar;
+    std::uint64_t digit;
+    std::uint64_t dash;
+};
+
+BlockMasks classifyScalar(const char* data, std::size_t size) noexcept {
+    BlockMasks masks{};
+    for (std::size_t i = 0; i < size; ++i) {
+        const char c = data[i];
+        const std::uint64_t bit = 1ULL << i;
+        if (c == '\n') masks.newline |= bit;
+        if (c == '|') masks.bar |= bit;
+        if (c >= '0' && c <= '9') masks.digit |= bit;
+        if (c == '-') masks.dash |= bit;
+    }
+    return masks;
+}
+
+#if CRAZYFINGERS_TAB_SIMD
+
+[[gnu::target("avx2")]]
+BlockMasks classifyAvx2(const char* data) noexcept {
+    const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32));
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i bar = _mm256_set1_epi8('|');
+    const __m256i dash = _mm256_set1_epi8('-');
+    // Signed compares: bytes >= 0x80 are negative, so never digits
+    const __m256i below_zero = _mm256_set1_epi8('0' - 1);
+    const __m256i above_nine = _mm256_set1_epi8('9' + 1);
+
+    const auto join = [](int low, int high) noexcept {
+        return static_cast<std::uint64_t>(static_cast<std::uint32_t>(low)) |
+               (static_cast<std::uint64_t>(static_cast<std::uint32_t>(high)) << 32);
+    };
+    BlockMasks masks;
+    masks.newline = join(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, newline)),
+                         _mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, newline)));
+    masks.bar = join(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, bar)),
+                     _mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, bar)));
+    masks.dash = join(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, dash)),
+                      _mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, dash)));
+    masks.digit = join(
+        _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpgt_epi8(lo, below_zero), _mm256_cmpgt_epi8(above_nine, lo))),
+        _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpgt_epi8(hi, below_zero), _mm256_cmpgt_epi8(above_nine, hi))));
+    return masks;
+}
+
+#endif
+
+bool hasAvx2() noexcept {
+#if CRAZYFINGERS_TAB_SIMD
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+// Bits lo..hi-1 (either end may be 64)
+std::uint64_t bitRange(unsigned lo, unsigned hi) noexcept {
+    const std::uint64_t below_hi = hi >= 64 ? ~0ULL : (1ULL << hi) - 1;
+    const std::uint64_t from_lo = lo >= 64 ? 0ULL : ~0ULL << lo;
+    return below_hi & from_lo;
+}
+
+bool isDigit(char c) noexcept {
+    return c >= '0' && c <= '9';
+}
+
+bool isBlank(char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+std::string_view trimView(std::string_view text) noexcept {
+    std::size_t first = 0;
+    std::size_t last = text.size();
+    while (first < last && isBlank(text[first])) ++first;
+    while (last > first && isBlank(text[last - 1])) --last;
+    return text.substr(first, last - first);
+}
+
+// ASCII only (labels are note names): no locale lookups in the hot path
+char foldCase(char c) noexcept {
+    return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+// "", "e", "C#", "Bb"
+bool isTabLabel(std::string_view label) noexcept {
+    if (label.empty()) return true;
+    const char note = foldCase(label[0]);
+    if (note < 'A' || note > 'G') return false;
+    return label.size() == 1 || (label.size() == 2 && (label[1] == '#' || label[1] == 'b'));
+}
+
+bool sameLabel(std::string_view a, const std::string& b) noexcept {
+    if (a.size() != b.size()) return false;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (foldCase(a[i]) != foldCase(b[i])) return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// TabScanner - one pass over a buffer
+// ============================================================================
+
+struct TabLine {
+    int line;
+    std::size_t start;            // Offset of the line in the text
+    int bar;                      // First '|' (from the start of the line)
+    int body_end;                 // Closing '|' or end of line
+    std::string_view label;
+    std::uint32_t mask_begin;     // Words in masks_: bit c = a digit run starts c columns after the bar
+    std::uint32_t mask_words;
+};
+
+// The string of a note is read from bit planes: plane k holds the columns
+// of the strings whose index has bit k set
+constexpr int NUM_STRING_PLANES = std::bit_width(static_cast<unsigned>(MAX_STRINGS - 1));
+
+// Columns 64 * word .. 64 * word + 63 of a tab, every string merged
+struct MergedWord {
+    std::uint64_t notes;
+    std::array<std::uint64_t, NUM_STRING_PLANES> planes;
+
+    // One bit from each plane (written out: the loop is not unrolled)
+    [[nodiscard]] std::size_t stringAt(unsigned bit) const noexcept {
+        static_assert(NUM_STRING_PLANES == 4, "stringAt reads four planes");
+        return ((planes[0] >> bit) & 1) | (((planes[1] >> bit) & 1) << 1) | (((planes[2] >> bit) & 1) << 2) |
+               (((planes[3] >> bit) & 1) << 3);
+    }
+};
+
+class TabScanner {
+public:
+    TabScanner(std::string_view text, TabFileResult& out)
+        : text_{text}
+        , out_{out}
+        , instruments_{getTabInstruments()} {}
+
+    void run() {
+        // Reserved once: growing by doubling would copy (and fault in) the
+        // arrays over and over; the unused tail of a sparse file is never touched
+        out_.notes.reserve(out_.notes.size() + text_.size() / BYTES_PER_NOTE);
+        out_.note_columns.reserve(out_.note_columns.size() + text_.size() / BYTES_PER_NOTE);
+#if CRAZYFINGERS_TAB_SIMD
+        if (hasAvx2()) scanAvx2();
+        else scanScalar();
+#else
+        scanScalar();
+#endif
+        if (line_start_ < text_.size()) finishLine(text_.size());
+        flushTab();
+    }
+
+private:
+#if CRAZYFINGERS_TAB_SIMD
+    // The whole loop under the target, so the classifier and scanBlock
+    // inline and popcount / tzcnt are single instructions
+    [[gnu::target("avx2,popcnt,bmi")]]
+    void scanAvx2() {
+        const std::size_t full = text_.size() / 64 * 64;
+        for (std::size_t base = 0; base < full; base += 64) {
+            scanBlock(classifyAvx2(text_.data() + base), base);
+        }
+        if (full < text_.size()) scanBlock(classifyScalar(text_.data() + full, text_.size() - full), full);
+    }
+#endif
+
+    void scanScalar() {
+        for (std::size_t base = 0; base < text_.size(); base += 64) {
+            scanBlock(classifyScalar(text_.data() + base, std::min<std::size_t>(64, text_.size() - base)), base);
+        }
+    }
+
+    [[gnu::always_inline]] inline void scanBlock(const BlockMasks& masks, std::size_t base) {
+        const std::uint64_t starts = masks.digit & ~((masks.digit << 1) | digit_carry_);
+        digit_carry_ = masks.digit >> 63;
+
+        // Segments between newlines; only bars and run starts are visited
+        std::uint64_t newlines = masks.newline;
+        unsigned lo = 0;
+        while (true) {
+            const unsigned hi = newlines ? static_cast<unsigned>(std::countr_zero(newlines)) : 64;
+            const std::uint64_t segment = bitRange(lo, hi);
+            dashes_ += std::popcount(masks.dash & segment);
+            if (const std::uint64_t bars = masks.bar & segment) {
+                if (first_bar_ < 0) first_bar_ = static_cast<int>(base + std::countr_zero(bars) - line_start_);
+                last_bar_ = static_cast<int>(base + 63 - std::countl_zero(bars) - line_start_);
+            }
+            // No '|' yet: not a tab line (its label cannot hold digits)
+            if (first_bar_ >= 0) {
+                if (const std::uint64_t digits = starts & segment) addRuns(digits, base);
+            }
+            if (newlines == 0) break;
+
+            finishLine(base + hi);
+            newlines &= newlines - 1;
+            lo = hi + 1;
+        }
+    }
+
+    // Run starts of a block into the line's mask, shifted so that bit 0 is
+    // the first bar; starts before the bar fall off
+    void addRuns(std::uint64_t digits, std::size_t base) {
+        auto offset = static_cast<std::ptrdiff_t>(base - line_start_) - first_bar_;
+        if (offset < 0) {
+            digits >>= -offset;   // The bar is in this block: at most 63 bits
+            offset = 0;
+        }
+        const auto word = line_masks_ + static_cast<std::size_t>(offset) / 64;
+        const auto shift = static_cast<unsigned>(offset % 64);
+        if (num_masks_ < word + 2) {
+            if (masks_.size() < word + 2) masks_.resize(2 * (word + 2));
+            std::fill(masks_.begin() + num_masks_, masks_.begin() + static_cast<std::ptrdiff_t>(word) + 2, 0);
+            num_masks_ = word + 2;
+        }
+        masks_[word] |= digits << shift;
+        if (shift != 0) masks_[word + 1] |= digits >> (64 - shift);
+    }
+
+    int countDigits(std::size_t pos) const noexcept {
+        int digits = 0;
+        while (pos < text_.size() && isDigit(text_[pos])) {
+            ++pos;
+            ++digits;
+        }
+        return digits;
+    }
+
+    void diagnose(int line, int column, TabSeverity severity, std::string message) {
+        out_.diagnostics.push_back({line, column, severity, std::move(message)});
+    }
+
+    void finishLine(std::size_t end) {
+        std::size_t line_end = end;
+        if (line_end > line_start_ && text_[line_end - 1] == '\r') --line_end;
+        const int length = static_cast<int>(line_end - line_start_);
+
+        bool is_tab = first_bar_ >= 0 && first_bar_ <= MAX_TAB_LABEL_WIDTH;
+        std::string_view label;
+        int body_end = length;
+        if (is_tab) {
+            label = trimView(text_.substr(line_start_, static_cast<std::size_t>(first_bar_)));
+            if (last_bar_ > first_bar_) body_end = last_bar_;
+            const int body = body_end - first_bar_ - 1;
+            is_tab = isTabLabel(label) && body >= MIN_TAB_BODY && dashes_ * MIN_DASH_SHARE >= body;
+        }
+
+        if (is_tab) {
+            // Runs past the closing bar ("x2") are not notes
+            const auto columns = static_cast<std::size_t>(body_end - first_bar_);
+            const std::size_t words = std::min((columns + 63) / 64, num_masks_ - line_masks_);
+            if (words * 64 >= columns) masks_[line_masks_ + words - 1] &= bitRange(0, static_cast<unsigned>((columns - 1) % 64 + 1));
+            lines_.push_back({line_number_, line_start_, first_bar_, body_end, label,
+                              static_cast<std::uint32_t>(line_masks_), static_cast<std::uint32_t>(words)});
+            line_masks_ += words;
+        } else {
+            flushTab();
+        }
+        num_masks_ = line_masks_;
+
+        ++line_number_;
+        line_start_ = end + 1;
+        first_bar_ = -1;
+        last_bar_ = -1;
+        dashes_ = 0;
+    }
+
+    // Instrument for the tab's lines: labels first (top to bottom, or
+    // bottom to top when the lowest string was written on top), string
+    // count second
+    int detectInstrument(int first_line, bool& matched, bool& reversed) {
+        const int num_strings = static_cast<int>(lines_.size());
+        int fallback = -1;
+        bool labeled = true;
+        for (const auto& line : lines_) labeled = labeled && !line.label.empty();
+
+        matched = false;
+        reversed = false;
+        for (std::size_t i = 0; i < instruments_.size(); ++i) {
+            const InstrumentConfig& instrument = instruments_[i];
+            if (instrument.num_strings != num_strings) continue;
+            if (fallback < 0) fallback = static_cast<int>(i);
+            if (!labeled) continue;
+            for (const bool flip : {false, true}) {
+                bool same = true;
+                for (int s = 0; s < num_strings && same; ++s) {
+                    const int string_idx = flip ? num_strings - 1 - s : s;
+                    same = sameLabel(lines_[static_cast<std::size_t>(s)].label,
+                                     instrument.labels[static_cast<std::size_t>(string_idx)]);
+                }
+                if (!same) continue;
+                matched = true;
+                reversed = flip;
+                if (flip) {
+                    diagnose(first_line, 0, TabSeverity::Warning,
+                             "la cuerda mas grave esta arriba: se lee invertida (la primera linea es la mas aguda)");
+                }
+                return static_cast<int>(i);
+            }
+        }
+
+        if (fallback < 0) {
+            diagnose(first_line, 0, TabSeverity::Error,
+                     "tablatura de " + std::to_string(num_strings) + " cuerdas sin instrumento conocido");
+        } else if (labeled) {
+            std::string labels;
+            for (const auto& line : lines_) labels += (labels.empty() ? "" : " ") + std::string(line.label);
+            const InstrumentConfig& instrument = instruments_[static_cast<std::size_t>(fallback)];
+            diagnose(first_line, 0, TabSeverity::Warning,
+                     "afinacion desconocida (" + labels + "), se usa " + instrument.name + " " +
+                     instrument.tuning_name + " (" + describeTuning(instrument) + ")");
+        }
+        return fallback;
+    }
+
+    void flushTab() {
+        if (lines_.empty()) return;
+        const int num_strings = static_cast<int>(lines_.size());
+        const int first_line = lines_.front().line;
+
+        // One or two lines: a table border ("|----|----|") unless they hold frets
+        if (num_strings < MIN_TAB_STRINGS) {
+            if (std::any_of(masks_.begin(), masks_.begin() + static_cast<std::ptrdiff_t>(line_masks_),
+                            [](std::uint64_t mask) { return mask != 0; })) {
+                diagnose(first_line, 0, TabSeverity::Warning,
+                         std::to_string(num_strings) + " linea(s) con forma de tab ignorada(s): una tab tiene al "
+                         "menos " + std::to_string(MIN_TAB_STRINGS) + " cuerdas");
+            }
+            lines_.clear();
+            line_masks_ = 0;
+            return;
+        }
+
+        TabInfo info{first_line, num_strings, -1, false, false, static_cast<std::uint32_t>(out_.notes.size()), 0};
+        if (num_strings <= MAX_STRINGS) {
+            info.instrument = detectInstrument(first_line, info.labels_matched, info.reversed);
+        } else {
+            diagnose(first_line, 0, TabSeverity::Error,
+                     "tablatura de " + std::to_string(num_strings) + " cuerdas (maximo " +
+                     std::to_string(MAX_STRINGS) + ")");
+        }
+
+        if (info.instrument >= 0) {
+            const InstrumentConfig& instrument = instruments_[static_cast<std::size_t>(info.instrument)];
+            const int body = lines_.front().body_end - lines_.front().bar;
+            for (const auto& line : lines_) {
+                if (line.body_end - line.bar == body) continue;
+                diagnose(line.line, line.body_end + 1, TabSeverity::Warning,
+                         "cuerda de " + std::to_string(line.body_end - line.bar - 1) + " columnas, la primera tiene " +
+                         std::to_string(body - 1) + ": las notas pueden quedar desalineadas");
+                break;
+            }
+            collectNotes(instrument, info);
+        }
+
+        out_.tabs.push_back(info);
+        lines_.clear();
+        line_masks_ = 0;
+    }
+
+    // Notes in column order (after the bar), top string first within a
+    // column. The strings' masks are merged a word at a time and the notes
+    // read back in order with ctz, each one's string from the bit planes.
+    // Only a tab with chords sorts its notes by (column, string).
+    void collectNotes(const InstrumentConfig& instrument, TabInfo& info) {
+        std::size_t words = 0;
+        for (const auto& line : lines_) words = std::max<std::size_t>(words, line.mask_words);
+        if (merged_.size() < words) merged_.resize(words);
+
+        std::uint64_t chords = 0;
+        for (std::size_t w = 0; w < words; ++w) {
+            MergedWord merged{};
+            for (std::size_t s = 0; s < lines_.size(); ++s) {
+                const TabLine& line = lines_[s];
+                const std::uint64_t mask = w < line.mask_words ? masks_[line.mask_begin + w] : 0;
+                chords |= merged.notes & mask;
+                merged.notes |= mask;
+                for (std::size_t k = 0; k < merged.planes.size(); ++k) {
+                    merged.planes[k] |= mask & (0 - ((s >> k) & 1));
+                }
+            }
+            merged_[w] = merged;
+        }
+
+        // Written in place, sized by the runs (a bad fret leaves one less)
+        std::size_t most = 0;
+        if (chords == 0) {
+            for (std::size_t w = 0; w < words; ++w) most += static_cast<std::size_t>(std::popcount(merged_[w].notes));
+        } else {
+            for (std::size_t i = 0; i < line_masks_; ++i) most += static_cast<std::size_t>(std::popcount(masks_[i]));
+        }
+        const std::size_t first = out_.notes.size();
+        out_.notes.resize(first + most);
+        out_.note_columns.resize(first + most);
+        Note* notes = out_.notes.data() + first;
+        std::uint32_t* note_columns = out_.note_columns.data() + first;
+        const int max_fret = instrument.getMaxFret();
+        std::size_t count = 0;
+
+        // Per string: the text at its bar, the body after it, its index
+        std::array<const char*, MAX_STRINGS> bars{};
+        std::array<std::size_t, MAX_STRINGS> bodies{};
+        std::array<int, MAX_STRINGS> strings{};
+        for (std::size_t s = 0; s < lines_.size(); ++s) {
+            bars[s] = text_.data() + lines_[s].start + lines_[s].bar;
+            bodies[s] = static_cast<std::size_t>(lines_[s].body_end - lines_[s].bar);
+            strings[s] = info.reversed ? instrument.num_strings - 1 - static_cast<int>(s) : static_cast<int>(s);
+        }
+
+        // `column` counts from the bar; the fret is read back from the text
+        // with arithmetic, not branches (one or two digits is a coin toss).
+        // A run never crosses the closing bar: bytes past it are not read,
+        // the first digit is read again instead and masked out.
+        auto emit = [&](std::size_t string_pos, std::size_t column) {
+            const char* fret = bars[string_pos] + column;
+            const std::size_t room = bodies[string_pos] - column;
+            const int first_digit = fret[0] - '0';
+            const std::size_t next = room > 1 ? 1 : 0;
+            const auto second_digit = static_cast<unsigned>(fret[next] - '0');
+            const auto two = next & static_cast<std::size_t>(second_digit < 10);
+            const int value = first_digit + static_cast<int>(two) * (first_digit * 9 + static_cast<int>(second_digit));
+            const std::size_t third = 2 * (two & static_cast<std::size_t>(room > 2));
+            if ((third != 0 && isDigit(fret[third])) || value > max_fret) {
+                badFret(lines_[string_pos], static_cast<std::size_t>(lines_[string_pos].bar) + column, max_fret);
+                return;
+            }
+            notes[count] = Note{{strings[string_pos], instrument.num_strings}, {value}};
+            note_columns[count] = static_cast<std::uint32_t>(static_cast<std::size_t>(lines_[string_pos].bar) + column + 1);
+            ++count;
+        };
+
+        if (chords == 0) {
+            for (std::size_t w = 0; w < words; ++w) {
+                const MergedWord& merged = merged_[w];
+                for (std::uint64_t bits = merged.notes; bits != 0; bits &= bits - 1) {
+                    const auto bit = static_cast<unsigned>(std::countr_zero(bits));
+                    emit(merged.stringAt(bit), w * 64 + bit);
+                }
+            }
+        } else {
+            chordNotes(emit);
+        }
+
+        out_.notes.resize(first + count);
+        out_.note_columns.resize(first + count);
+        info.num_notes = static_cast<std::uint32_t>(count);
+        if (info.num_notes == 0) {
+            diagnose(info.first_line, 0, TabSeverity::Warning, "tablatura sin notas");
+        }
+    }
+
+    // A run that is no fret of the instrument (off the hot path)
+    [[gnu::noinline]] void badFret(const TabLine& line, std::size_t offset, int max_fret) {
+        const int digits = countDigits(line.start + offset);
+        const char* fret = text_.data() + line.start + offset;
+        const int value = digits > 1 ? (fret[0] - '0') * 10 + (fret[1] - '0') : fret[0] - '0';
+        diagnose(line.line, static_cast<int>(offset) + 1, TabSeverity::Error,
+                 "traste " +
+                 (digits > MAX_TAB_FRET_DIGITS ? "de " + std::to_string(digits) + " cifras" : std::to_string(value)) +
+                 " fuera del mastil (" + std::to_string(max_fret) + " trastes)");
+    }
+
+    template <typename Emit>
+    void chordNotes(Emit& emit) {
+        order_.clear();
+        for (std::size_t s = 0; s < lines_.size(); ++s) {
+            const std::uint64_t* mask = masks_.data() + lines_[s].mask_begin;
+            for (std::size_t w = 0; w < lines_[s].mask_words; ++w) {
+                for (std::uint64_t bits = mask[w]; bits != 0; bits &= bits - 1) {
+                    const std::uint64_t column = w * 64 + static_cast<std::uint64_t>(std::countr_zero(bits));
+                    order_.push_back((column << 32) | s);
+                }
+            }
+        }
+        std::sort(order_.begin(), order_.end());
+
+        int chords = 0;
+        std::uint64_t previous_column = ~0ULL;
+        std::uint64_t first_chord = 0;
+        for (const std::uint64_t key : order_) {
+            if ((key >> 32) == previous_column && ++chords == 1) first_chord = key;
+            previous_column = key >> 32;
+            emit(static_cast<std::size_t>(key & 0xFFFFFFFF), static_cast<std::size_t>(key >> 32));
+        }
+
+        const TabLine& line = lines_[static_cast<std::size_t>(first_chord & 0xFFFFFFFF)];
+        diagnose(line.line, line.bar + static_cast<int>(first_chord >> 32) + 1, TabSeverity::Warning,
+                 std::to_string(chords) + " nota(s) en la misma columna que otra: el generador escribe una nota "
+                 "por columna, se leen de arriba hacia abajo");
+    }
+
+    std::string_view text_;
+    TabFileResult& out_;
+    const std::vector<InstrumentConfig>& instruments_;
+    std::uint64_t digit_carry_ = 0;   // Last byte of the previous block was a digit
+
+    // Current line
+    std::size_t line_start_ = 0;
+    int line_number_ = 1;
+    int first_bar_ = -1;
+    int last_bar_ = -1;
+    int dashes_ = 0;
+    std::size_t line_masks_ = 0;   // First mask word of the current line
+
+    // Current tab
+    std::vector<TabLine> lines_;
+    std::vector<std::uint64_t> masks_;   // Buffer: the first num_masks_ words are in use
+    std::size_t num_masks_ = 0;
+    std::vector<MergedWord> merged_;     // collectNotes: the tab's columns, every string
+    std::vector<std::uint64_t> order_;   // chordNotes: column << 32 | string
+};
+
+// ============================================================================
+// Rule Messages
+// ============================================================================
+
+std::string describeViolation(Invariant invariant, const GeneratorProfile& profile) {
+    switch (invariant) {
+        case Invariant::InScale:
+            return "nota fuera de la escala";
+        case Invariant::PositionBox:
+            return "fuera del cajon de posicion (+-" + std::to_string(profile.position_box_radius) +
+                   " trastes de la primera nota)";
+        case Invariant::LocalRange:
+            return "la ventana de " + std::to_string(profile.local_window_size + 1) + " notas supera " +
+                   std::to_string(profile.max_local_range) + " semitonos";
+        case Invariant::GlobalRange:
+            return "el ejercicio supera " + std::to_string(profile.max_global_range) + " semitonos";
+        case Invariant::SameStringRun:
+            return "mas de " + std::to_string(profile.max_consecutive_same_string) +
+                   " movimientos seguidos en la misma cuerda";
+        case Invariant::RepeatedNote:
+            return "la misma nota dos veces seguidas";
+    }
+    return "";
+}
+
+} // namespace
+
+// ============================================================================
+// Instruments
+// ============================================================================
+
+const std::vector<InstrumentConfig>& getTabInstruments() {
+    static const std::vector<InstrumentConfig> instruments = [] {
+        std::vector<InstrumentConfig> presets;
+        for (const char* name : TAB_PRESETS) presets.push_back(*findInstrumentPreset(name));
+        return presets;
+    }();
+    return instruments;
+}
+
+// ============================================================================
+// Parsing and Linting
+// ============================================================================
+
+void parseTabText(std::string_view text, TabFileResult& out) {
+    out.bytes += text.size();
+    TabScanner(text, out).run();
+}
+
+void lintTabs(TabFileResult& result, const TabLintOptions& options) {
+    const auto& instruments = getTabInstruments();
+    std::vector<std::unique_ptr<InvariantChecker>> checkers(instruments.size());
+    std::array<int, NUM_INVARIANTS> first_note{};
+
+    for (const auto& tab : result.tabs) {
+        if (tab.instrument < 0 || tab.num_notes == 0) continue;
+        auto& checker = checkers[static_cast<std::size_t>(tab.instrument)];
+        if (!checker) {
+            checker = std::make_unique<InvariantChecker>(instruments[static_cast<std::size_t>(tab.instrument)],
+                                                         options.profile);
+        }
+
+        const std::span<const Note> notes(result.notes.data() + tab.first_note, tab.num_notes);
+        const std::uint32_t violated = checker->check(notes, options.scale_mask, first_note);
+        for (int v = 0; v < NUM_INVARIANTS; ++v) {
+            if ((violated & (1u << v)) == 0) continue;
+            const std::size_t index = tab.first_note + static_cast<std::size_t>(first_note[static_cast<std::size_t>(v)]);
+            const auto invariant = static_cast<Invariant>(v);
+            const int row = tab.reversed ? tab.num_strings - 1 - result.notes[index].string_idx.value
+                                         : result.notes[index].string_idx.value;
+            result.diagnostics.push_back({tab.first_line + row,
+                                          static_cast<int>(result.note_columns[index]), TabSeverity::Rule,
+                                          std::string(getInvariantName(invariant)) + ": nota " +
+                                              std::to_string(first_note[static_cast<std::size_t>(v)] + 1) + " (" +
+                                              Formatter::formatCompact({result.notes[index]}) + "), " +
+                                              describeViolation(invariant, options.profile)});
+        }
+    }
+
+    std::stable_sort(result.diagnostics.begin(), result.diagnostics.end(),
+                     [](const TabDiagnostic& a, const TabDiagnostic& b) { return a.line < b.line; });
+}
+
+std::vector<TabFileResult> lintTabFiles(const std::vector<std::string>& paths, const TabLintOptions& options) {
+    std::vector<TabFileResult> results(paths.size());
+    const unsigned num_threads = resolveThreads(options.num_threads, paths.size());
+    std::atomic<std::size_t> next_file{0};
+
+    auto worker = [&]() {
+        for (std::size_t f = next_file.fetch_add(1, std::memory_order_relaxed); f < paths.size();
+             f = next_file.fetch_add(1, std::memory_order_relaxed)) {
+            TabFileResult& result = results[f];
+            result.path = paths[f];
+            const auto file = Music::MappedFile::open(paths[f]);
+            if (!file) {
+                result.readable = false;
+                continue;
+            }
+            parseTabText(file->view(), result);
+            lintTabs(result, options);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) thread.join();
+    return results;
+}
+
+} // namespace Guitar
@@ -0,0 +1,93 @@
+#ifndef TAB_PARSER_H
+#define TAB_PARSER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "fretboard.h"
+#include "generator.h"
+
+namespace Guitar {
+
+// ============================================================================
+// Constants - ASCII Tab Parsing
+// ============================================================================
+
+constexpr int MAX_TAB_LABEL_WIDTH = 4;     // Characters before the first '|' ("C# |")
+constexpr int MAX_TAB_FRET_DIGITS = 2;     // Longer digit runs are reported, not read
+
+// ============================================================================
+// Parsed Tabs
+// ============================================================================
+
+enum class TabSeverity : std::uint8_t {
+    Error,     // Malformed input: the tab (or note) was skipped
+    Warning,   // Parsed, but probably not what the author meant
+    Rule       // A generator rule the notes break
+};
+
+struct TabDiagnostic {
+    int line;                  // 1-based
+    int column;                // 1-based, 0 = whole line
+    TabSeverity severity;
+    std::string message;
+};
+
+// One block of consecutive tab lines (a system); notes live in the file's
+// flat arrays so a big archive costs no allocation per tab
+struct TabInfo {
+    int first_line;            // Line of the top (highest) string
+    int num_strings;
+    int instrument;            // Index into getTabInstruments(), -1 if unknown
+    bool labels_matched;       // Labels identified the tuning (not just the string count)
+    bool reversed;             // Lowest string written on top
+    std::uint32_t first_note;  // Range in TabFileResult::notes
+    std::uint32_t num_notes;
+};
+
+struct TabFileResult {
+    std::string path;
+    bool readable = true;
+    std::size_t bytes = 0;
+    std::vector<TabInfo> tabs;
+    std::vector<Note> notes;             // Column order; a chord's notes top string first
+    std::vector<std::uint32_t> note_columns;   // Line: the tab's first_line + the note's row
+    std::vector<TabDiagnostic> diagnostics;
+};
+
+// Presets a tab can be detected as (by string count, then labels)
+[[nodiscard]] const std::vector<InstrumentConfig>& getTabInstruments();
+
+// ============================================================================
+// Parsing and Linting
+// ============================================================================
+
+// A tab line is an optional note-name label, a '|' and a body of mostly
+// '-' with fret numbers (measure bars and technique marks are skipped);
+// consecutive tab lines form one tab, top line = highest string. Every
+// 64-byte block is classified at once (AVX2 when the CPU has it) into
+// newline / '|' / digit / '-' bit masks, so only line ends, bars and
+// digit-run starts are visited one by one. Notes are matched across
+// strings by their column after the bar; the instrument comes from the
+// string count and, when they match a preset, the labels.
+void parseTabText(std::string_view text, TabFileResult& out);
+
+struct TabLintOptions {
+    GeneratorProfile profile = STANDARD_PROFILE;
+    std::uint16_t scale_mask = 0x0FFF;   // Pitch classes allowed (default: no scale check)
+    unsigned num_threads = 0;            // 0 = every core
+};
+
+// Rules of the generator (see InvariantChecker) on every parsed tab, as
+// TabSeverity::Rule diagnostics at the offending note
+void lintTabs(TabFileResult& result, const TabLintOptions& options);
+
+// Maps, parses and lints the files in parallel (workers take the next file
+// from an atomic counter); results in the order of `paths`
+[[nodiscard]] std::vector<TabFileResult> lintTabFiles(const std::vector<std::string>& paths,
+                                                      const TabLintOptions& options);
+
+} // namespace Guitar
+
+#endif // TAB_PARSER_H
@@ -0,0 +1,110 @@
+#!/bin/sh
+# Golden-file tests: every case writes a file from fixed options and a fixed
+# seed, and the result must match tests/golden/<file> byte for byte.
+#
+#   tests/golden.sh [binary]            compare (default binary: ./crazyfingers)
+#   tests/golden.sh --update [binary]   rewrite the golden files
+#
+# Local crazyfingers.weights/.model/.rules files are ignored so the output
+# only depends on the code. Input files the cases read live in
+# tests/fixtures/ and are copied next to the output.
+
+update=0
+if [ "$1" = "--update" ]; then
+    update=1
+    shift
+fi
+bin=${1:-./crazyfingers}
+case $bin in
+    /*) ;;
+    *) bin=$(pwd)/$bin ;;
+esac
+golden=$(cd "$(dirname "$0")" && pwd)/golden
+fixtures=$(cd "$(dirname "$0")" && pwd)/fixtures
+
+if [ ! -x "$bin" ]; then
+    echo "No se encontro el ejecutable: $bin" >&2
+    exit 1
+fi
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+cd "$work" || exit 1
+
+common="--no-weights --no-model --no-rules"
+failures=0
+
+# compare <file> [file...]: each written file against tests/golden/<file>
+compare() {
+    for file in "$@"; do
+        if [ "$update" -eq 1 ]; then
+            cp "$work/$file" "$golden/$file"
+            echo "ACTUALIZADO $file"
+        elif cmp -s "$work/$file" "$golden/$file"; then
+            echo "OK     $file"
+        else
+            echo "FALLO  $file (difiere de tests/golden/$file)"
+            failures=$((failures + 1))
+        fi
+    done
+}
+
+# check "<file> [file...]" <command> [options...]
+# (a command that writes several files, such as a paged sheet, lists them all)
+check() {
+    files=$1
+    shift
+    if ! "$bin" "$@" $common > "$work/stdout.txt" 2>&1; then
+        echo "FALLO  $files (codigo de salida)"
+        cat "$work/stdout.txt"
+        failures=$((failures + 1))
+        return
+    fi
+    compare $files
+}
+
+# check_output <file> <command> [options...]: the printed output is the
+# file; stderr (summaries with timings) is left out and the exit code is
+# not checked (lint returns 2 when it finds errors)
+check_output() {
+    file=$1
+    shift
+    "$bin" "$@" $common > "$work/$file" 2> "$work/stderr.txt"
+    compare "$file"
+}
+
+# exporter.cpp: MIDI and MusicXML
+check page.mid          export page.mid --key C --scale Major --seed 7 --count 4 --tempo 90
+check page.musicxml     export page.musicxml --key C --scale Major --seed 7 --count 4 --tempo 90
+check book.mid          export book.mid --book --key A --scale "Pentatonic Minor" --seed 11 --value 16
+check bass.musicxml     export bass.musicxml --instrument bass --key E --scale Dorian --seed 3 --count 2
+
+# svg_sheet.cpp: one page, and a book split over two pages
+check sheet.svg         sheet sheet.svg --key C --scale Major --seed 7 --count 3
+check "sheet_book_00001.svg sheet_book_00002.svg" \
+                        sheet sheet_book.svg --book --key A --scale Dorian --seed 5
+
+# rule_set.cpp: --rule replaces the local rule file, so these cases drop --no-rules
+common="--no-weights --no-model"
+check_output rules_position.txt generate --key C --scale Major --seed 21 --count 2 \
+                                         --rule "only fret 5-9; forbid string 1"
+check_output rules_weight.txt   generate --key G --scale Mixolydian --seed 8 --count 2 \
+                                         --rule "prefer string 3-4 300%; avoid fret 0"
+check_output rules_root.txt     generate --key E --scale "Natural Minor" --seed 13 --count 2 \
+                                         --rule "start root; end root"
+check_output rules_metric.txt   generate --key D --scale Dorian --seed 34 --count 2 \
+                                         --rule "min string-changes 6; max range 12"
+check rules_book.mid    export rules_book.mid --book --key C --scale Major --seed 5 --rule "only fret 3-9"
+common="--no-weights --no-model --no-rules"
+
+# tab_parser.cpp: diagnostics of a hand-written tab file (reversed labels,
+# chord columns, out-of-range frets, a table border, unknown tunings)
+cp "$fixtures/tabs.txt" "$work/tabs.txt"
+check_output lint_notes.txt     lint tabs.txt --notes
+check_output lint_scale.txt     lint tabs.txt --key A --scale "Pentatonic Minor"
+
+if [ "$failures" -ne 0 ]; then
+    echo "$failures caso(s) fallaron"
+    exit 1
+fi
+echo "Todos los casos coinciden"
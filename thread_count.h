@@ -0,0 +1,26 @@
+#ifndef THREAD_COUNT_H
+#define THREAD_COUNT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <thread>
+
+namespace Guitar {
+
+// ============================================================================
+// Thread Count - workers of the parallel commands
+// ============================================================================
+
+// `requested` threads (0 = every core), no more than there are `tasks` and
+// at least one
+[[nodiscard]] inline unsigned resolveThreads(unsigned requested,
+                                             std::size_t tasks = std::numeric_limits<std::size_t>::max()) noexcept {
+    const unsigned cores = std::thread::hardware_concurrency();
+    const unsigned threads = requested > 0 ? requested : std::max(1u, cores);
+    return static_cast<unsigned>(std::clamp<std::size_t>(tasks, 1, threads));
+}
+
+} // namespace Guitar
+
+#endif // THREAD_COUNT_H
@@ -0,0 +1,136 @@
+#include "transcriber.h"
+#include "music_theory.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+
+namespace Guitar {
+
+// ============================================================================
+// Melody Parsing
+// ============================================================================
+
+std::optional<std::vector<int>> parseMelody(const std::string& text) {
+    std::string normalized = text;
+    for (char& c : normalized) {
+        if (c == ',' || c == ';') c = ' ';
+    }
+
+    std::vector<int> pitches;
+    std::istringstream iss(normalized);
+    std::string token;
+    while (iss >> token) {
+        int pitch = -1;
+        const auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), pitch);
+        if (error != std::errc{} || end != token.data() + token.size()) {
+            pitch = Music::parseMidiNoteName(token);
+        }
+        if (pitch < 0 || pitch >= NUM_MIDI_PITCHES) return std::nullopt;
+        pitches.push_back(pitch);
+    }
+
+    if (pitches.empty()) return std::nullopt;
+    return pitches;
+}
+
+// ============================================================================
+// Transcriber Implementation
+// ============================================================================
+
+Transcriber::Transcriber(const InstrumentConfig& instrument, const GeneratorProfile& profile,
+                         const TranscriptionCosts& costs)
+    : instrument_{instrument}
+    , profile_{profile}
+    , costs_{costs}
+    , index_{instrument}
+    , top_weight_{std::max(profile.weightFor(0, false), profile.weightFor(0, true))} {}
+
+bool Transcriber::canPlay(int pitch) const noexcept {
+    return pitch >= 0 && pitch < NUM_MIDI_PITCHES && !index_.getPositions(pitch).empty();
+}
+
+int Transcriber::moveCost(const FretPosition& from, int hand, const FretPosition& to) const noexcept {
+    const bool same_string = from.string_idx == to.string_idx;
+    int cost = costs_.string_change * std::abs(to.string_idx - from.string_idx) + costs_.fret_height * to.fret;
+    if (hand == MIN_FRET || to.fret == MIN_FRET) return cost;
+
+    const int distance = std::abs(to.fret - hand);
+    cost += top_weight_ - profile_.weightFor(distance, same_string);
+    if (distance > profile_.position_box_radius) {
+        cost += costs_.shift + costs_.shift_per_fret * (distance - profile_.position_box_radius);
+    }
+    return cost;
+}
+
+std::optional<Transcription> Transcriber::transcribe(std::span<const int> pitches) const {
+    for (const int pitch : pitches) {
+        if (!canPlay(pitch)) return std::nullopt;
+    }
+    Transcription result{{}, 0};
+    if (pitches.empty()) return result;
+
+    // A state is a candidate plus the fret of the last fretted note: an
+    // open string keeps the hand where it was, so an open candidate has
+    // one state per hand position reaching it (the best path for each)
+    struct PathState {
+        std::uint8_t candidate;
+        std::uint8_t hand;       // MIN_FRET until the first fretted note
+        std::uint16_t back;      // State of layer i - 1 on the best path
+        long long cost;
+    };
+    std::vector<PathState> states;
+    std::vector<std::size_t> begin(pitches.size() + 1, 0);
+
+    auto layer = index_.getPositions(pitches[0]);
+    for (std::size_t c = 0; c < layer.size(); ++c) {
+        states.push_back({static_cast<std::uint8_t>(c), static_cast<std::uint8_t>(layer[c].fret), 0,
+                          static_cast<long long>(costs_.fret_height) * layer[c].fret});
+    }
+    begin[1] = states.size();
+
+    std::array<long long, MAX_SUPPORTED_FRET + 1> best_by_hand{};
+    std::array<std::uint16_t, MAX_SUPPORTED_FRET + 1> from_by_hand{};
+    for (std::size_t i = 1; i < pitches.size(); ++i) {
+        const auto next = index_.getPositions(pitches[i]);
+        for (std::size_t c = 0; c < next.size(); ++c) {
+            const bool open = next[c].fret == MIN_FRET;
+            best_by_hand.fill(std::numeric_limits<long long>::max());
+            for (std::size_t s = begin[i - 1]; s < begin[i]; ++s) {
+                const PathState& from = states[s];
+                const long long cost = from.cost + moveCost(layer[from.candidate], from.hand, next[c]);
+                const std::size_t hand = open ? from.hand : static_cast<std::size_t>(next[c].fret);
+                if (cost < best_by_hand[hand]) {
+                    best_by_hand[hand] = cost;
+                    from_by_hand[hand] = static_cast<std::uint16_t>(s - begin[i - 1]);
+                }
+            }
+            for (std::size_t hand = 0; hand < best_by_hand.size(); ++hand) {
+                if (best_by_hand[hand] == std::numeric_limits<long long>::max()) continue;
+                states.push_back({static_cast<std::uint8_t>(c), static_cast<std::uint8_t>(hand),
+                                  from_by_hand[hand], best_by_hand[hand]});
+            }
+        }
+        begin[i + 1] = states.size();
+        layer = next;
+    }
+
+    std::size_t state = begin[pitches.size() - 1];
+    for (std::size_t s = state + 1; s < states.size(); ++s) {
+        if (states[s].cost < states[state].cost) state = s;
+    }
+    result.cost = states[state].cost;
+
+    result.notes.resize(pitches.size());
+    for (std::size_t i = pitches.size(); i-- > 0;) {
+        const FretPosition position = index_.getPositions(pitches[i])[states[state].candidate];
+        result.notes[i] = Note{{position.string_idx, instrument_.num_strings}, {position.fret}};
+        if (i > 0) state = begin[i - 1] + states[state].back;
+    }
+    return result;
+}
+
+} // namespace Guitar
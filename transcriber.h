@@ -0,0 +1,77 @@
+#ifndef TRANSCRIBER_H
+#define TRANSCRIBER_H
+
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+#include "fretboard.h"
+#include "generator.h"
+
+namespace Guitar {
+
+// ============================================================================
+// Transcription Costs
+// ============================================================================
+
+// Added on top of the profile's distance weights (see Transcriber)
+struct TranscriptionCosts {
+    int string_change = 8;       // Per string crossed between two notes
+    int shift = 40;              // Leaving the Position Box (move > box radius)...
+    int shift_per_fret = 10;     // ...plus this per fret beyond the radius
+    int fret_height = 5;         // Per fret of every note: keeps the hand from drifting up the neck
+};
+
+struct Transcription {
+    std::vector<Note> notes;     // One position per pitch
+    long long cost;              // Sum of the move costs along the path
+};
+
+// Melody as MIDI numbers or note names with octave ("64 E4 G#4 Bb3"),
+// separated by spaces, commas or newlines. std::nullopt on a bad token.
+[[nodiscard]] std::optional<std::vector<int>> parseMelody(const std::string& text);
+
+// ============================================================================
+// Transcriber - melody to tab, shortest path over a layered graph
+// ============================================================================
+
+// Layer i holds every (string, fret) that sounds pitch i (at most one per
+// string, straight from FretboardPitchIndex). A move costs what the
+// generator would not pick: the highest weightFor() minus the weight of its
+// distance class (same-string bonus included), the string change penalty,
+// a shift penalty when it jumps beyond the profile's box radius and a small
+// cost per fret of height, since step costs alone let a line creep up the
+// neck. Open strings never move the hand: the DP state is a candidate plus
+// the fret of the last fretted note (an open candidate keeps one state per
+// hand position reaching it), so time and memory stay linear in the melody
+// length.
+class Transcriber {
+public:
+    explicit Transcriber(const InstrumentConfig& instrument,
+                         const GeneratorProfile& profile = STANDARD_PROFILE,
+                         const TranscriptionCosts& costs = {});
+
+    [[nodiscard]] const InstrumentConfig& getInstrument() const noexcept { return instrument_; }
+
+    // Pitch has at least one position on the instrument
+    [[nodiscard]] bool canPlay(int pitch) const noexcept;
+
+    // Cheapest tab for `pitches`; std::nullopt if one of them cannot be played
+    [[nodiscard]] std::optional<Transcription> transcribe(std::span<const int> pitches) const;
+
+    // Cost of playing `to` right after `from` with the hand at fret `hand`
+    // (the last fretted note, MIN_FRET before the first); fret height of
+    // `to` included
+    [[nodiscard]] int moveCost(const FretPosition& from, int hand, const FretPosition& to) const noexcept;
+
+private:
+    InstrumentConfig instrument_;
+    GeneratorProfile profile_;
+    TranscriptionCosts costs_;
+    FretboardPitchIndex index_;
+    int top_weight_;             // Weight of the most preferred move
+};
+
+} // namespace Guitar
+
+#endif // TRANSCRIBER_H
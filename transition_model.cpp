@@ -0,0 +1,394 @@
+#include "transition_model.h"
+#include "mapped_file.h"
+#include "tab_parser.h"
+#include "thread_count.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+namespace Guitar {
+
+namespace {
+
+// ============================================================================
+// Key Packing - (level, context, move) in one sortable integer
+// ============================================================================
+
+constexpr char MODEL_MAGIC[8] = {'C', 'F', 'N', 'G', 'R', 'A', 'M', 'S'};
+constexpr std::uint32_t MODEL_VERSION = 1;
+
+constexpr int FRET_SPAN = 2 * MODEL_MAX_FRET_DELTA + 1;
+constexpr int PREVIOUS_FRET_SPAN = 2 * MODEL_CONTEXT_FRET_DELTA + 1;
+constexpr int FIRST_MOVE = (2 * MODEL_CONTEXT_STRING_DELTA + 1) * PREVIOUS_FRET_SPAN;  // No previous move
+constexpr int NUM_PREVIOUS = FIRST_MOVE + 1;
+constexpr std::size_t NUM_MOVES = MODEL_NUM_MOVES;   // Every moveId()
+constexpr std::size_t ROW_SIZE = NUM_MOVES + 1;      // Then an uncounted move
+
+// Each context's entries end with its number of different moves, then its total
+constexpr std::uint64_t DISTINCT_MOVE = 0xFFFE;
+constexpr std::uint64_t TOTAL_MOVE = 0xFFFF;
+
+constexpr std::uint64_t moveId(int string_delta, int fret_delta) noexcept {
+    return static_cast<std::uint64_t>((string_delta + MAX_STRINGS - 1) * FRET_SPAN + fret_delta + MODEL_MAX_FRET_DELTA);
+}
+
+constexpr std::uint64_t contextKey(std::uint64_t level, std::uint64_t context) noexcept {
+    return (level << 32) | (context << 16);
+}
+
+int previousId(int string_delta, int fret_delta) noexcept {
+    const int ds = std::clamp(string_delta, -MODEL_CONTEXT_STRING_DELTA, MODEL_CONTEXT_STRING_DELTA);
+    const int df = std::clamp(fret_delta, -MODEL_CONTEXT_FRET_DELTA, MODEL_CONTEXT_FRET_DELTA);
+    return (ds + MODEL_CONTEXT_STRING_DELTA) * PREVIOUS_FRET_SPAN + df + MODEL_CONTEXT_FRET_DELTA;
+}
+
+// Context ids of levels 1 and 2 (level 0 has only context 0)
+std::array<std::uint64_t, 3> contextIds(int string_idx, int same_string_run, int previous) noexcept {
+    const auto run_context = static_cast<std::uint64_t>(string_idx * (MODEL_MAX_RUN + 1) +
+                                                        std::min(same_string_run, MODEL_MAX_RUN));
+    return {0, run_context, run_context * NUM_PREVIOUS + static_cast<std::uint64_t>(previous)};
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+template<typename T>
+void writeValue(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool readValue(std::ifstream& in, T& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return static_cast<bool>(in);
+}
+
+template<typename T>
+void writeVector(std::ofstream& out, const std::vector<T>& values) {
+    out.write(reinterpret_cast<const char*>(values.data()),
+              static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+template<typename T>
+bool readVector(std::ifstream& in, std::vector<T>& values, std::size_t count) {
+    values.resize(count);
+    in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(count * sizeof(T)));
+    return static_cast<bool>(in);
+}
+
+// Keys a model of `num_strings` can hold: known levels, contexts and
+// moves only, each context's entries ending with its distinct/total pair
+bool validKeys(const std::vector<std::uint64_t>& keys, int num_strings) {
+    const auto num_rows = static_cast<std::uint64_t>(num_strings * (MODEL_MAX_RUN + 1));
+    const std::array<std::uint64_t, 3> num_contexts = {1, num_rows, num_rows * NUM_PREVIOUS};
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        const std::uint64_t level = keys[i] >> 32;
+        const std::uint64_t context = (keys[i] >> 16) & 0xFFFF;
+        const std::uint64_t move = keys[i] & TOTAL_MOVE;
+        if (level >= num_contexts.size() || context >= num_contexts[level]) return false;
+        if (i > 0 && keys[i] <= keys[i - 1]) return false;
+        if (move == DISTINCT_MOVE) {
+            if (i + 1 == keys.size() || keys[i + 1] != (keys[i] | TOTAL_MOVE)) return false;
+        } else if (move == TOTAL_MOVE) {
+            if (i == 0 || keys[i - 1] != ((keys[i] & ~TOTAL_MOVE) | DISTINCT_MOVE)) return false;
+        } else {
+            if (move >= NUM_MOVES) return false;
+            // Sorted: the next key of the same context must follow, up to its pair
+            if (i + 1 == keys.size() || (keys[i + 1] & ~TOTAL_MOVE) != (keys[i] & ~TOTAL_MOVE)) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// TransitionCounts Implementation
+// ============================================================================
+
+void TransitionCounts::addSequence(std::span<const Note> notes) {
+    if (notes.size() < 2) return;
+    ++sequences_;
+
+    int run = 0;  // Same-string moves ending at the previous note
+    for (std::size_t i = 1; i < notes.size(); ++i) {
+        const Note& previous = notes[i - 1];
+        const int string_delta = notes[i].string_idx.value - previous.string_idx.value;
+        const int fret_delta = notes[i].fret.value - previous.fret.value;
+
+        if (std::abs(fret_delta) <= MODEL_MAX_FRET_DELTA) {
+            const int before = i >= 2 ? previousId(previous.string_idx.value - notes[i - 2].string_idx.value,
+                                                   previous.fret.value - notes[i - 2].fret.value)
+                                      : FIRST_MOVE;
+            const auto contexts = contextIds(previous.string_idx.value, run, before);
+            const std::uint64_t move = moveId(string_delta, fret_delta);
+            for (std::uint64_t level = 0; level < contexts.size(); ++level) {
+                ++counts_[contextKey(level, contexts[level]) | move];
+            }
+            ++transitions_;
+        }
+        run = string_delta == 0 ? run + 1 : 0;
+    }
+}
+
+void TransitionCounts::merge(const TransitionCounts& other) {
+    for (const auto& [key, count] : other.counts_) counts_[key] += count;
+    sequences_ += other.sequences_;
+    transitions_ += other.transitions_;
+}
+
+// ============================================================================
+// TransitionModel Implementation
+// ============================================================================
+
+TransitionModel& TransitionModel::getInstance() {
+    static TransitionModel instance;
+    return instance;
+}
+
+TransitionModel::TransitionModel(const TransitionCounts& counts, int num_strings)
+    : num_strings_{num_strings}
+    , sequences_{counts.sequences_}
+    , transitions_{counts.transitions_} {
+    struct ContextTotals {
+        std::uint64_t total = 0;
+        std::uint32_t distinct = 0;
+    };
+    std::unordered_map<std::uint64_t, ContextTotals> contexts;
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> entries(counts.counts_.begin(), counts.counts_.end());
+    for (const auto& [key, count] : entries) {
+        ContextTotals& totals = contexts[key & ~TOTAL_MOVE];
+        totals.total += count;
+        ++totals.distinct;
+    }
+    for (const auto& [context, totals] : contexts) {
+        entries.emplace_back(context | DISTINCT_MOVE, totals.distinct);
+        entries.emplace_back(context | TOTAL_MOVE, static_cast<std::uint32_t>(std::min<std::uint64_t>(
+                                                       totals.total, std::numeric_limits<std::uint32_t>::max())));
+    }
+    std::sort(entries.begin(), entries.end());
+
+    keys_.reserve(entries.size());
+    counts_.reserve(entries.size());
+    for (const auto& [key, count] : entries) {
+        keys_.push_back(key);
+        counts_.push_back(count);
+    }
+    buildBackoff();
+}
+
+void TransitionModel::clear() noexcept {
+    keys_.clear();
+    counts_.clear();
+    backoff_.clear();
+    full_begin_.clear();
+    num_strings_ = 0;
+    sequences_ = 0;
+    transitions_ = 0;
+}
+
+TransitionModel::Range TransitionModel::findRange(std::uint64_t key) const {
+    const auto first = std::lower_bound(keys_.begin(), keys_.end(), key);
+    const auto last = std::upper_bound(first, keys_.end(), key | TOTAL_MOVE);
+    Range range;
+    range.begin = static_cast<std::uint32_t>(first - keys_.begin());
+    range.end = static_cast<std::uint32_t>(last - keys_.begin());
+    // Unseen context: empty range, so only the levels below speak
+    if (last - first >= 2) {
+        range.end -= 2;
+        range.distinct = counts_[range.end];
+        range.total = counts_[range.end + 1];
+    }
+    return range;
+}
+
+void TransitionModel::buildBackoff() {
+    const double vocabulary = static_cast<double>((2 * num_strings_ - 1) * FRET_SPAN);
+    const Range base = findRange(contextKey(0, 0));
+    const auto num_rows = static_cast<std::size_t>(num_strings_ * (MODEL_MAX_RUN + 1));
+    backoff_.assign(num_rows * ROW_SIZE, 0.0);
+
+    // Add-one counts at level 0, so no move (nor an uncounted one) is impossible
+    std::vector<double> base_row(ROW_SIZE, 1.0 / (base.total + vocabulary));
+    for (std::uint32_t i = base.begin; i < base.end; ++i) {
+        base_row[keys_[i] & TOTAL_MOVE] = (counts_[i] + 1.0) / (base.total + vocabulary);
+    }
+    // Level-2 contexts are dense ids, so a step finds its entries by index
+    full_begin_.resize(num_rows * NUM_PREVIOUS + 1);
+    for (std::size_t context = 0; context < full_begin_.size(); ++context) {
+        full_begin_[context] = static_cast<std::uint32_t>(
+            std::lower_bound(keys_.begin(), keys_.end(), contextKey(2, context)) - keys_.begin());
+    }
+
+    for (std::size_t row = 0; row < num_rows; ++row) {
+        const Range context = findRange(contextKey(1, row));
+        double* probabilities = backoff_.data() + row * ROW_SIZE;
+        const double mix = context.distinct > 0.0 ? context.distinct / (context.total + context.distinct) : 1.0;
+        for (std::size_t move = 0; move < ROW_SIZE; ++move) {
+            probabilities[move] = mix * base_row[move];
+        }
+        for (std::uint32_t i = context.begin; i < context.end; ++i) {
+            probabilities[keys_[i] & TOTAL_MOVE] += counts_[i] / (context.total + context.distinct);
+        }
+    }
+}
+
+void TransitionModel::findContext(const Note& previous, const Note* before, int same_string_run,
+                                  TransitionContext& context) const {
+    const int previous_move = before ? previousId(previous.string_idx.value - before->string_idx.value,
+                                                  previous.fret.value - before->fret.value)
+                                     : FIRST_MOVE;
+    const auto ids = contextIds(previous.string_idx.value, same_string_run, previous_move);
+
+    // Entries of the full context, then its distinct/total pair (if seen)
+    std::uint32_t first = full_begin_[ids[2]];
+    std::uint32_t last = full_begin_[ids[2] + 1];
+    double total = 0.0;
+    double distinct = 0.0;
+    if (last - first >= 2) {
+        last -= 2;
+        distinct = counts_[last];
+        total = counts_[last + 1];
+    }
+
+    // p = (count + distinct * lower) / (total + distinct), or just lower for an unseen context
+    context.lower = backoff_.data() + ids[1] * ROW_SIZE;
+    context.scale = distinct > 0.0 ? MODEL_WEIGHT_SCALE / (total + distinct) : 0.0;
+    context.mix = distinct > 0.0 ? distinct * context.scale : MODEL_WEIGHT_SCALE;
+    if (++context.step == 0) {
+        context.seen.fill(0);
+        context.step = 1;
+    }
+    for (std::uint32_t i = first; i < last; ++i) {
+        const auto move = static_cast<std::size_t>(keys_[i] & TOTAL_MOVE);
+        if (move >= NUM_MOVES) continue;   // Not a move (load rejects these)
+        context.seen[move] = context.step;
+        context.counts[move] = counts_[i];
+    }
+}
+
+int TransitionModel::weight(const TransitionContext& context, int string_delta, int fret_delta) noexcept {
+    std::size_t move = NUM_MOVES;  // Too long to be counted: the add-one share only
+    double count = 0.0;
+    if (std::abs(fret_delta) <= MODEL_MAX_FRET_DELTA && std::abs(string_delta) < MAX_STRINGS) {
+        move = static_cast<std::size_t>(moveId(string_delta, fret_delta));
+        if (context.seen[move] == context.step) count = context.counts[move];
+    }
+    const double scaled = context.mix * context.lower[move] + count * context.scale;
+    return std::max(1, static_cast<int>(scaled + 0.5));
+}
+
+bool TransitionModel::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+
+    out.write(MODEL_MAGIC, sizeof(MODEL_MAGIC));
+    writeValue(out, MODEL_VERSION);
+    writeValue(out, static_cast<std::uint32_t>(num_strings_));
+    writeValue(out, static_cast<std::uint64_t>(sequences_));
+    writeValue(out, static_cast<std::uint64_t>(transitions_));
+    writeValue(out, static_cast<std::uint32_t>(keys_.size()));
+    writeVector(out, keys_);
+    writeVector(out, counts_);
+    return static_cast<bool>(out);
+}
+
+bool TransitionModel::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    char magic[sizeof(MODEL_MAGIC)];
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, MODEL_MAGIC, sizeof(MODEL_MAGIC)) != 0) return false;
+
+    std::uint32_t version = 0, num_strings = 0, count = 0;
+    std::uint64_t sequences = 0, transitions = 0;
+    if (!readValue(in, version) || version != MODEL_VERSION) return false;
+    if (!readValue(in, num_strings) || !readValue(in, sequences) || !readValue(in, transitions) ||
+        !readValue(in, count)) return false;
+    if (num_strings < 1 || num_strings > MAX_STRINGS) return false;
+
+    // The arrays must be in the file before they are allocated
+    const std::streamoff header = in.tellg();
+    in.seekg(0, std::ios::end);
+    const std::streamoff size = in.tellg();
+    in.seekg(header);
+    const auto bytes = static_cast<std::streamoff>(count) *
+                       static_cast<std::streamoff>(sizeof(std::uint64_t) + sizeof(std::uint32_t));
+    if (!in || header < 0 || size - header != bytes) return false;
+
+    std::vector<std::uint64_t> keys;
+    std::vector<std::uint32_t> counts;
+    if (!readVector(in, keys, count) || !readVector(in, counts, count)) return false;
+    if (!validKeys(keys, static_cast<int>(num_strings))) return false;
+
+    keys_ = std::move(keys);
+    counts_ = std::move(counts);
+    num_strings_ = static_cast<int>(num_strings);
+    sequences_ = static_cast<long long>(sequences);
+    transitions_ = static_cast<long long>(transitions);
+    buildBackoff();
+    return true;
+}
+
+// ============================================================================
+// Training
+// ============================================================================
+
+TrainingReport trainTransitions(const std::vector<std::string>& paths, const TrainingSpec& spec) {
+    const auto start = std::chrono::steady_clock::now();
+    const unsigned num_threads = resolveThreads(spec.num_threads, paths.size());
+    std::vector<TrainingReport> partial(num_threads);
+    std::atomic<std::size_t> next_file{0};
+
+    auto worker = [&](unsigned t) {
+        TrainingReport& report = partial[t];
+        TabFileResult parsed;
+        for (std::size_t f = next_file.fetch_add(1, std::memory_order_relaxed); f < paths.size();
+             f = next_file.fetch_add(1, std::memory_order_relaxed)) {
+            ++report.files;
+            const auto file = Music::MappedFile::open(paths[f]);
+            if (!file) {
+                ++report.unreadable_files;
+                continue;
+            }
+            parsed = TabFileResult{};
+            parseTabText(file->view(), parsed);
+            report.bytes += parsed.bytes;
+            for (const auto& tab : parsed.tabs) {
+                ++report.tabs;
+                if (tab.instrument < 0 || tab.num_strings != spec.num_strings) {
+                    ++report.skipped_tabs;
+                    continue;
+                }
+                report.counts.addSequence(std::span<const Note>(parsed.notes.data() + tab.first_note, tab.num_notes));
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    for (auto& thread : threads) thread.join();
+
+    TrainingReport report;
+    for (const auto& part : partial) {
+        report.counts.merge(part.counts);
+        report.files += part.files;
+        report.unreadable_files += part.unreadable_files;
+        report.bytes += part.bytes;
+        report.tabs += part.tabs;
+        report.skipped_tabs += part.skipped_tabs;
+    }
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+} // namespace Guitar
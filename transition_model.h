@@ -0,0 +1,168 @@
+#ifndef TRANSITION_MODEL_H
+#define TRANSITION_MODEL_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "fretboard.h"
+
+namespace Guitar {
+
+// ============================================================================
+// Constants - Transition Model
+// ============================================================================
+
+constexpr const char* DEFAULT_TRANSITION_MODEL = "crazyfingers.model";  // Loaded at startup if present
+
+constexpr int MODEL_MAX_RUN = 3;            // Longer same-string runs share the last context
+constexpr int MODEL_MAX_FRET_DELTA = 12;    // Longer jumps are not counted (never inside a box)
+constexpr int MODEL_CONTEXT_STRING_DELTA = 2;   // Previous move as context: string delta clamped to +-2
+constexpr int MODEL_CONTEXT_FRET_DELTA = 5;     // and fret delta to +-5
+constexpr int MODEL_WEIGHT_SCALE = 1 << 16;     // Probability to selectWeighted weight
+constexpr int MODEL_NUM_MOVES = (2 * MAX_STRINGS - 1) * (2 * MODEL_MAX_FRET_DELTA + 1);  // Every countable move
+
+// ============================================================================
+// Transition Counts - mergeable sparse n-gram tables
+// ============================================================================
+
+// A move is (string delta, fret delta) from one note to the next. Each
+// move is counted under three contexts, from most to least specific:
+//   2: (string, same-string run, previous move)
+//   1: (string, same-string run)
+//   0: none (how often each move happens at all)
+// Keys are packed (level, context, move) integers, so tables built by
+// different threads merge by adding counts.
+class TransitionCounts {
+public:
+    // Every move of one tab (notes in playing order)
+    void addSequence(std::span<const Note> notes);
+    void merge(const TransitionCounts& other);
+
+    [[nodiscard]] std::size_t size() const noexcept { return counts_.size(); }
+    [[nodiscard]] long long getSequences() const noexcept { return sequences_; }
+    [[nodiscard]] long long getTransitions() const noexcept { return transitions_; }
+
+private:
+    friend class TransitionModel;
+
+    std::unordered_map<std::uint64_t, std::uint32_t> counts_;
+    long long sequences_ = 0;
+    long long transitions_ = 0;
+};
+
+// ============================================================================
+// Transition Model - smoothed move probabilities for the generator
+// ============================================================================
+
+// One generator step's context, filled once per note: the (string, run)
+// backoff row plus the counts seen after the full context, stamped with
+// the step so they never need clearing
+struct TransitionContext {
+    const double* lower = nullptr;
+    double mix = 0.0;             // Weight of the backoff row
+    double scale = 0.0;           // Of a count of the full context
+    std::uint32_t step = 0;
+    std::array<std::uint32_t, MODEL_NUM_MOVES> seen{};   // == step: counts[move] is current
+    std::array<double, MODEL_NUM_MOVES> counts{};
+};
+
+// Counts frozen into sorted (key, count) arrays. Probabilities are
+// interpolated Witten-Bell: each level mixes its own counts with the
+// level below in proportion to how many different moves it has seen,
+// down to add-one counts over every move of the instrument, so an unseen
+// move is unlikely but never impossible. The generator still filters
+// every candidate by scale, Position Box, pitch bands and string runs;
+// the model only replaces the distance weights, and a jump beyond the
+// profile's far reach keeps its weight of 0 (the model never widens it).
+//
+// The two lower levels are mixed once, when the model is built or loaded,
+// into a dense row per (string, run); each step only scatters the few
+// moves seen after its full context, so a candidate costs two array reads.
+class TransitionModel {
+public:
+    // Model used by makeNoteGenerator (load it before generating)
+    static TransitionModel& getInstance();
+
+    TransitionModel() = default;
+    TransitionModel(const TransitionCounts& counts, int num_strings);
+
+    void clear() noexcept;
+
+    [[nodiscard]] bool empty() const noexcept { return keys_.empty(); }
+    [[nodiscard]] std::size_t size() const noexcept { return keys_.size(); }
+    [[nodiscard]] int getNumStrings() const noexcept { return num_strings_; }
+    [[nodiscard]] long long getSequences() const noexcept { return sequences_; }
+    [[nodiscard]] long long getTransitions() const noexcept { return transitions_; }
+
+    // Trained on an instrument with this many strings (contexts are per string)
+    [[nodiscard]] bool appliesTo(int num_strings) const noexcept {
+        return !empty() && num_strings == num_strings_;
+    }
+
+    // Weights after `previous` (the note before it in `before`, if any)
+    // with `same_string_run` consecutive same-string moves behind it
+    void findContext(const Note& previous, const Note* before, int same_string_run,
+                     TransitionContext& context) const;
+
+    // Smoothed probability of a move, scaled by MODEL_WEIGHT_SCALE (at least 1;
+    // the generator skips moves beyond the far reach before asking)
+    [[nodiscard]] static int weight(const TransitionContext& context, int string_delta, int fret_delta) noexcept;
+
+    // Binary file: magic, version, shape, then the key and count arrays
+    // as stored in memory (two reads, no parsing). False on unreadable
+    // files, another format, a size that does not match the count or keys
+    // outside the instrument's contexts and moves (the model is left unchanged).
+    [[nodiscard]] bool save(const std::string& path) const;
+    [[nodiscard]] bool load(const std::string& path);
+
+private:
+    struct Range {
+        std::uint32_t begin = 0;
+        std::uint32_t end = 0;
+        double total = 0.0;       // Moves counted under the context
+        double distinct = 0.0;    // Different moves seen after it
+    };
+
+    // Entries of one (level, context), without its distinct/total pair
+    [[nodiscard]] Range findRange(std::uint64_t key) const;
+    void buildBackoff();
+
+    std::vector<std::uint64_t> keys_;     // Sorted (level, context, move)
+    std::vector<std::uint32_t> counts_;
+    std::vector<double> backoff_;         // Levels 0-1 mixed, one row of every move per (string, run)
+    std::vector<std::uint32_t> full_begin_;   // First entry of each level-2 context, then the end
+    int num_strings_ = 0;
+    long long sequences_ = 0;
+    long long transitions_ = 0;
+};
+
+// ============================================================================
+// Training - counts from a corpus of ASCII tabs
+// ============================================================================
+
+struct TrainingSpec {
+    int num_strings = 6;        // Tabs of other instruments are skipped
+    unsigned num_threads = 0;   // 0 = every core
+};
+
+struct TrainingReport {
+    TransitionCounts counts;
+    std::size_t files = 0;
+    std::size_t unreadable_files = 0;
+    std::size_t bytes = 0;
+    long long tabs = 0;
+    long long skipped_tabs = 0;   // Other string count or unknown instrument
+    double seconds = 0.0;
+};
+
+// Files are mapped and parsed (see parseTabText) by workers that take the
+// next file from an atomic counter into counts of their own, merged after
+// the join; the result does not depend on the thread count.
+[[nodiscard]] TrainingReport trainTransitions(const std::vector<std::string>& paths, const TrainingSpec& spec);
+
+} // namespace Guitar
+
+#endif // TRANSITION_MODEL_H
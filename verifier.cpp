@@ -0,0 +1,236 @@
+#include "verifier.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include "scale_dictionary.h"
+#include "thread_count.h"
+
+namespace Guitar {
+
+namespace {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+struct Combo {
+    Music::KeyIndex key;
+    std::string scale;
+    std::uint16_t scale_mask;
+    std::unique_ptr<Music::ScaleManager> scale_mgr;    // Referenced by the validator
+    std::unique_ptr<FretboardValidator> validator;
+};
+
+// Smallest violating exercise per invariant seen by one worker
+struct WorkerFindings {
+    std::array<long long, NUM_INVARIANTS> count{};
+    std::array<long long, NUM_INVARIANTS> first{};
+    std::array<int, NUM_INVARIANTS> note{};
+    long long violating = 0;
+};
+
+std::vector<Note> generateExercise(const Combo& combo, const GeneratorProfile& profile, std::uint32_t seed) {
+    std::vector<Note> notes;
+    for (const auto& note : makeNoteGenerator(*combo.validator, profile, seed)->generateTablature()) {
+        notes.push_back(*note);
+    }
+    return notes;
+}
+
+} // namespace
+
+// ============================================================================
+// Names and Scale Masks
+// ============================================================================
+
+const char* getInvariantName(Invariant invariant) noexcept {
+    switch (invariant) {
+        case Invariant::InScale:       return "in_scale";
+        case Invariant::PositionBox:   return "position_box";
+        case Invariant::LocalRange:    return "local_range";
+        case Invariant::GlobalRange:   return "global_range";
+        case Invariant::SameStringRun: return "same_string_run";
+        case Invariant::RepeatedNote:  return "repeated_note";
+    }
+    return "unknown";
+}
+
+std::uint16_t buildScaleMask(Music::KeyIndex key, const std::string& scale) {
+    // Intervals are steps from the root (Major: 2 2 1 2 2 2 1)
+    int pitch_class = key % Music::SEMITONES_IN_OCTAVE;
+    auto mask = static_cast<std::uint16_t>(1u << pitch_class);
+    for (const int step : Music::ScaleDictionary::getInstance().getIntervals(scale)) {
+        pitch_class = ((pitch_class + step) % Music::SEMITONES_IN_OCTAVE + Music::SEMITONES_IN_OCTAVE) %
+                      Music::SEMITONES_IN_OCTAVE;
+        mask |= static_cast<std::uint16_t>(1u << pitch_class);
+    }
+    return mask;
+}
+
+// ============================================================================
+// InvariantChecker Implementation
+// ============================================================================
+
+InvariantChecker::InvariantChecker(const InstrumentConfig& instrument, const GeneratorProfile& profile)
+    : instrument_{instrument}
+    , profile_{profile} {}
+
+std::uint32_t InvariantChecker::check(std::span<const Note> notes, std::uint16_t scale_mask,
+                                      std::array<int, NUM_INVARIANTS>& first_note) const {
+    std::uint32_t violated = 0;
+    auto fail = [&](Invariant invariant, int index) {
+        const auto bit = static_cast<unsigned>(invariant);
+        if (violated & (1u << bit)) return;
+        violated |= 1u << bit;
+        first_note[bit] = index;
+    };
+    if (notes.empty()) return violated;
+
+    // Off the neck there is no pitch to check: report it as a box violation
+    for (std::size_t i = 0; i < notes.size(); ++i) {
+        if (!instrument_.containsPosition(notes[i].string_idx.value, notes[i].fret.value)) {
+            fail(Invariant::PositionBox, static_cast<int>(i));
+            return violated;
+        }
+    }
+
+    const int anchor = notes[0].fret.value;
+    const int box_lo = std::max(MIN_FRET, anchor - profile_.position_box_radius);
+    const int box_hi = std::min(instrument_.getMaxFret(), anchor + profile_.position_box_radius);
+    const auto window = static_cast<std::size_t>(profile_.local_window_size);
+
+    int global_lo = instrument_.getPitch(notes[0].string_idx.value, notes[0].fret.value);
+    int global_hi = global_lo;
+    int run = 0;  // Consecutive same-string moves ending at note i
+
+    for (std::size_t i = 0; i < notes.size(); ++i) {
+        const int index = static_cast<int>(i);
+        const int string_idx = notes[i].string_idx.value;
+        const int fret = notes[i].fret.value;
+        const int pitch = instrument_.getPitch(string_idx, fret);
+
+        if (((scale_mask >> (pitch % Music::SEMITONES_IN_OCTAVE)) & 1u) == 0) fail(Invariant::InScale, index);
+        if (fret < box_lo || fret > box_hi) fail(Invariant::PositionBox, index);
+
+        global_lo = std::min(global_lo, pitch);
+        global_hi = std::max(global_hi, pitch);
+        if (global_hi - global_lo > profile_.max_global_range) fail(Invariant::GlobalRange, index);
+
+        if (i == 0) continue;
+
+        int local_lo = pitch;
+        int local_hi = pitch;
+        for (std::size_t j = i > window ? i - window : 0; j < i; ++j) {
+            const int other = instrument_.getPitch(notes[j].string_idx.value, notes[j].fret.value);
+            local_lo = std::min(local_lo, other);
+            local_hi = std::max(local_hi, other);
+        }
+        if (local_hi - local_lo > profile_.max_local_range) fail(Invariant::LocalRange, index);
+
+        const Note& previous = notes[i - 1];
+        run = string_idx == previous.string_idx.value ? run + 1 : 0;
+        if (run > profile_.max_consecutive_same_string) fail(Invariant::SameStringRun, index);
+        if (string_idx == previous.string_idx.value && fret == previous.fret.value) {
+            fail(Invariant::RepeatedNote, index);
+        }
+    }
+    return violated;
+}
+
+// ============================================================================
+// Verification Run
+// ============================================================================
+
+VerifyReport runVerification(const VerifySpec& spec) {
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<Combo> combos;
+    for (const auto key : spec.keys) {
+        for (const auto& scale : spec.scales) {
+            Combo combo{key, scale, buildScaleMask(key, scale), std::make_unique<Music::ScaleManager>(), nullptr};
+            combo.scale_mgr->setKeyAndScale(key, scale);
+            combo.validator = std::make_unique<FretboardValidator>(*combo.scale_mgr, spec.instrument);
+            combos.push_back(std::move(combo));
+        }
+    }
+
+    VerifyReport report;
+    if (combos.empty() || spec.exercises <= 0) return report;
+    report.exercises = spec.exercises;
+
+    const long long num_chunks = (spec.exercises + VERIFY_CHUNK - 1) / VERIFY_CHUNK;
+    const unsigned num_threads = resolveThreads(spec.num_threads, static_cast<std::size_t>(num_chunks));
+    std::vector<WorkerFindings> findings(num_threads);
+    std::atomic<long long> next_chunk{0};
+
+    auto worker = [&](unsigned t) {
+        const InvariantChecker checker(spec.instrument, spec.profile);
+        WorkerFindings& found = findings[t];
+        found.first.fill(-1);
+        std::array<int, NUM_INVARIANTS> first_note{};
+
+        for (long long chunk = next_chunk.fetch_add(1, std::memory_order_relaxed); chunk < num_chunks;
+             chunk = next_chunk.fetch_add(1, std::memory_order_relaxed)) {
+            const long long end = std::min(spec.exercises, (chunk + 1) * VERIFY_CHUNK);
+            for (long long e = chunk * VERIFY_CHUNK; e < end; ++e) {
+                const Combo& combo = combos[static_cast<std::size_t>(e % static_cast<long long>(combos.size()))];
+                const auto seed = spec.seed + static_cast<std::uint32_t>(e);
+                const auto generated = makeNoteGenerator(*combo.validator, spec.profile, seed)->generateTablature();
+
+                std::array<Note, NUM_NOTES> notes{};
+                const std::size_t count = std::min<std::size_t>(generated.size(), notes.size());
+                for (std::size_t i = 0; i < count; ++i) notes[i] = *generated[i];
+
+                const std::uint32_t violated = checker.check(std::span<const Note>(notes.data(), count),
+                                                             combo.scale_mask, first_note);
+                if (violated == 0) continue;
+                ++found.violating;
+                for (int v = 0; v < NUM_INVARIANTS; ++v) {
+                    if ((violated & (1u << v)) == 0) continue;
+                    ++found.count[v];
+                    // Chunks are claimed in increasing order, but not per worker
+                    if (found.first[v] < 0 || e < found.first[v]) {
+                        found.first[v] = e;
+                        found.note[v] = first_note[v];
+                    }
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    for (auto& thread : threads) thread.join();
+
+    for (const auto& found : findings) {
+        report.violating_exercises += found.violating;
+        for (int v = 0; v < NUM_INVARIANTS; ++v) {
+            ViolationReport& violation = report.violations[v];
+            violation.count += found.count[v];
+            if (found.first[v] >= 0 && (violation.first_exercise < 0 || found.first[v] < violation.first_exercise)) {
+                violation.first_exercise = found.first[v];
+                violation.note_index = found.note[v];
+            }
+        }
+    }
+
+    // Regenerate each reproduction (same validator, profile and seed)
+    for (auto& violation : report.violations) {
+        if (violation.first_exercise < 0) continue;
+        const Combo& combo = combos[static_cast<std::size_t>(violation.first_exercise %
+                                                             static_cast<long long>(combos.size()))];
+        violation.key = combo.key;
+        violation.scale = combo.scale;
+        violation.seed = spec.seed + static_cast<std::uint32_t>(violation.first_exercise);
+        violation.notes = generateExercise(combo, spec.profile, violation.seed);
+    }
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+} // namespace Guitar
@@ -0,0 +1,107 @@
+#ifndef VERIFIER_H
+#define VERIFIER_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "fretboard.h"
+#include "generator.h"
+#include "music_theory.h"
+
+namespace Guitar {
+
+// ============================================================================
+// Constants - Invariant Verification
+// ============================================================================
+
+constexpr long long DEFAULT_VERIFY_COUNT = 1000000;
+constexpr long long VERIFY_CHUNK = 4096;       // Exercises claimed by a worker at a time
+
+// Rules every generated exercise must satisfy (the documented ones)
+enum class Invariant : std::uint8_t {
+    InScale,         // Every pitch class in the scale
+    PositionBox,     // Every fret within radius of the first note's fret (and on the neck)
+    LocalRange,      // Each note plus the local_window notes before it within max_local_range
+    GlobalRange,     // Whole exercise within max_global_range
+    SameStringRun,   // At most max_same_string consecutive moves on one string
+    RepeatedNote     // Never the same string and fret twice in a row
+};
+
+constexpr int NUM_INVARIANTS = 6;
+
+// "in_scale", "position_box", "local_range", "global_range",
+// "same_string_run", "repeated_note"
+[[nodiscard]] const char* getInvariantName(Invariant invariant) noexcept;
+
+// 12-bit pitch-class mask from the key and the dictionary's interval steps (not
+// through ScaleManager / FretboardValidator, which the generator uses)
+[[nodiscard]] std::uint16_t buildScaleMask(Music::KeyIndex key, const std::string& scale);
+
+// ============================================================================
+// Invariant Checker - written apart from the generator on purpose
+// ============================================================================
+
+// Plain loops over the notes, sharing nothing with the candidate masks,
+// pitch bands or fallbacks of the generator, so a bug there cannot hide
+// itself here.
+class InvariantChecker {
+public:
+    InvariantChecker(const InstrumentConfig& instrument, const GeneratorProfile& profile);
+
+    // One bit per violated Invariant (bit = enum value); first_note[i] is
+    // the first offending note of each violated invariant
+    [[nodiscard]] std::uint32_t check(std::span<const Note> notes, std::uint16_t scale_mask,
+                                      std::array<int, NUM_INVARIANTS>& first_note) const;
+
+private:
+    const InstrumentConfig& instrument_;
+    GeneratorProfile profile_;
+};
+
+// ============================================================================
+// Verification Run
+// ============================================================================
+
+struct VerifySpec {
+    InstrumentConfig instrument = getInstrumentConfig(InstrumentType::Guitar);
+    GeneratorProfile profile = STANDARD_PROFILE;
+    std::vector<Music::KeyIndex> keys;
+    std::vector<std::string> scales;
+    long long exercises = DEFAULT_VERIFY_COUNT;   // In total, spread over the key/scale combos
+    std::uint32_t seed = 1;
+    unsigned num_threads = 0;                     // 0 = every core
+};
+
+struct ViolationReport {
+    long long count = 0;              // Exercises breaking the invariant
+    long long first_exercise = -1;    // Smallest exercise index that does, -1 if none
+    Music::KeyIndex key = 0;          // Its key, scale and generator seed
+    std::string scale;
+    std::uint32_t seed = 0;
+    int note_index = 0;               // First offending note
+    std::vector<Note> notes;          // The exercise, regenerated from the seed
+};
+
+struct VerifyReport {
+    std::array<ViolationReport, NUM_INVARIANTS> violations;
+    long long exercises = 0;
+    long long violating_exercises = 0;
+    double seconds = 0.0;
+
+    [[nodiscard]] bool isClean() const noexcept { return violating_exercises == 0; }
+};
+
+// Exercise e is the first tablature of a fresh generator seeded
+// spec.seed + e on combo e % combos (keys x scales), i.e. exactly what
+// "generate --key K --scale S --seed <seed>" prints. Workers claim
+// VERIFY_CHUNK exercises at a time from an atomic counter over validators
+// built once per combo; each keeps the smallest violating exercise per
+// invariant, so the reported reproductions do not depend on the thread
+// count or scheduling.
+[[nodiscard]] VerifyReport runVerification(const VerifySpec& spec);
+
+} // namespace Guitar
+
+#endif // VERIFIER_H
@@ -0,0 +1,203 @@
+#include "voicing.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace Guitar {
+
+namespace {
+
+// ============================================================================
+// Voicing Shapes - scale steps above the lowest voice
+// ============================================================================
+
+struct VoicingShape {
+    int size;
+    std::array<int, MAX_VOICING_NOTES> steps;
+};
+
+constexpr VoicingShape getShape(VoicingType type) noexcept {
+    switch (type) {
+        case VoicingType::Thirds: return {2, {0, 2, 0}};
+        case VoicingType::Sixths: return {2, {0, 5, 0}};
+        default:                  return {3, {0, 2, 4}};
+    }
+}
+
+// Pitch `steps` scale notes above `pitch` (any mask, octave wrap included)
+int stepUp(int pitch, int steps, std::uint16_t scale_mask) noexcept {
+    for (int s = 0; s < steps; ++s) {
+        do {
+            ++pitch;
+        } while (((scale_mask >> (pitch % Music::SEMITONES_IN_OCTAVE)) & 1u) == 0);
+    }
+    return pitch;
+}
+
+} // namespace
+
+std::optional<VoicingType> parseVoicingType(const std::string& name) {
+    if (name == "thirds") return VoicingType::Thirds;
+    if (name == "sixths") return VoicingType::Sixths;
+    if (name == "triads") return VoicingType::Triads;
+    return std::nullopt;
+}
+
+const char* getVoicingTypeName(VoicingType type) noexcept {
+    switch (type) {
+        case VoicingType::Thirds: return "thirds";
+        case VoicingType::Sixths: return "sixths";
+        default:                  return "triads";
+    }
+}
+
+// ============================================================================
+// VoicingTable Implementation
+// ============================================================================
+
+VoicingTable::VoicingTable(const FretboardValidator& validator, VoicingType type)
+    : type_{type}
+    , voicings_{} {
+    const InstrumentConfig& instrument = validator.getInstrument();
+    const std::uint16_t scale_mask = validator.getScaleMask();
+    const VoicingShape shape = getShape(type);
+    if (scale_mask == 0) return;
+
+    // Depth-first over the upper voices; `voicing` holds the voices placed so far
+    Voicing voicing{};
+    voicing.size = static_cast<std::uint8_t>(shape.size);
+    std::array<int, MAX_VOICING_NOTES> pitches{};
+
+    auto place = [&](auto&& self, int voice, int min_fretted, int max_fretted) -> void {
+        if (voice == shape.size) {
+            voicing.min_fret = MAX_SUPPORTED_FRET;
+            voicing.max_fret = 0;
+            for (int v = 0; v < shape.size; ++v) {
+                voicing.min_fret = std::min(voicing.min_fret, voicing.notes[v].fret);
+                voicing.max_fret = std::max(voicing.max_fret, voicing.notes[v].fret);
+            }
+            voicing.top_pitch = static_cast<std::uint8_t>(pitches[shape.size - 1]);
+            voicings_.push_back(voicing);
+            return;
+        }
+
+        const int below = voicing.notes[voice - 1].string_idx;
+        for (int s = below - 1; s >= std::max(0, below - MAX_VOICING_STRING_GAP); --s) {
+            const int fret = pitches[voice] - instrument.getPitch(s, MIN_FRET);
+            if (!instrument.containsPosition(s, fret)) continue;
+
+            int lo = min_fretted;
+            int hi = max_fretted;
+            if (fret > MIN_FRET) {
+                lo = std::min(lo, fret);
+                hi = std::max(hi, fret);
+                if (hi - lo > MAX_VOICING_SPAN) continue;
+            }
+            const Note note{{s, instrument.num_strings}, {fret}};
+            if (!validator.isNoteInScale(note)) continue;
+
+            voicing.notes[voice] = FretPosition{static_cast<std::uint8_t>(s), static_cast<std::uint8_t>(fret)};
+            self(self, voice + 1, lo, hi);
+        }
+    };
+
+    for (int s = instrument.num_strings - 1; s >= 0; --s) {
+        for (int fret = MIN_FRET; fret <= instrument.getMaxFret(); ++fret) {
+            const Note bass{{s, instrument.num_strings}, {fret}};
+            if (!validator.isNoteInScale(bass)) continue;
+
+            pitches[0] = instrument.getPitch(s, fret);
+            for (int v = 1; v < shape.size; ++v) {
+                pitches[v] = stepUp(pitches[0], shape.steps[v], scale_mask);
+            }
+            voicing.notes[0] = FretPosition{static_cast<std::uint8_t>(s), static_cast<std::uint8_t>(fret)};
+            const int fretted = fret > MIN_FRET ? fret : MAX_SUPPORTED_FRET;
+            place(place, 1, fretted, fret > MIN_FRET ? fret : MIN_FRET);
+        }
+    }
+
+    std::stable_sort(voicings_.begin(), voicings_.end(),
+                     [](const Voicing& a, const Voicing& b) { return a.min_fret < b.min_fret; });
+    std::size_t index = 0;
+    for (int fret = 0; fret <= MAX_SUPPORTED_FRET + 1; ++fret) {
+        while (index < voicings_.size() && voicings_[index].min_fret < fret) ++index;
+        first_[fret] = static_cast<std::uint32_t>(index);
+    }
+}
+
+std::pair<std::size_t, std::size_t> VoicingTable::getRange(int lo, int hi) const noexcept {
+    lo = std::clamp(lo, 0, MAX_SUPPORTED_FRET + 1);
+    hi = std::clamp(hi + 1, 0, MAX_SUPPORTED_FRET + 1);
+    return {first_[lo], std::max(first_[lo], first_[hi])};
+}
+
+// ============================================================================
+// VoicingGenerator Implementation
+// ============================================================================
+
+VoicingGenerator::VoicingGenerator(const VoicingTable& table, const InstrumentConfig& instrument,
+                                   const GeneratorProfile& profile, std::uint32_t seed)
+    : table_{table}
+    , max_fret_{instrument.getMaxFret()}
+    , profile_{profile}
+    , rng_{seed}
+    , candidates_{}
+    , weights_{} {
+    candidates_.reserve(table.getVoicings().size());
+    weights_.reserve(table.getVoicings().size());
+}
+
+bool VoicingGenerator::generate(std::vector<Voicing>& out) {
+    const auto& voicings = table_.getVoicings();
+    out.clear();
+    if (voicings.empty()) return false;
+
+    std::size_t current = static_cast<std::size_t>(rng_.generateInt(0, static_cast<int>(voicings.size()) - 1));
+    PositionBox box{};
+    box.initialize(voicings[current].notes[0].fret, max_fret_, profile_.position_box_radius);
+    int global_min = voicings[current].top_pitch;
+    int global_max = voicings[current].top_pitch;
+    out.push_back(voicings[current]);
+
+    const auto [first, last] = table_.getRange(box.min_fret, box.max_fret);
+    for (int n = 1; n < NUM_NOTES; ++n) {
+        const Voicing& previous = voicings[current];
+        candidates_.clear();
+        weights_.clear();
+
+        for (std::size_t i = first; i < last; ++i) {
+            const Voicing& next = voicings[i];
+            if (i == current || next.max_fret > box.max_fret) continue;
+            if (std::abs(next.top_pitch - previous.top_pitch) > profile_.max_local_range) continue;
+            if (std::max<int>(global_max, next.top_pitch) - std::min<int>(global_min, next.top_pitch) >
+                profile_.max_global_range) {
+                continue;
+            }
+
+            const int weight = profile_.weightFor(next.notes[0].fret - previous.notes[0].fret,
+                                                  next.notes[0].string_idx == previous.notes[0].string_idx);
+            if (weight <= 0) continue;
+            candidates_.push_back(static_cast<std::uint32_t>(i));
+            weights_.push_back(weight);
+        }
+
+        // Nowhere to go inside the box: repeat the shape (always playable)
+        if (!candidates_.empty()) {
+            current = candidates_[static_cast<std::size_t>(rng_.selectWeighted(weights_))];
+        }
+        global_min = std::min<int>(global_min, voicings[current].top_pitch);
+        global_max = std::max<int>(global_max, voicings[current].top_pitch);
+        out.push_back(voicings[current]);
+    }
+    return true;
+}
+
+std::vector<Note> voicingNotes(const Voicing& voicing, int num_strings) {
+    std::vector<Note> notes;
+    notes.reserve(voicing.size);
+    for (int v = 0; v < voicing.size; ++v) {
+        notes.push_back(Note{{voicing.notes[v].string_idx, num_strings}, {voicing.notes[v].fret}});
+    }
+    return notes;
+}
+
+} // namespace Guitar
@@ -0,0 +1,101 @@
+#ifndef VOICING_H
+#define VOICING_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "fretboard.h"
+#include "generator.h"
+#include "random_engine.h"
+
+namespace Guitar {
+
+// ============================================================================
+// Constants - Voicings
+// ============================================================================
+
+constexpr int MAX_VOICING_NOTES = 3;
+constexpr int MAX_VOICING_SPAN = 3;         // Frets between the lowest and highest fretted note
+constexpr int MAX_VOICING_STRING_GAP = 2;   // Adjacent strings or one skipped between voices
+
+// Scale-harmonized shapes: every voice is a fixed number of scale steps
+// above the lowest one
+enum class VoicingType {
+    Thirds,   // Degrees 1-3
+    Sixths,   // Degrees 1-6
+    Triads    // Degrees 1-3-5
+};
+
+// "thirds", "sixths", "triads"; std::nullopt otherwise
+[[nodiscard]] std::optional<VoicingType> parseVoicingType(const std::string& name);
+[[nodiscard]] const char* getVoicingTypeName(VoicingType type) noexcept;
+
+// Notes from the lowest voice up, one per string (string indices descend)
+struct Voicing {
+    std::array<FretPosition, MAX_VOICING_NOTES> notes;
+    std::uint8_t size;
+    std::uint8_t min_fret;    // Lowest fret of the shape (open strings included)
+    std::uint8_t max_fret;
+    std::uint8_t top_pitch;   // Highest voice, for the pitch rules
+};
+
+// ============================================================================
+// Voicing Table - every playable shape of one key/scale/type
+// ============================================================================
+
+// For each in-scale position of the lowest voice, the upper voices are the
+// positions of the harmonized pitches on higher strings within the string
+// gap and fret span (every note checked with isNoteInScale). Shapes are
+// kept sorted by min_fret, so the shapes that start inside a Position Box
+// are one contiguous range.
+class VoicingTable {
+public:
+    VoicingTable(const FretboardValidator& validator, VoicingType type);
+
+    [[nodiscard]] VoicingType getType() const noexcept { return type_; }
+    [[nodiscard]] const std::vector<Voicing>& getVoicings() const noexcept { return voicings_; }
+
+    // Index range of the shapes with min_fret in [lo, hi]
+    [[nodiscard]] std::pair<std::size_t, std::size_t> getRange(int lo, int hi) const noexcept;
+
+private:
+    VoicingType type_;
+    std::vector<Voicing> voicings_;
+    std::array<std::uint32_t, MAX_SUPPORTED_FRET + 2> first_{};  // voicings_ offset per min_fret
+};
+
+// ============================================================================
+// Voicing Generator - chains shapes inside the Position Box
+// ============================================================================
+
+// Same rules as the single-note generator, applied to whole shapes: the
+// first shape anchors the box, every next shape must fit in it, move the
+// top voice within the local pitch range and is drawn with weightFor() on
+// the distance between the shapes' lowest frets (same-string bonus when the
+// bass stays on its string). No allocation after construction.
+class VoicingGenerator {
+public:
+    VoicingGenerator(const VoicingTable& table, const InstrumentConfig& instrument,
+                     const GeneratorProfile& profile, std::uint32_t seed);
+
+    // NUM_NOTES shapes; false if the table is empty (no playable shape)
+    bool generate(std::vector<Voicing>& out);
+
+private:
+    const VoicingTable& table_;
+    int max_fret_;
+    GeneratorProfile profile_;
+    RandomEngine rng_;
+    std::vector<std::uint32_t> candidates_;
+    std::vector<int> weights_;
+};
+
+// Shape as the notes of one tab column
+[[nodiscard]] std::vector<Note> voicingNotes(const Voicing& voicing, int num_strings);
+
+} // namespace Guitar
+
+#endif // VOICING_H